@@ -0,0 +1,686 @@
+#include <iostream>
+#include <fstream>
+#include <cfloat>
+#include <cmath>
+#include <cstdlib>
+#include <cstring>
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+//  Pakiet udostęniony przez prowadzącego
+#include "pakiety/CALERF.h"
+//  Pakiet dodatkowy (programu użytkowe)
+#include "pakiety/UTILS.h"
+//  Pakiety dodatkowe (jądra obliczeniowe)
+#include "pakiety/KMB.h"
+#include "pakiety/THOMAS.h"
+#include "pakiety/LU.h"
+//  Pakiet dodatkowy (pomiary wydajności)
+#include "pakiety/BENCH.h"
+#include "pakiety/LICZNIKI.h"
+
+/*
+            Komenda do kompilacji kodu:
+            g++ -O2 benchmark.cpp pakiety/CALERF.cpp pakiety/UTILS.cpp pakiety/KMB.cpp pakiety/THOMAS.cpp pakiety/LU.cpp pakiety/THREADS.cpp pakiety/BENCH.cpp pakiety/PROFIL.cpp pakiety/LICZNIKI.cpp -pthread -o benchmark
+
+            Przykłady wykonania:
+            ./benchmark                                   (wszystkie jądra, domyślne rozmiary)
+            ./benchmark --json wyniki/benchmark.json
+            ./benchmark --filtr Thomas --rozmiary 1000,100000
+            ./benchmark --szybko
+            ./benchmark --liczniki --filtr KMB              (cykle, IPC, chybienia LLC na element)
+            ./benchmark --sprawdz                         (tylko sprawdzenie poprawności jąder)
+
+            Pomiar jąder obliczeniowych programów (krok KMB, algorytm Thomasa,
+            dekompozycja i rozwiązanie LU, erfc, błąd maksymalny) dla serii
+            rozmiarów: czas wywołania (mediana z powtórzeń), ns/element,
+            GFLOP/s i GB/s względem modelu roofline zmierzonego na maszynie.
+            Liczby operacji i bajtów są nominalne (patrz opisy przy jądrach).
+*/
+
+
+static void pomoc(const char* program) {
+    std::cout
+        << "Użycie: " << program << " [opcje]\n"
+        << "  --rozmiary n1,n2,..     rozmiary dla jąder O(N) (domyślnie 1000,10000,100000,1000000)\n"
+        << "  --rozmiary_lu n1,n2,..  rozmiary macierzy pełnych LU (domyślnie 64,128,256,512)\n"
+        << "  --powtorzenia P         liczba próbek (domyślnie 15)\n"
+        << "  --min_czas S            minimalny czas próbki [s] (domyślnie 0.02)\n"
+        << "  --filtr TEKST           tylko jądra, których nazwa zawiera TEKST\n"
+        << "  --json PLIK             zapis wyników w formacie JSON\n"
+        << "  --szybko                mniej rozmiarów i próbek (sprawdzenie działania)\n"
+        << "  --liczniki              dodatkowy przebieg z licznikami sprzętowymi (perf_event_open)\n"
+        << "  --licznik_fp KOD        surowy kod zdarzenia operacji FP (szesnastkowo, zależny od procesora)\n"
+        << "  --sprawdz               sprawdzenie poprawności jąder zamiast pomiarów (kod wyjścia 1 przy błędzie)\n";
+}
+
+
+
+template <typename T>
+static bool sprawdz_kmb_k_krokow(const char* typ) {
+    //-------------------------------------------------------------------
+    //  oblicz_k_poziomow_czasowych_KMB musi dawać wynik bitowo identyczny
+    //  z k wywołaniami oblicz_nastepny_poziom_czasowy_KMB - dla siatek
+    //  krótszych i dłuższych niż kafelek oraz dla k większego od kafelka.
+    //-------------------------------------------------------------------
+    const T lambda = static_cast<T>(0.4L);
+    bool ok = true;
+    for (int N : {3, 4, 100, kmbpack::KMB_TILE + 1, 3 * kmbpack::KMB_TILE + 17, 100003}) {
+        std::vector<T> U0(N);
+        for (int i = 0; i < N; i++) U0[i] = static_cast<T>(std::sin(0.001L * i) + 1.0L);
+        U0[0] = U0[N - 1] = T(0);
+        for (int k : {1, 2, 5, kmbpack::KMB_KROKI_NARAZ, 33}) {
+            for (int tile : {7, kmbpack::KMB_TILE}) {
+                std::vector<T> a = U0, b(N), wynik(N);
+                for (int j = 0; j < k; j++) {
+                    kmbpack::oblicz_nastepny_poziom_czasowy_KMB(a.data(), b.data(), lambda, N);
+                    std::swap(a, b);
+                }
+                kmbpack::oblicz_k_poziomow_czasowych_KMB(U0.data(), wynik.data(), lambda, N, k, tile);
+                if (std::memcmp(a.data(), wynik.data(), N * sizeof(T)) != 0) {
+                    std::cout << "  BŁĄD KMB k kroków [" << typ << "]: N = " << N << ", k = " << k
+                              << ", kafelek = " << tile << std::endl;
+                    ok = false;
+                }
+            }
+        }
+    }
+    std::cout << "  KMB k kroków = k pojedynczych kroków [" << typ << "]: " << (ok ? "OK" : "BŁĄD") << std::endl;
+    return ok;
+}
+
+
+
+static long long odleglosc_ulp(double a, double b) {
+    //  liczba kroków między a i b na osi liczb double (a, b skończone)
+    long long ia, ib;
+    std::memcpy(&ia, &a, sizeof(a));
+    std::memcpy(&ib, &b, sizeof(b));
+    if (ia < 0) ia = -(ia & 0x7fffffffffffffffLL);
+    if (ib < 0) ib = -(ib & 0x7fffffffffffffffLL);
+    return (ia > ib) ? ia - ib : ib - ia;
+}
+
+
+
+static bool sprawdz_erf_batch(bool erfc) {
+    //-------------------------------------------------------------------
+    //  Wersja double erfc_batch / erf_batch względem (double)erfc_LD /
+    //  erf_LD: ograniczenie z CALERF.h (erfc - 8 ulp, a dla wyników
+    //  podnormalnych 5 najmniejszych liczb podnormalnych; erf - 5 ulp).
+    //  Argumenty: gęsta siatka [-30, 30] (wszystkie trzy przedziały
+    //  calerf i oba znaki), granice przedziałów z sąsiadami, wartości
+    //  szczególne. Wynik wywołania w miejscu (in == out) musi być ten sam.
+    //-------------------------------------------------------------------
+    const char* nazwa = erfc ? "erfc_batch" : "erf_batch";
+    std::vector<double> x;
+    for (long i = -600000; i <= 600000; i++) x.push_back(5.0e-5 * i);
+    for (double g : {0.46875, 4.0, 26.2, 26.543, 27.3}) {
+        for (double s : {-1.0, 1.0}) {
+            double v = s * g;
+            for (int j = 0; j < 8; j++) v = std::nextafter(v, -HUGE_VAL);
+            for (int j = 0; j < 16; j++) {
+                x.push_back(v);
+                v = std::nextafter(v, HUGE_VAL);
+            }
+        }
+    }
+    for (double v : {0.0, -0.0, 1.0e-300, -1.0e-300, 4.9e-324, 1.0e300, -1.0e300}) x.push_back(v);
+
+    const int n = (int)x.size();
+    std::vector<double> y(n), y2(x);
+    if (erfc) {
+        calerfpack::erfc_batch(x.data(), y.data(), n);
+        calerfpack::erfc_batch(y2.data(), y2.data(), n);
+    } else {
+        calerfpack::erf_batch(x.data(), y.data(), n);
+        calerfpack::erf_batch(y2.data(), y2.data(), n);
+    }
+
+    bool ok = std::memcmp(y.data(), y2.data(), n * sizeof(double)) == 0;
+    if (!ok) std::cout << "  BŁĄD " << nazwa << ": wynik w miejscu różni się od wyniku w osobnej tablicy" << std::endl;
+    long long max_ulp = 0, max_ulp_podnormalne = 0;
+    int podnormalne = 0;
+    for (int i = 0; i < n; i++) {
+        double ref = erfc ? (double)calerfpack::erfc_LD(x[i]) : (double)calerfpack::erf_LD(x[i]);
+        long long d = odleglosc_ulp(y[i], ref);
+        bool podnormalny = ref != 0.0 && std::fabs(ref) < DBL_MIN;
+        long long limit = podnormalny ? 5 : (erfc ? 8 : 5);
+        if (podnormalny) {
+            podnormalne++;
+            if (d > max_ulp_podnormalne) max_ulp_podnormalne = d;
+        } else if (d > max_ulp) {
+            max_ulp = d;
+        }
+        if (!(d <= limit) || !std::isfinite(y[i])) {
+            if (ok) std::cout << "  BŁĄD " << nazwa << "(" << x[i] << ") = " << y[i] << ", oczekiwano " << ref
+                              << " (" << d << " ulp)" << std::endl;
+            ok = false;
+        }
+    }
+    double nan = std::nan(""), wynik;
+    if (erfc) calerfpack::erfc_batch(&nan, &wynik, 1);
+    else calerfpack::erf_batch(&nan, &wynik, 1);
+    if (wynik == wynik) {
+        std::cout << "  BŁĄD " << nazwa << "(NaN) = " << wynik << std::endl;
+        ok = false;
+    }
+
+    std::cout << "  " << nazwa << " [double] względem " << (erfc ? "erfc_LD" : "erf_LD") << ": max " << max_ulp
+              << " ulp";
+    if (podnormalne > 0) std::cout << ", wyniki podnormalne (" << podnormalne << "): max " << max_ulp_podnormalne << " ulp";
+    std::cout << ", " << n << " argumentów: " << (ok ? "OK" : "BŁĄD") << std::endl;
+    return ok;
+}
+
+
+
+static int sprawdz() {
+    bool ok = true;
+    ok &= sprawdz_kmb_k_krokow<long double>("long_double");
+    ok &= sprawdz_kmb_k_krokow<double>("double");
+    ok &= sprawdz_kmb_k_krokow<float>("float");
+    ok &= sprawdz_erf_batch(true);
+    ok &= sprawdz_erf_batch(false);
+    std::cout << (ok ? "Sprawdzenie: OK" : "Sprawdzenie: BŁĘDY") << std::endl;
+    return ok ? 0 : 1;
+}
+
+
+
+static bool parsuj_liste(const std::string& tekst, std::vector<long>& lista) {
+    lista.clear();
+    size_t p = 0;
+    while (p <= tekst.size()) {
+        size_t q = tekst.find(',', p);
+        if (q == std::string::npos) q = tekst.size();
+        std::string element = tekst.substr(p, q - p);
+        char* koniec = nullptr;
+        long n = std::strtol(element.c_str(), &koniec, 10);
+        if (element.empty() || *koniec != '\0' || n < 3) return false;
+        lista.push_back(n);
+        p = q + 1;
+    }
+    return true;
+}
+
+
+
+int main(int argc, char** argv) {
+
+    benchpack::OpcjePomiaru opcje;
+    std::vector<long> rozmiary = {1000, 10000, 100000, 1000000};
+    std::vector<long> rozmiary_lu = {64, 128, 256, 512};
+    std::string filtr, plik_json;
+    bool liczniki = false;
+    uint64_t licznik_fp = 0;
+
+    for (int i = 1; i < argc; i++) {
+        std::string opcja = argv[i];
+        if (opcja == "--pomoc" || opcja == "-h" || opcja == "--help") {
+            pomoc(argv[0]);
+            return 0;
+        }
+        if (opcja == "--szybko") {
+            rozmiary = {1000, 100000};
+            rozmiary_lu = {64, 192};
+            opcje.powtorzenia = 5;
+            opcje.min_czas_probki = 0.005;
+            continue;
+        }
+        if (opcja == "--liczniki") {
+            liczniki = true;
+            continue;
+        }
+        if (opcja == "--sprawdz") {
+            return sprawdz();
+        }
+        if (i + 1 >= argc) {
+            std::cerr << "Nieznana opcja lub brak wartości: " << opcja << "\n";
+            pomoc(argv[0]);
+            return 1;
+        }
+        std::string wartosc = argv[++i];
+        bool ok = true;
+        if (opcja == "--rozmiary") ok = parsuj_liste(wartosc, rozmiary);
+        else if (opcja == "--rozmiary_lu") ok = parsuj_liste(wartosc, rozmiary_lu);
+        else if (opcja == "--powtorzenia") ok = (opcje.powtorzenia = std::atoi(wartosc.c_str())) > 0;
+        else if (opcja == "--min_czas") ok = (opcje.min_czas_probki = std::atof(wartosc.c_str())) > 0;
+        else if (opcja == "--filtr") filtr = wartosc;
+        else if (opcja == "--json") plik_json = wartosc;
+        else if (opcja == "--licznik_fp") ok = (licznik_fp = std::strtoull(wartosc.c_str(), nullptr, 16)) != 0;
+        else {
+            std::cerr << "Nieznana opcja: " << opcja << "\n";
+            pomoc(argv[0]);
+            return 1;
+        }
+        if (!ok) {
+            std::cerr << "Błędna wartość opcji " << opcja << ": " << wartosc << "\n";
+            return 1;
+        }
+    }
+
+    auto wybrane = [&](const std::string& jadro) {
+        return filtr.empty() || jadro.find(filtr) != std::string::npos;
+    };
+
+    std::cout << "Pomiar parametrów maszyny..." << std::endl;
+    benchpack::Maszyna maszyna = benchpack::zmierz_maszyne(opcje);
+
+    //  liczniki otwierane raz, przed pomiarami (obejmują też wątki tworzone później)
+    std::unique_ptr<licznikipack::LicznikiSprzetowe> sprzet;
+    if (liczniki) {
+        sprzet.reset(new licznikipack::LicznikiSprzetowe(licznik_fp));
+        if (!sprzet->komunikat().empty()) {
+            std::cout << "Niedostępne liczniki: " << sprzet->komunikat() << std::endl;
+        }
+    }
+
+    std::vector<benchpack::WynikPomiaru> wyniki;
+    auto dodaj = [&](const std::string& jadro, const std::string& wariant, long N, double elementy,
+                     double flop, double bajty, const std::function<void()>& f) {
+        benchpack::WynikPomiaru w;
+        //  float: jądra wektorowe jak double (szczyt float byłby dwa razy wyższy,
+        //  ale jądra float są ograniczone przepustowością pamięci)
+        w.w_double = (wariant.rfind("double", 0) == 0 || wariant.rfind("mieszana_", 0) == 0
+                      || wariant.rfind("float", 0) == 0);
+        w.jadro = jadro;
+        w.wariant = wariant;
+        w.N = N;
+        w.elementy = elementy;
+        w.flop = flop;
+        w.bajty = bajty;
+        w.czas = benchpack::zmierz(f, opcje);
+        if (sprzet) {
+            //  osobny przebieg (jedna próbka), żeby odczyt liczników nie zaburzał czasów
+            const long n = w.czas.wywolan_na_probke;
+            licznikipack::Wyniki l = sprzet->zmierz([&]() {
+                for (long k = 0; k < n; k++) f();
+            });
+            for (const auto& para : licznikipack::jako_pary(l, elementy * n)) {
+                if (para.first.find("_na_element") != std::string::npos || para.first == "IPC"
+                    || para.first == "GBs_pamieci") w.liczniki.push_back(para);
+            }
+        }
+        wyniki.push_back(w);
+        std::cout << "  " << jadro << " [" << wariant << "] N = " << N << ": "
+                  << w.ns_na_element() << " ns/element" << std::endl;
+    };
+
+    const double LD = sizeof(long double);
+    const long double lambda = 0.4L;
+
+    for (long N : rozmiary) {
+        //  dane o kształcie warunku początkowego na siatce [-a, a]
+        std::vector<long double> X(N), U(N), V(N), W(N);
+        const long double h = (2.0L * a) / (N - 1);
+        for (long i = 0; i < N; i++) X[i] = -a + static_cast<long double>(i) * h;
+        utilspack::warunek_poczatkowy(U.data(), X.data(), (int)N);
+
+        //  KMB: 5 flop na węzeł (3 dodawania, 2 mnożenia); odczyt U_old i zapis U_new
+        if (wybrane("KMB")) {
+            dodaj("KMB_krok", "long_double", N, (double)N, 5.0 * N, 2.0 * LD * N, [&]() {
+                kmbpack::oblicz_nastepny_poziom_czasowy_KMB(U.data(), V.data(), lambda, (int)N);
+                benchpack::nie_usuwaj(V.data());
+            });
+            std::vector<double> Ud(U.begin(), U.end()), Vd(N);
+            dodaj("KMB_krok", "double", N, (double)N, 5.0 * N, 2.0 * sizeof(double) * N, [&]() {
+                kmbpack::oblicz_nastepny_poziom_czasowy_KMB(Ud.data(), Vd.data(), 0.4, (int)N);
+                benchpack::nie_usuwaj(Vd.data());
+            });
+            std::vector<float> Uf(U.begin(), U.end()), Vf(N);
+            dodaj("KMB_krok", "float", N, (double)N, 5.0 * N, 2.0 * sizeof(float) * N, [&]() {
+                kmbpack::oblicz_nastepny_poziom_czasowy_KMB(Uf.data(), Vf.data(), 0.4f, (int)N);
+                benchpack::nie_usuwaj(Vf.data());
+            });
+
+            //  silnik równoległy (kmbpack::ParallelKMB, wszystkie wątki sprzętowe)
+            //  na tych samych tablicach - porównanie z wariantem double
+            kmbpack::ParallelKMB<double> silnik((int)N, threadpack::hardware_threads());
+            dodaj("KMB_krok", "double_watki", N, (double)N, 5.0 * N, 2.0 * sizeof(double) * N, [&]() {
+                silnik.step(Ud.data(), Vd.data(), 0.4);
+                benchpack::nie_usuwaj(Vd.data());
+            });
+
+            //  double-double: ok. 80 działań double na węzeł (dodawanie 20, mnożenie 10)
+            std::vector<ddpack::dd> Udd(N), Vdd(N);
+            for (long i = 0; i < N; i++) Udd[i] = ddpack::dd(U[i]);
+            dodaj("KMB_krok", "double_double", N, (double)N, 80.0 * N, 2.0 * sizeof(ddpack::dd) * N, [&]() {
+                kmbpack::oblicz_nastepny_poziom_czasowy_KMB(Udd.data(), Vdd.data(), ddpack::dd(lambda), (int)N);
+                benchpack::nie_usuwaj(Vdd.data());
+            });
+
+            //  K = KMB_KROKI_NARAZ kroków: K pojedynczych kroków (k1) i blokowanie
+            //  czasowe (oblicz_k_poziomow_czasowych_KMB, jak metoda "KMB" bez zapisu
+            //  wyników); element = węzeł x krok, ruch pamięci nominalny - blokowanie
+            //  odczytuje i zapisuje tablicę raz na K kroków
+            const int K = kmbpack::KMB_KROKI_NARAZ;
+            const std::string k_blok = "_k" + std::to_string(K);
+            std::vector<long double> Uk(U), Vk(N);
+            long double* Uk_p = Uk.data();
+            long double* Vk_p = Vk.data();
+            dodaj("KMB_k_krokow", "long_double_k1", N, (double)N * K, 5.0 * N * K, 2.0 * LD * N * K, [&]() {
+                for (int j = 0; j < K; j++) {
+                    kmbpack::oblicz_nastepny_poziom_czasowy_KMB(Uk_p, Vk_p, lambda, (int)N);
+                    std::swap(Uk_p, Vk_p);
+                }
+                benchpack::nie_usuwaj(Uk_p);
+            });
+            dodaj("KMB_k_krokow", "long_double" + k_blok, N, (double)N * K, 5.0 * N * K, 2.0 * LD * N, [&]() {
+                kmbpack::oblicz_k_poziomow_czasowych_KMB(Uk_p, Vk_p, lambda, (int)N, K);
+                std::swap(Uk_p, Vk_p);
+                benchpack::nie_usuwaj(Uk_p);
+            });
+            std::vector<double> Ukd(U.begin(), U.end()), Vkd(N);
+            double* Ukd_p = Ukd.data();
+            double* Vkd_p = Vkd.data();
+            dodaj("KMB_k_krokow", "double_k1", N, (double)N * K, 5.0 * N * K, 2.0 * sizeof(double) * N * K, [&]() {
+                for (int j = 0; j < K; j++) {
+                    kmbpack::oblicz_nastepny_poziom_czasowy_KMB(Ukd_p, Vkd_p, 0.4, (int)N);
+                    std::swap(Ukd_p, Vkd_p);
+                }
+                benchpack::nie_usuwaj(Ukd_p);
+            });
+            dodaj("KMB_k_krokow", "double" + k_blok, N, (double)N * K, 5.0 * N * K, 2.0 * sizeof(double) * N, [&]() {
+                kmbpack::oblicz_k_poziomow_czasowych_KMB(Ukd_p, Vkd_p, 0.4, (int)N, K);
+                std::swap(Ukd_p, Vkd_p);
+                benchpack::nie_usuwaj(Ukd_p);
+            });
+        }
+
+        //  Macierz metody Laasonen: (-lambda, 1 + 2*lambda, -lambda)
+        std::vector<long double> l(N, -lambda), d(N, 1.0L + 2.0L * lambda), u(N, -lambda), dd(N), bb(N);
+        l[0] = 0.0L;
+        u[N - 1] = 0.0L;
+
+        //  Thomas: ok. 8 flop na wiersz (eliminacja z dzieleniem i podstawianie);
+        //  odczyt l, d, u, b, zapis d, b, x (kopie d i b w pomiarze)
+        if (wybrane("Thomas")) {
+            dodaj("Thomas", "long_double", N, (double)N, 8.0 * N, 9.0 * LD * N, [&]() {
+                std::memcpy(dd.data(), d.data(), N * sizeof(long double));
+                std::memcpy(bb.data(), U.data(), N * sizeof(long double));
+                thomaspack::Thomas((int)N, l.data(), dd.data(), u.data(), bb.data(), W.data());
+                benchpack::nie_usuwaj(W.data());
+            });
+
+            //  wersja równoległa (SPIKE, threadpack::global_pool()): bloki z trzema
+            //  prawymi stronami (ok. 14 flop na wiersz) i odtworzenie rozwiązania;
+            //  poniżej THOMAS_PARALLEL_MIN_N (albo z jednym wątkiem) - zwykły Thomas na kopiach d i b
+            const bool spike = N >= thomaspack::THOMAS_PARALLEL_MIN_N && threadpack::global_pool().size() > 1;
+            dodaj("Thomas", "rownolegly", N, (double)N, (spike ? 18.0 : 8.0) * N, (spike ? 12.0 : 9.0) * LD * N, [&]() {
+                thomaspack::Thomas_parallel((int)N, l.data(), d.data(), u.data(), U.data(), W.data());
+                benchpack::nie_usuwaj(W.data());
+            });
+
+            //  gotowa faktoryzacja: 5 flop na wiersz, odczyt m, inv_d, u, b i zapis x
+            thomaspack::ThomasFactor F((int)N, l.data(), d.data(), u.data());
+            dodaj("Thomas_faktoryzacja", "solve", N, (double)N, 5.0 * N, 5.0 * LD * N, [&]() {
+                thomaspack::thomas_factor_solve(F, U.data(), W.data());
+                benchpack::nie_usuwaj(W.data());
+            });
+
+            //  faktoryzacja równoległa (jak krok ML_Thomas od THOMAS_PARALLEL_MIN_N węzłów):
+            //  bloki 5 flop i odtworzenie 4 flop na wiersz; odczyt m, inv_d, u, b,
+            //  zapis x, potem odczyt v, w, x i zapis x (jeden blok - jak solve)
+            thomaspack::ThomasParallelFactorT<long double> Fr((int)N, l.data(), d.data(), u.data());
+            const double fr = (Fr.P > 1) ? 9.0 : 5.0;
+            dodaj("Thomas_faktoryzacja", "rownolegla", N, (double)N, fr * N, fr * LD * N, [&]() {
+                thomaspack::thomas_factor_solve(Fr, U.data(), W.data());
+                benchpack::nie_usuwaj(W.data());
+            });
+
+            //  ta sama faktoryzacja w double (--precyzja double programu heat_transfer)
+            std::vector<double> ld_(l.begin(), l.end()), dd_(d.begin(), d.end()), ud_(u.begin(), u.end());
+            std::vector<double> Ud(U.begin(), U.end()), Wd(N);
+            thomaspack::ThomasFactorT<double> Fd((int)N, ld_.data(), dd_.data(), ud_.data());
+            dodaj("Thomas_faktoryzacja", "double", N, (double)N, 5.0 * N, 5.0 * sizeof(double) * N, [&]() {
+                thomaspack::thomas_factor_solve(Fd, Ud.data(), Wd.data());
+                benchpack::nie_usuwaj(Wd.data());
+            });
+
+            //  double-double: mnożenie i odejmowanie w przód, 2 mnożenia i odejmowanie wstecz (ok. 70 działań double)
+            std::vector<ddpack::dd> ldd(N), ddd(N), udd(N), Udd(N), Wdd(N);
+            for (long i = 0; i < N; i++) {
+                ldd[i] = ddpack::dd(l[i]);
+                ddd[i] = ddpack::dd(d[i]);
+                udd[i] = ddpack::dd(u[i]);
+                Udd[i] = ddpack::dd(U[i]);
+            }
+            thomaspack::ThomasFactorT<ddpack::dd> Fdd((int)N, ldd.data(), ddd.data(), udd.data());
+            dodaj("Thomas_faktoryzacja", "double_double", N, (double)N, 70.0 * N, 5.0 * sizeof(ddpack::dd) * N, [&]() {
+                thomaspack::thomas_factor_solve(Fdd, Udd.data(), Wdd.data());
+                benchpack::nie_usuwaj(Wdd.data());
+            });
+        }
+
+        //  Wsadowy algorytm Thomasa (double): B układów rozmiaru N / B (łącznie
+        //  N wierszy) naraz w porównaniu z B wywołaniami Thomas na osobnych
+        //  tablicach; B = 13 sprawdza obsługę niepełnej grupy. Koszty jak
+        //  w Thomas (8 flop i 9 odczytów/zapisów na wiersz, z kopiami d i b)
+        if (wybrane("Thomas_wsadowy")) {
+            for (int B : {8, 13, 16, 32}) {
+                const int n = (int)(N / B);
+                if (n < 8) continue;
+                const long NB = (long)n * B;
+                const double D = sizeof(double);
+                std::vector<double> lb(NB, -(double)lambda), db(NB, 1.0 + 2.0 * (double)lambda), ub(NB, -(double)lambda);
+                std::vector<double> bb0(NB), dw(NB), bw(NB), xw(NB);
+                for (long k = 0; k < NB; k++) bb0[k] = (double)U[k];
+                for (int s = 0; s < B; s++) {
+                    lb[s] = 0.0;
+                    ub[(long)(n - 1) * B + s] = 0.0;
+                }
+                const std::string b_str = "double_B" + std::to_string(B);
+
+                dodaj("Thomas_wsadowy", b_str, N, (double)NB, 8.0 * NB, 9.0 * D * NB, [&]() {
+                    std::memcpy(dw.data(), db.data(), NB * sizeof(double));
+                    std::memcpy(bw.data(), bb0.data(), NB * sizeof(double));
+                    thomaspack::Thomas_batch(n, B, lb.data(), dw.data(), ub.data(), bw.data(), xw.data());
+                    benchpack::nie_usuwaj(xw.data());
+                });
+
+                //  wspólna macierz (Thomas_batch_shared, np. metoda Laasonen dla B
+                //  warunków początkowych): faktoryzacja raz na wywołanie (N wierszy),
+                //  na element 5 flop; odczyt b, zapis, odczyt i zapis x
+                std::vector<double> lw(lb.begin(), lb.begin() + n), dsw(n, 1.0 + 2.0 * (double)lambda), uw(n);
+                for (int i = 0; i < n; i++) {
+                    lw[i] = lb[(long)i * B];
+                    uw[i] = ub[(long)i * B];
+                }
+                dodaj("Thomas_wsadowy", b_str + "_wspolna", N, (double)NB, 5.0 * NB, 4.0 * D * NB, [&]() {
+                    thomaspack::Thomas_batch_shared(n, B, lw.data(), dsw.data(), uw.data(), bb0.data(), xw.data());
+                    benchpack::nie_usuwaj(xw.data());
+                });
+
+                //  te same układy kolejno (układ s w ciągłym fragmencie [s*n, (s+1)*n))
+                std::vector<double> ls(NB), ds(NB), us(NB), bs0(NB);
+                for (int s = 0; s < B; s++) {
+                    for (int i = 0; i < n; i++) {
+                        const long k = (long)i * B + s, ks = (long)s * n + i;
+                        ls[ks] = lb[k];
+                        ds[ks] = db[k];
+                        us[ks] = ub[k];
+                        bs0[ks] = bb0[k];
+                    }
+                }
+                dodaj("Thomas_wsadowy", b_str + "_petla", N, (double)NB, 8.0 * NB, 9.0 * D * NB, [&]() {
+                    std::memcpy(dw.data(), ds.data(), NB * sizeof(double));
+                    std::memcpy(bw.data(), bs0.data(), NB * sizeof(double));
+                    for (int s = 0; s < B; s++) {
+                        const long o = (long)s * n;
+                        thomaspack::Thomas(n, ls.data() + o, dw.data() + o, us.data() + o, bw.data() + o, xw.data() + o);
+                    }
+                    benchpack::nie_usuwaj(xw.data());
+                });
+            }
+        }
+
+        //  LU macierzy pasmowej (kl = ku = 1, jak w ML_full_LU): rozwiązanie
+        //  ok. 7 flop na wiersz; odczyt czynników L, U (4 przekątne) i b, zapis b
+        if (wybrane("LU_pasmowa")) {
+            lupack::BandMatrix A((int)N, 1, 1);
+            for (long i = 0; i < N; i++) {
+                if (i == 0 || i == N - 1) {
+                    A.at(i, i) = 1.0L;
+                } else {
+                    A.at(i, i - 1) = -lambda;
+                    A.at(i, i) = 1.0L + 2.0L * lambda;
+                    A.at(i, i + 1) = -lambda;
+                }
+            }
+            lupack::LU_factorization F(A);
+            dodaj("LU_pasmowa", "solve", N, (double)N, 7.0 * N, 6.0 * LD * N, [&]() {
+                std::memcpy(bb.data(), U.data(), N * sizeof(long double));
+                lupack::LU_solve(F, bb.data());
+                benchpack::nie_usuwaj(bb.data());
+            });
+
+            lupack::BandMatrixT<double> Ad((int)N, 1, 1);
+            for (long i = 0; i < (long)N * A.ld; i++) Ad.data[i] = (double)A.data[i];
+            lupack::LU_factorizationT<double> Fd(Ad);
+            std::vector<double> Ud(U.begin(), U.end()), bd(N);
+            dodaj("LU_pasmowa", "double", N, (double)N, 7.0 * N, 6.0 * sizeof(double) * N, [&]() {
+                std::memcpy(bd.data(), Ud.data(), N * sizeof(double));
+                lupack::LU_solve(Fd, bd.data());
+                benchpack::nie_usuwaj(bd.data());
+            });
+
+            //  ta sama macierz jako symetryczna (bez elementów A(1,0), A(N-2,N-1)
+            //  przy wierszach brzegowych): LDL^T trójdiagonalna - 5 flop,
+            //  odczyt D, L i b oraz zapis x - oraz pasmowa z k = 1
+            std::vector<long double> d(N, 1.0L + 2.0L * lambda), e(N - 1, -lambda);
+            d[0] = d[N - 1] = 1.0L;
+            e[0] = e[N - 2] = 0.0L;
+            lupack::LDLT_factorization Fs(d.data(), e.data(), (int)N);
+            dodaj("LU_pasmowa", "ldlt", N, (double)N, 5.0 * N, 4.0 * LD * N, [&]() {
+                std::memcpy(bb.data(), U.data(), N * sizeof(long double));
+                lupack::LDLT_solve(Fs, bb.data());
+                benchpack::nie_usuwaj(bb.data());
+            });
+            lupack::SymBandMatrix S((int)N, 1);
+            for (long i = 0; i < N; i++) {
+                S.at(i, i) = d[i];
+                if (i > 0) S.at(i, i - 1) = e[i - 1];
+            }
+            lupack::LDLT_factorization Fsb(S);
+            dodaj("LU_pasmowa", "ldlt_pasmowa", N, (double)N, 5.0 * N, 4.0 * LD * N, [&]() {
+                std::memcpy(bb.data(), U.data(), N * sizeof(long double));
+                lupack::LDLT_solve(Fsb, bb.data());
+                benchpack::nie_usuwaj(bb.data());
+            });
+        }
+
+        //  erfc na argumentach z przedziału [-3, 8] (wszystkie gałęzie CALERF);
+        //  bez liczby flop (funkcje przestępne, koszt zależny od przedziału) -
+        //  poza modelem roofline, tak jak compute_max_error
+        if (wybrane("erfc")) {
+            std::vector<long double> z(N);
+            for (long i = 0; i < N; i++) z[i] = -3.0L + 11.0L * i / (N - 1);
+            dodaj("erfc_LD", "skalarna", N, (double)N, 0.0, 2.0 * LD * N, [&]() {
+                for (long i = 0; i < N; i++) W[i] = calerfpack::erfc_LD(z[i]);
+                benchpack::nie_usuwaj(W.data());
+            });
+            dodaj("erfc_LD", "batch", N, (double)N, 0.0, 2.0 * LD * N, [&]() {
+                calerfpack::erfc_batch(z.data(), W.data(), (int)N);
+                benchpack::nie_usuwaj(W.data());
+            });
+            //  wersja double (wektorowa, bez rozgałęzień) na tych samych argumentach
+            std::vector<double> zd(z.begin(), z.end()), Wd(N);
+            dodaj("erfc_batch", "double", N, (double)N, 0.0, 2.0 * sizeof(double) * N, [&]() {
+                calerfpack::erfc_batch(zd.data(), Wd.data(), (int)N);
+                benchpack::nie_usuwaj(Wd.data());
+            });
+        }
+
+        //  błąd maksymalny względem rozwiązania analitycznego (erfc i exp w węźle)
+        if (wybrane("max_error")) {
+            dodaj("compute_max_error", "wzor", N, (double)N, 0.0, 2.0 * LD * N, [&]() {
+                long double e = utilspack::compute_max_error(U.data(), X.data(), t_max, (int)N);
+                benchpack::nie_usuwaj(&e);
+            });
+            utilspack::RozwiazanieAnalityczne R(X.data(), (int)N);
+            dodaj("compute_max_error", "tablicowany", N, (double)N, 0.0, 3.0 * LD * N, [&]() {
+                long double e = R.compute_max_error(U.data(), t_max);
+                benchpack::nie_usuwaj(&e);
+            });
+        }
+    }
+
+    //  LU macierzy pełnej: dekompozycja 2/3 N^3 flop, rozwiązanie 2 N^2 flop;
+    //  jednokrotny odczyt i zapis macierzy (N^2 elementów)
+    if (wybrane("LU_pelna")) {
+        for (long N : rozmiary_lu) {
+            std::vector<long double> A0(N * N), A(N * N), b(N);
+            std::vector<int> index(N);
+            for (long i = 0; i < N; i++) {
+                for (long j = 0; j < N; j++) {
+                    A0[i * N + j] = (i == j) ? 1.0L + 2.0L * lambda
+                                  : (std::labs(i - j) == 1 ? -lambda : 1.0L / (1 + i + j));
+                }
+            }
+            const double n = (double)N;
+            dodaj("LU_pelna", "decompose", N, n * n * n, 2.0 / 3.0 * n * n * n, 2.0 * LD * n * n, [&]() {
+                std::memcpy(A.data(), A0.data(), N * N * sizeof(long double));
+                lupack::LU_decompose(A.data(), index.data(), (int)N);
+                benchpack::nie_usuwaj(A.data());
+            });
+            dodaj("LU_pelna", "blokowa", N, n * n * n, 2.0 / 3.0 * n * n * n, 2.0 * LD * n * n, [&]() {
+                std::memcpy(A.data(), A0.data(), N * N * sizeof(long double));
+                lupack::LU_decompose_blocked(A.data(), index.data(), (int)N);
+                benchpack::nie_usuwaj(A.data());
+            });
+
+            lupack::LU_decompose(A.data(), index.data(), (int)N);
+            dodaj("LU_pelna", "solve", N, n * n, 2.0 * n * n, LD * n * n, [&]() {
+                for (long i = 0; i < N; i++) b[i] = 1.0L;
+                lupack::LU_solve(A.data(), index.data(), b.data(), (int)N);
+                benchpack::nie_usuwaj(b.data());
+            });
+
+            //  macierz jest symetryczna: LDL^T dolnego trójkąta (N^3/3 flop,
+            //  odczyt i zapis N^2/2 elementów)
+            std::vector<long double> AP0(N * (N + 1) / 2), AP(N * (N + 1) / 2);
+            for (long i = 0; i < N; i++) {
+                for (long j = 0; j <= i; j++) AP0[i * (i + 1) / 2 + j] = A0[i * N + j];
+            }
+            dodaj("LU_pelna", "ldlt", N, n * n * n, 1.0 / 3.0 * n * n * n, LD * n * n, [&]() {
+                std::memcpy(AP.data(), AP0.data(), AP0.size() * sizeof(long double));
+                lupack::LDLT_decompose(AP.data(), (int)N);
+                benchpack::nie_usuwaj(AP.data());
+            });
+
+            //  dekompozycja w double / float z poprawianiem rozwiązania do
+            //  long double (LU_refinementT): kopia i konwersja macierzy,
+            //  dekompozycja oraz jedno rozwiązanie z poprawkami
+            int poprawki_double = 0, poprawki_float = 0;
+            dodaj("LU_pelna", "mieszana_double", N, n * n * n, 2.0 / 3.0 * n * n * n, 2.0 * LD * n * n, [&]() {
+                lupack::LU_refinementT<double> F(A0.data(), (int)N);
+                for (long i = 0; i < N; i++) b[i] = 1.0L;
+                poprawki_double = lupack::LU_solve(F, b.data());
+                benchpack::nie_usuwaj(b.data());
+            });
+            dodaj("LU_pelna", "mieszana_float", N, n * n * n, 2.0 / 3.0 * n * n * n, 2.0 * LD * n * n, [&]() {
+                lupack::LU_refinementT<float> F(A0.data(), (int)N);
+                for (long i = 0; i < N; i++) b[i] = 1.0L;
+                poprawki_float = lupack::LU_solve(F, b.data());
+                benchpack::nie_usuwaj(b.data());
+            });
+            std::cout << "  LU_pelna N = " << N << ": poprawki rozwiązania double " << poprawki_double
+                      << ", float " << poprawki_float << std::endl;
+        }
+    }
+
+    std::cout << "\n";
+    benchpack::wypisz(std::cout, maszyna, wyniki);
+
+    if (!plik_json.empty()) {
+        std::ofstream plik(plik_json);
+        if (!plik) {
+            std::cerr << "Nie można otworzyć pliku " << plik_json << "\n";
+            return 1;
+        }
+        benchpack::zapisz_json(plik, maszyna, wyniki, opcje);
+    }
+    return 0;
+}
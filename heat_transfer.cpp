@@ -0,0 +1,275 @@
+#include <iostream>
+#include <cmath>
+#include <cstdlib>
+#include <filesystem>
+#include <string>
+#include <vector>
+//  Pakiet dodatkowy (programu użytkowe)
+#include "pakiety/UTILS.h"
+//  Pakiet dodatkowy (jądra KMB, silnik równoległy)
+#include "pakiety/KMB.h"
+//  Pakiet dodatkowy (rejestr metod)
+#include "pakiety/METODY.h"
+//  Pakiet dodatkowy (wykonanie symulacji)
+#include "pakiety/SYMULACJA.h"
+//  Pakiet dodatkowy (pomiar czasu faz, -DPROFILOWANIE)
+#include "pakiety/PROFIL.h"
+//  Pakiet dodatkowy (liczniki sprzętowe procesora)
+#include "pakiety/LICZNIKI.h"
+//  Pakiet dodatkowy (zapis wyników)
+#include "pakiety/IO.h"
+//  Pakiet dodatkowy (pula wątków)
+#include "pakiety/THREADS.h"
+
+/*
+            Komenda do kompilacji kodu:
+            g++ -O2 heat_transfer.cpp pakiety/CALERF.cpp pakiety/UTILS.cpp pakiety/KMB.cpp pakiety/THOMAS.cpp pakiety/LU.cpp pakiety/METODY.cpp pakiety/SYMULACJA.cpp pakiety/THREADS.cpp pakiety/IO.cpp pakiety/POLE.cpp pakiety/PROFIL.cpp pakiety/LICZNIKI.cpp -pthread -o heat_transfer
+
+            Przykłady wykonania:
+            ./heat_transfer --metoda KMB --Xs 1500 --Ts 39063
+            ./heat_transfer --metoda ML_Thomas --Xs 2371 --Ts 39039 --zapis csv --pole 1e-10
+            ./heat_transfer --metoda ML_full_LU --zbieznosc 15        (odpowiednik POINT_1)
+            ./heat_transfer --metoda KMB --Xs 1500 --Ts 39063 --zapis brak --liczniki
+            ./heat_transfer --metoda ML_Thomas --zbieznosc 50 --precyzja double
+            ./heat_transfer --metoda KMB --zbieznosc 15 --precyzja double_double
+            ./heat_transfer --metoda ML_LU_mieszana_float --Xs 2371 --Ts 39039 --zapis brak
+            ./heat_transfer --metoda KMB_rownolegly --Xs 200000 --Ts 2000 --zapis brak --watki 4
+            ./heat_transfer --skalowanie --Xs 1000000 --Ts 200 --watki 8 --precyzja double
+            ./heat_transfer --lista
+
+            Jeden program dla wszystkich metod z rejestru metodypack - rozmiary
+            siatki, parametry fizyczne, sposób zapisu wyników i liczba wątków
+            podawane są w wierszu poleceń (bez ponownej kompilacji).
+*/
+
+
+static void pomoc(const char* program) {
+    std::cout
+        << "Użycie: " << program << " [opcje]\n"
+        << "  --metoda NAZWA      metoda z rejestru (--lista), domyślnie KMB\n"
+        << "  --Xs N, --Ts M      rozmiary siatki przestrzennej i czasowej\n"
+        << "  --D, --b, --t_max, --a WARTOSC\n"
+        << "                      parametry fizyczne (domyślnie stałe z UTILS.h)\n"
+        << "  --zapis csv|htb|oba|brak\n"
+        << "                      zapis migawek i błędu e_max(t), domyślnie htb\n"
+        << "  --migawki n1,n2,..  poziomy czasowe migawek (ujemne - od końca)\n"
+        << "  --pole EPS          zapis całego pola z błędem <= EPS (0 - bezstratnie)\n"
+        << "  --katalog DIR       katalog wyników, domyślnie wyniki\n"
+        << "  --precyzja P        float|double|long_double|double_double|float128,\n"
+        << "                      domyślnie long_double\n"
+        << "                      (rozwiązanie analityczne i błędy zawsze w long double)\n"
+        << "  --watki N           liczba wątków (wspólna pula, badanie zbieżności)\n"
+        << "  --zbieznosc K       badanie zbieżności dla k = 1..K (Xs = 24k, Ts = 10k^2),\n"
+        << "                      siatki liczone równolegle od największej;\n"
+        << "                      wynik w <katalog>/<metoda>/<prefiks>_error_step.csv\n"
+        << "  --skalowanie        raport skalowania silnego i słabego silnika KMB\n"
+        << "                      (kmbpack::ParallelKMB: N = Xs, Ts kroków, 1..watki wątków)\n"
+        << "  --liczniki          liczniki sprzętowe (cykle, IPC, chybienia LLC, ruch pamięci)\n"
+        << "                      dla całego przebiegu, także na węzeł-krok\n"
+        << "  --licznik_fp KOD    surowy kod zdarzenia operacji FP (szesnastkowo)\n"
+        << "  --lista             lista dostępnych metod\n";
+}
+
+
+
+static bool parsuj_migawki(const std::string& tekst, std::vector<int>& migawki) {
+    migawki.clear();
+    size_t p = 0;
+    while (p <= tekst.size()) {
+        size_t q = tekst.find(',', p);
+        if (q == std::string::npos) q = tekst.size();
+        std::string element = tekst.substr(p, q - p);
+        if (element.empty()) return false;
+        char* koniec = nullptr;
+        long n = std::strtol(element.c_str(), &koniec, 10);
+        if (*koniec != '\0') return false;
+        migawki.push_back((int)n);
+        p = q + 1;
+    }
+    return true;
+}
+
+
+
+static int badanie_zbieznosci(const metodypack::Metoda& metoda, const symulacjapack::UstawieniaSymulacji& u,
+        int K, int n_watkow) {
+    //-------------------------------------------------------------------
+    //  Błąd w chwili t_max dla kolejnych zagęszczeń siatki (symulacje
+    //  równolegle, od największej); wiersze pliku w kolejności k.
+    //-------------------------------------------------------------------
+    std::vector<symulacjapack::WynikSymulacji> wyniki =
+        symulacjapack::badanie_zbieznosci(metoda.nazwa(), u, K, n_watkow);
+
+    std::string katalog = u.katalog + "/" + metoda.nazwa();
+    std::error_code ec;
+    std::filesystem::create_directories(katalog, ec);
+    std::string nazwa = katalog + "/" + metoda.prefiks() + "_error_step.csv";
+    iopack::ZapisCSV fout(nazwa, iopack::FormatCSV::STALY, 19);
+    if (!fout.otwarty()) return 1;
+    fout.tekst("log10(h),log10(max_error)\n");
+
+    //  Te same logarytmy co programy dla pojedynczych metod: heat_transfer_KMB.cpp
+    //  liczy ::log10 w double, heat_transfer_ML_*.cpp - log10l
+    const bool log_double = metoda.nazwa().rfind("KMB", 0) == 0;
+
+    for (const symulacjapack::WynikSymulacji& w : wyniki) {
+        if (w.blad_koncowy < 0) return 1;
+        std::cout << "węzłów przestrzennych: " << w.Xs << ", węzłów czasowych: " << w.Ts
+                  << ", lambda = " << w.lambda << std::endl;
+        std::cout << "Max error " << metoda.nazwa() << " = " << w.blad_koncowy << std::endl;
+        if (log_double) {
+            fout.wiersz(log10((double)w.h), log10((double)w.blad_koncowy));
+        } else {
+            fout.wiersz(log10l(w.h), log10l(w.blad_koncowy));
+        }
+    }
+    fout.zamknij();
+    return 0;
+}
+
+
+
+int main(int argc, char** argv) {
+
+    symulacjapack::UstawieniaSymulacji u;
+    std::string nazwa_metody = "KMB";
+    int zbieznosc = 0;
+    int watki = 0;
+    bool liczniki = false;
+    bool skalowanie = false;
+    uint64_t licznik_fp = 0;
+
+    for (int i = 1; i < argc; i++) {
+        std::string opcja = argv[i];
+        if (opcja == "--lista") {
+            for (const std::string& m : metodypack::dostepne_metody()) std::cout << m << "\n";
+            return 0;
+        }
+        if (opcja == "--pomoc" || opcja == "-h" || opcja == "--help") {
+            pomoc(argv[0]);
+            return 0;
+        }
+        if (opcja == "--liczniki") {
+            liczniki = true;
+            continue;
+        }
+        if (opcja == "--skalowanie") {
+            skalowanie = true;
+            continue;
+        }
+        if (i + 1 >= argc) {
+            std::cerr << "Nieznana opcja lub brak wartości: " << opcja << "\n";
+            pomoc(argv[0]);
+            return 1;
+        }
+        std::string wartosc = argv[++i];
+        char* koniec = nullptr;
+        bool ok = true;
+
+        if (opcja == "--metoda") {
+            nazwa_metody = wartosc;
+        } else if (opcja == "--Xs" || opcja == "--Ts" || opcja == "--watki" || opcja == "--zbieznosc") {
+            long n = std::strtol(wartosc.c_str(), &koniec, 10);
+            ok = (*koniec == '\0');
+            if (opcja == "--Xs") u.Xs = (int)n;
+            else if (opcja == "--Ts") u.Ts = (int)n;
+            else if (opcja == "--zbieznosc") zbieznosc = (int)n;
+            else {
+                //  pula zmieniana dopiero po sprawdzeniu wartości
+                ok = ok && n >= 1;
+                if (ok) {
+                    watki = (int)n;
+                    if (!threadpack::ustaw_rozmiar_global_pool(watki)) {
+                        std::cerr << "Pula wątków już istnieje - opcja --watki pominięta\n";
+                    }
+                }
+            }
+        } else if (opcja == "--D" || opcja == "--b" || opcja == "--t_max" || opcja == "--a" || opcja == "--pole") {
+            long double x = std::strtold(wartosc.c_str(), &koniec);
+            ok = (*koniec == '\0');
+            if (opcja == "--D") u.fizyka.D = x;
+            else if (opcja == "--b") u.fizyka.b = x;
+            else if (opcja == "--t_max") u.fizyka.t_max = x;
+            else if (opcja == "--a") u.fizyka.a = x;
+            else {
+                u.zapis_pola = true;
+                u.dokladnosc_pola = (double)x;
+            }
+        } else if (opcja == "--zapis") {
+            if (wartosc == "csv") u.zapis = symulacjapack::ZapisWynikow::CSV;
+            else if (wartosc == "htb") u.zapis = symulacjapack::ZapisWynikow::BINARNY;
+            else if (wartosc == "oba") u.zapis = symulacjapack::ZapisWynikow::OBA;
+            else if (wartosc == "brak") u.zapis = symulacjapack::ZapisWynikow::BRAK;
+            else ok = false;
+        } else if (opcja == "--migawki") {
+            ok = parsuj_migawki(wartosc, u.migawki);
+        } else if (opcja == "--katalog") {
+            u.katalog = wartosc;
+        } else if (opcja == "--precyzja") {
+            ok = precyzjapack::parsuj_precyzje(wartosc, u.precyzja);
+        } else if (opcja == "--licznik_fp") {
+            licznik_fp = std::strtoull(wartosc.c_str(), &koniec, 16);
+            ok = (*koniec == '\0' && licznik_fp != 0);
+        } else {
+            std::cerr << "Nieznana opcja: " << opcja << "\n";
+            pomoc(argv[0]);
+            return 1;
+        }
+
+        if (!ok) {
+            std::cerr << "Błędna wartość opcji " << opcja << ": " << wartosc << "\n";
+            return 1;
+        }
+    }
+
+    if (skalowanie) {
+        precyzjapack::dla_precyzji(u.precyzja, [&](auto zero) {
+            kmbpack::raport_skalowania<decltype(zero)>(std::cout, u.Xs, u.Ts, threadpack::rozmiar_global_pool());
+        });
+        return 0;
+    }
+
+    std::unique_ptr<metodypack::Metoda> metoda = metodypack::utworz_metode(nazwa_metody);
+    if (!metoda) {
+        std::cerr << "Nieznana metoda: " << nazwa_metody << " (dostępne:";
+        for (const std::string& m : metodypack::dostepne_metody()) std::cerr << " " << m;
+        std::cerr << ")\n";
+        return 1;
+    }
+    if (!metoda->obsluguje(u.precyzja)) {
+        std::cerr << "Metoda " << metoda->nazwa() << " nie obsługuje precyzji "
+                  << precyzjapack::nazwa_precyzji(u.precyzja) << "\n";
+        return 1;
+    }
+
+    //  liczniki otwierane przed utworzeniem wątków roboczych (dziedziczone przez nie)
+    std::unique_ptr<licznikipack::LicznikiSprzetowe> sprzet;
+    if (liczniki) {
+        sprzet.reset(new licznikipack::LicznikiSprzetowe(licznik_fp));
+        if (!sprzet->komunikat().empty()) {
+            std::cout << "Niedostępne liczniki: " << sprzet->komunikat() << std::endl;
+        }
+        sprzet->start();
+    }
+
+    int wynik = 0;
+    double wezly_kroki = 0;
+    if (zbieznosc > 0) {
+        wynik = badanie_zbieznosci(*metoda, u, zbieznosc, watki);
+        for (int k = 1; k <= zbieznosc; k++) {
+            wezly_kroki += (double)symulacjapack::zbieznosc_Xs(k) * symulacjapack::zbieznosc_Ts(k);
+        }
+    } else {
+        symulacjapack::Symulacja symulacja;
+        symulacjapack::WynikSymulacji w = symulacja.uruchom(*metoda, u);
+        if (w.blad_koncowy < 0) return 1;
+        std::cout << "Max error " << metoda->nazwa() << " (t = t_max) = " << w.blad_koncowy << std::endl;
+        std::cout << "Czas wykonania: " << w.czas << " sekund\n";
+        if (!metoda->podsumowanie().empty()) std::cout << metoda->podsumowanie() << std::endl;
+        wezly_kroki = (double)u.Xs * u.Ts;
+    }
+
+    if (sprzet) licznikipack::wypisz(std::cout, sprzet->stop(), wezly_kroki, "węzeł-krok");
+    PROFIL_RAPORT(std::cout);
+    return wynik;
+}
@@ -10,10 +10,18 @@
 #include "pakiety/CALERF.h" 
 //  Pakiet dodatkowy (programu użytkowe)
 #include "pakiety/UTILS.h"
+//  Pakiet dodatkowy (jądra obliczeniowe metody KMB)
+#include "pakiety/KMB.h"
+//  Pakiet dodatkowy (zapis wyników w tle)
+#include "pakiety/IO.h"
+//  Pakiet dodatkowy (badanie zbieżności)
+#include "pakiety/SYMULACJA.h"
+//  Pakiet dodatkowy (pomiar czasu faz, -DPROFILOWANIE)
+#include "pakiety/PROFIL.h"
 
 /*  
             Komenda do kompilacji kodu: 
-            g++ heat_transfer_KMB.cpp pakiety/CALERF.cpp pakiety/UTILS.cpp -o KMB
+            g++ heat_transfer_KMB.cpp pakiety/CALERF.cpp pakiety/UTILS.cpp pakiety/KMB.cpp pakiety/THOMAS.cpp pakiety/LU.cpp pakiety/METODY.cpp pakiety/SYMULACJA.cpp pakiety/THREADS.cpp pakiety/IO.cpp pakiety/POLE.cpp pakiety/PROFIL.cpp -pthread -o KMB
 
             Komenda wykonująca program:
             ./KMB
@@ -53,88 +61,28 @@
 
 
 
-void oblicz_nastepny_poziom_czasowy_KMB(const long double* U_old, long double* U_new, long double lambda, const int N) {
-    //-------------------------------------------------------------------
-    // Funkcja oblicza przybliżoną wartość funkcji na kolejnym poziomie czasowym
-    // Warunki brzegowe: U_new[0]=U_new[N-1]=0 (przyjmujemy, że już są ustawione)
-    
-    //  Argumenty:
-    //  U_old - Tablica wartości funkcji dla bieżącego poziomu czasu
-    //  U_new - Tablica wartości funkcji dla nowego poziomu czasu
-    //  lambda - parametr lambda: D*dt/h^2
-    //  N - liczba węzłów siatki przestrzennej
-
-    //  Zwraca: Nic -> operacje na wskaźnikach
-    //-------------------------------------------------------------------
-    
-    // warunki brzegowe
-    U_new[0] = 0.0L;
-    U_new[N-1] = 0.0L;
-    
-
-    for (int i = 1; i + 1 < N; ++i) {
-        U_new[i] = U_old[i] + lambda * (U_old[i + 1] - 2.0L * U_old[i] + U_old[i - 1]);
-        //  Jest to przekształcony wzór KMB
-    }
-
-}
-
-
 #ifdef POINT_1
 
 int main() {
-    int Xs, Ts;  // zmienne przechowujące ilość węzłów
-    long double h, dt;  // kroki
-
-    std::ofstream fout("wyniki/KMB/KMBresults_error_step.csv");
-    fout << "log10(h),log10(max_error)\n";
-    fout << std::fixed << std::setprecision(19);
+    //  Siatki Xs = 24k, Ts = 10k^2 liczone równolegle, od największej
+    //  (symulacjapack::badanie_zbieznosci); wyniki w kolejności k
+    symulacjapack::UstawieniaSymulacji u;
+    std::vector<symulacjapack::WynikSymulacji> wyniki = symulacjapack::badanie_zbieznosci("KMB", u, 50);
 
-    for (int k = 1; k <= 50; ++k) {
-        Xs = 24 * k;          // N jako wielokrotność 24
-        Ts = 10 * k * k;       // M z zależności 576M = 10N^2
+    iopack::ZapisCSV fout("wyniki/KMB/KMBresults_error_step.csv", iopack::FormatCSV::STALY, 19);
+    fout.tekst("log10(h),log10(max_error)\n");
 
-        // Używamy std::vector do alokacji pamięci
-        
-        long double* X   = new long double[Xs];  //  tablica przechowująca wartości węzłów siatki przestrzennej
-        long double* U  = new long double[Xs];  //  tablica przechowująca wartości funkcji dla KMB
-        long double* Tmp = new long double[Xs];  //  tablica przechowująca tymczasowe wartości funkcji
-
-        h = (2.0L * a) / (Xs - 1);      // krok przestrzenny
-        dt = t_max / (Ts - 1);          // krok czasowy (krok całkowania)
-
-        // Utworzenie siatki przestrzennej: X[i] = -a + i*h
-        for (int i = 0; i < Xs; ++i) {
-            X[i] = -a + static_cast<long double>(i) * h;
-        }
-
-        // Inicjalizacja warunku początkowego U(x,0)
-        utilspack::warunek_poczatkowy(U, X, Xs);
-
-        // Parametr lambda dla metody
-        long double lambda = D * dt / (h * h);
+    for (const symulacjapack::WynikSymulacji& w : wyniki) {
+        if (w.blad_koncowy < 0) return 1;
 
         // Wypisanie wymiarów siatki i lambdy
-        std::cout << "węzłów przestrzennych: " << Xs << ", węzłów czasowych: " << Ts << ", lambda = " << lambda << std::endl;
-
-        // Pętla czasowa (Ms-1 kroków)
-        for (int n = 0; n < Ts - 1; ++n) {
-            oblicz_nastepny_poziom_czasowy_KMB(U, Tmp, lambda, Xs);
-            std::swap(U, Tmp);
-}
-
-        // Obliczenie błędu przy czasie t_max
-        long double err_kmb = utilspack::compute_max_error(U, X, t_max, Xs);
-        std::cout << "Max error KMB = " << err_kmb << std::endl;
-        fout << log10(h) << "," << log10(err_kmb) << "\n";
-
-        delete[] X;
-        delete[] U;
-        delete[] Tmp;
-
+        std::cout << "węzłów przestrzennych: " << w.Xs << ", węzłów czasowych: " << w.Ts << ", lambda = " << w.lambda << std::endl;
+        std::cout << "Max error KMB = " << w.blad_koncowy << std::endl;
+        fout.wiersz(log10(w.h), log10(w.blad_koncowy));
     }
 
-    fout.close();
+    fout.zamknij();
+    PROFIL_RAPORT(std::cout);
     
     return 0;
 }
@@ -153,6 +101,7 @@ int main() {
     long double* X   = new long double[Xs];  //  tablica przechowująca wartości węzłów siatki przestrzennej
     long double* U  = new long double[Xs];  //  tablica przechowująca wartości funkcji dla KMB
     long double* Tmp = new long double[Xs];  //  tablica przechowująca tymczasowe wartości funkcji
+    long double* U_ref = new long double[Xs];  //  rozwiązanie analityczne na bieżącym poziomie czasowym
     int i = 0; //  zmienna iteracyjna, aby nie definiować ciągle nowej
 
     // Utworzenie siatki przestrzennej jako: X[i] = -a + i*h
@@ -182,53 +131,74 @@ int main() {
     //  Tablica do przechowywania indeksów iteracji, w których zapisywane są wyniki
 
     
-    // otwarcie pliku przed rozpoczęciem petli, aby nie nadpisywać pliku
-    std::ofstream file_errr_time("wyniki/KMB/KMB_maxerror_vs_time.csv");
-    file_errr_time << "t,e_max\n";
+    // Zapis wyników w tle: plik błędów oraz migawki wybranych poziomów czasowych
+    // (wątek obliczeniowy jedynie kopiuje dane do bufora kolejki)
+    iopack::AsyncWriter writer(X, Xs, "wyniki/KMB/KMB_maxerror_vs_time.csv", "t,e_max\n");
+
+    // Wyniki zapisywane są do pliku binarnego; pliki CSV dla skryptów gnuplot
+    // odtwarza program konwerter_htb (lub ZAPIS_CSV = true - zapis bezpośredni)
+    const bool ZAPIS_CSV = false;
+    iopack::OpisHTB opis;
+    opis.metoda = "KMB";
+    opis.kolumna = "U_KMB";
+    opis.prefiks_migawek = "wyniki/KMB/KMBresults";
+    opis.D = D; opis.b = b; opis.a = a; opis.t_max = t_max;
+    opis.h = h; opis.dt = dt; opis.lambda = lambda; opis.Ts = Ts;
+    writer.zapis_binarny("wyniki/KMB/KMB_wyniki.htb", opis, ZAPIS_CSV);
+
+    // Całe pole U(x, t) (wszystkie poziomy czasowe) w skompresowanym pliku kafli;
+    // (domyślnie wyłączone - plik rośnie z liczbą poziomów czasowych);
+    // DOKLADNOSC_POLA - maksymalny błąd bezwzględny zapisu (0 - bezstratnie)
+    const bool ZAPIS_POLA = false;
+    const double DOKLADNOSC_POLA = 1.0e-10;
+    if (ZAPIS_POLA) writer.zapis_pola("wyniki/KMB/KMB_pole.htp", DOKLADNOSC_POLA);
     long double err_kmb;
     // te instrukcje przed pętlą aby uniknąc redundancji danych w kodzie
 
+    // Rozwiązanie analityczne na siatce X (czynniki zależne od t liczone raz na poziom czasowy)
+    utilspack::RozwiazanieAnalityczne analityczne(X, Xs);
+
     // Pętla czasowa
     for (int n = 0; n < Ts; n++) {
+        PROFIL_ZAKRES("petla czasowa: poziom");
+        analityczne.ustaw_czas(T[n]);
+        analityczne.wartosci(U_ref);
+        // Poziom T[n] do pliku całego pola (wątek obliczeniowy jedynie kopiuje U)
+        if (ZAPIS_POLA) writer.zapisz_poziom(T[n], U);
+
         // Metoda KMB
-        std::string template_filename = "wyniki/KMB/KMBresults";
         if(save_indexes.count(n)){
-            // Jeśli podany indeks jest jednym z wybranych do zapisu to zapisz do pliku CSV:
-
-            //-------------------------- ZAPIS DO PLIKU CSV -------------------------------------
-            std::ofstream fout(template_filename + std::to_string(n) + "iter.csv");   // np. KMBresults0.csv
-            
-            fout << "x,U_KMB,U_exact\n";
-            for (i = 0; i < Xs; i++) {
-                
-                long double u_exact = utilspack::rozwiazanie_analityczne(X[i], T[n], Xs);
-                fout << X[i] << "," << U[i] <<  "," << u_exact << "\n";
-            }
-            fout.close();
+            // Jeśli podany indeks jest jednym z wybranych do zapisu to zapisz migawkę (plik .htb / CSV):
+
+            //-------------------------- ZAPIS MIGAWKI ------------------------------------------
+            writer.zapisz_migawke(n, T[n], U, U_ref);   // np. KMBresults0iter.csv
             //------------------------------------------------------------------------------------
         }
         
+        // Krok KMB połączony z wyznaczeniem błędu bieżącego poziomu (jedno przejście po U)
+        err_kmb = kmbpack::oblicz_nastepny_poziom_czasowy_KMB(U, Tmp, lambda, Xs, U_ref);
+
         //----------------- ZAPISANIE KROKU CAŁKOWANIA I BŁĘDU DO PLIKU CSV ------------------
-        err_kmb = utilspack::compute_max_error(U, X, T[n], Xs);
-        file_errr_time << T[n] << "," << err_kmb <<"\n";
+        writer.zapisz_blad(T[n], err_kmb);
         //------------------------------------------------------------------------------------
 
-        oblicz_nastepny_poziom_czasowy_KMB(U, Tmp, lambda, Xs);
         // Zamiana wskaźników, aby uniknąć kopiowania tablic – teraz Ue wskazuje na wynik nowej iteracji
         std::swap(U, Tmp);
 
     }
-    file_errr_time.close();
+    writer.zakoncz();
 
     // Dealokacja pamięci
     delete[] T;
     delete[] X;
     delete[] U;
     delete[] Tmp;
+    delete[] U_ref;
 
     auto end = std::chrono::high_resolution_clock::now(); // Zapisujemy czas zakończenia
     std::chrono::duration<double> duration = end - start; // Obliczamy różnicę czasu
     std::cout << "Czas wykonania: " << duration.count() << " sekund\n";
+    PROFIL_RAPORT(std::cout);
 
     return 0;
 }
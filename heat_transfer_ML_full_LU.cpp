@@ -4,9 +4,9 @@
 #include <fstream>
 #include <utility> // dla std::swap
 #include <string>
-#include "string.h" //do memset
 #include <set>
 #include <iomanip>
+#include <memory>
 #include "math.h"
 
 //  Pakiet udostęniony przez prowadzącego
@@ -18,11 +18,23 @@
 //  Pakiet dodatkowy (stworzony na zajęciach laboratoryjnych)
 #include "pakiety/LU.h"
 
-// INFO !!! : DLA M=1000, N=380, MIELI SIĘ Z 5 MINUT
+//  Pakiet dodatkowy (zapis wyników w tle)
+#include "pakiety/IO.h"
+//  Pakiet dodatkowy (badanie zbieżności)
+#include "pakiety/SYMULACJA.h"
+//  Pakiet dodatkowy (pomiar czasu faz, -DPROFILOWANIE)
+#include "pakiety/PROFIL.h"
+
+//  Pakiet dodatkowy (procedury metody Laasonen)
+#include "pakiety/METODY.h"
+
+// INFO: macierz przechowywana jest w formacie pasmowym (lupack::BandMatrix)
+// i dekomponowana raz na siatkę, więc krok czasowy kosztuje O(N) - wersja
+// dla macierzy pełnej (DLA M=1000, N=380) liczyła się około 5 minut
 
 /*  
     Komenda do kompilacji kodu: 
-    g++ heat_transfer_ML_full_LU.cpp "pakiety/CALERF.cpp" "pakiety/UTILS.cpp" "pakiety/LU.cpp" -o ML_LU
+    g++ heat_transfer_ML_full_LU.cpp "pakiety/CALERF.cpp" "pakiety/UTILS.cpp" "pakiety/LU.cpp" "pakiety/THOMAS.cpp" "pakiety/KMB.cpp" "pakiety/METODY.cpp" "pakiety/SYMULACJA.cpp" "pakiety/THREADS.cpp" "pakiety/IO.cpp" "pakiety/POLE.cpp" "pakiety/PROFIL.cpp" -pthread -o ML_LU
 
     Komenda wykonująca program:
     ./ML_LU
@@ -35,6 +47,11 @@
 //------------------------------------------------------
 //______________________________________________________
 
+//  true - macierz metody Laasonen dekomponowana jako symetryczna (LDL^T,
+//  lupack::LDLT_factorization, metoda "ML_LDLT" w badaniu zbieżności)
+//  zamiast LU z wyborem elementu podstawowego; wyniki w tych samych plikach
+const bool SYMETRYCZNA_LDLT = false;
+
 
 //___________________________________________________________________________________________________
 //  WSTĘPNA KONFIGURACJA DLA PUNKTÓW 2 I 3
@@ -59,124 +76,29 @@
 //____________________________________________________________________________________________________
 
 
-void oblicz_nastepny_poziom_czasowy_Laasonen_LU(const long double* U_old, 
-                                              long double* U_new, 
-                                              long double lambda,
-                                                int N) {
-    //-------------------------------------------------------------------
-    // Funkcja oblicza przybliżoną wartość funkcji na kolejnym poziomie czasowym
-    // Metoda Laasonen – układ równań z macierzą trójdiagonalną (przy brzegach
-    // ustawiamy U=0). W tej wersji budujemy pełną macierz A (w formacie jednowymiarowym)
-    // i wektor prawej strony U_new (nasze per se "b"):
-    //
-    //   Dla wierszy brzegowych (i == 0 lub i == N-1):
-    //       A[i, i] = 1, pozostałe elementy = 0, U_new[i] = 0.
-    //
-    //   Dla wierszy wewnętrznych (1 <= i <= N-2):
-    //       A[i, i-1] = -lambda, A[i, i] = 1 + 2*lambda, A[i, i+1] = -lambda,
-    //       U_new[i] = U_old[i]
-    //
-    // Po rozwiązaniu A*x = b, wynik (x) zostaje zapisany do U_new.
-    //
-    // Argumenty:
-    //   U_old - wektor wartości funkcji dla bieżącego poziomu czasowego,
-    //   U_new - wektor, do którego zapiszemy wynik kolejnej iteracji,
-    //   lambda - parametr lambda: D*dt/h^2 (najlepiej bliski 1 dla tej metody)
-    //   N - liczba węzłów siatki przestrzennej
-    //-------------------------------------------------------------------
-    
-    // Alokujemy pełną macierz A o rozmiarze N x N (zapisywaną jako jednowymiarowa tablica):
-    long double* A = new long double[N * N];
-    
-    // Zerujemy macierz A:
-    memset(A, 0, N * N * sizeof(long double));
-
-    
-    // Budujemy macierz A oraz wektor b_vec:
-    for (int i = 0; i < N; ++i) {
-        
-        if (i == 0 || i == (N - 1)) {
-            //  Warunki brzegowe: U = 0 na brzegach(pierwszy i ostatni węzeł)
-            //  Poniższe przekształcenie wynika bezpośrednio z postaci 
-            //  macierzy A w metodzie Laasonen, gdzie 1. i ostatni wiersz
-            //  odpowiadają za wartości funkcji na brzegach
-            
-            A[i * N + i] = 1.0L;
-            U_new[i] = 0.0L;
-        
-        
-        } else {
-            // Wiersz i (wewnętrzny):
-            A[i * N + (i - 1)] = -lambda;
-            A[i * N + i]       = 1.0L + 2.0L * lambda;
-            A[i * N + (i + 1)] = -lambda;
-            U_new[i] = U_old[i];
-        }
-    }
-    
-    // Rozwiązujemy układ A*x = b_vec wykorzystując funkcję LU_decompose_and_solve.
-    // Funkcja ta przyjmuje macierz A, wektor U_new (jako b) i rozmiar macierzy.
-    lupack::LU_decompose_and_solve(A, U_new, N);
-
-    // Zwolnienie alokowanych zasobów:
-    delete[] A;
-}
-
 
 #ifdef POINT_1
 int main() {
-    int Xs, Ts;  // zmienne przechowujące ilość węzłów
-    long double h, dt;  // kroki
-
-    std::ofstream fout("wyniki/ML_full_LU/ML_full_LU_results_error_step.csv");
-    fout << "log10(h),log10(max_error)\n";
-    fout << std::fixed << std::setprecision(19);
-
-    for (int k = 1; k <= 15; ++k) {
-        Xs = 24 * k;          // N jako wielokrotność 24
-        Ts = 10 * k * k;       // M z zależności 576M = 10N^2
+    //  Siatki Xs = 24k, Ts = 10k^2 liczone równolegle, od największej
+    //  (symulacjapack::badanie_zbieznosci); wyniki w kolejności k
+    symulacjapack::UstawieniaSymulacji u;
+    std::vector<symulacjapack::WynikSymulacji> wyniki = symulacjapack::badanie_zbieznosci(
+        SYMETRYCZNA_LDLT ? "ML_LDLT" : "ML_full_LU", u, 15);
 
-        // Używamy std::vector do alokacji pamięci
-        
-        long double* X   = new long double[Xs];  //  tablica przechowująca wartości węzłów siatki przestrzennej
-        long double* U  = new long double[Xs];  //  tablica przechowująca wartości funkcji dla KMB
-        long double* Tmp = new long double[Xs];  //  tablica przechowująca tymczasowe wartości funkcji
-
-        h = (2.0L * a) / (Xs - 1);      // krok przestrzenny
-        dt = t_max / (Ts - 1);          // krok czasowy (krok całkowania)
-
-        // Utworzenie siatki przestrzennej: X[i] = -a + i*h
-        for (int i = 0; i < Xs; ++i) {
-            X[i] = -a + static_cast<long double>(i) * h;
-        }
-
-        // Inicjalizacja warunku początkowego U(x,0)
-        utilspack::warunek_poczatkowy(U, X, Xs);
+    iopack::ZapisCSV fout("wyniki/ML_full_LU/ML_full_LU_results_error_step.csv", iopack::FormatCSV::STALY, 19);
+    fout.tekst("log10(h),log10(max_error)\n");
 
-        // Parametr lambda dla metody
-        long double lambda = D * dt / (h * h);
+    for (const symulacjapack::WynikSymulacji& w : wyniki) {
+        if (w.blad_koncowy < 0) return 1;
 
         // Wypisanie wymiarów siatki i lambdy
-        std::cout << "węzłów przestrzennych: " << Xs << ", węzłów czasowych: " << Ts << ", lambda = " << lambda << std::endl;
-
-        // Pętla czasowa (Ms-1 kroków)
-        for (int n = 0; n < Ts - 1; ++n) {
-            oblicz_nastepny_poziom_czasowy_Laasonen_LU(U, Tmp, lambda, Xs);
-            std::swap(U, Tmp);
-}
-
-        // Obliczenie błędu przy czasie t_max
-        long double err_kmb = utilspack::compute_max_error(U, X, t_max, Xs);
-        std::cout << "Max error Laasonen full LU = " << err_kmb << std::endl;
-        fout << log10l(h) << "," << log10l(err_kmb) << "\n";
-
-        delete[] X;
-        delete[] U;
-        delete[] Tmp;
-
+        std::cout << "węzłów przestrzennych: " << w.Xs << ", węzłów czasowych: " << w.Ts << ", lambda = " << w.lambda << std::endl;
+        std::cout << "Max error Laasonen full LU = " << w.blad_koncowy << std::endl;
+        fout.wiersz(log10l(w.h), log10l(w.blad_koncowy));
     }
 
-    fout.close();
+    fout.zamknij();
+    PROFIL_RAPORT(std::cout);
     
     return 0;
 }
@@ -193,6 +115,7 @@ int main() {
     long double* X   = new long double[Xs];  //  tablica przechowująca wartości węzłów siatki przestrzennej
     long double* U  = new long double[Xs];  //  tablica przechowująca wartości funkcji dla KMB
     long double* Tmp = new long double[Xs];  //  tablica przechowująca tymczasowe wartości funkcji
+    long double* U_ref = new long double[Xs];  //  rozwiązanie analityczne na bieżącym poziomie czasowym
     int i = 0; //  zmienna iteracyjna, aby nie definiować ciągle nowej
 
     // Utworzenie siatki przestrzennej jako: X[i] = -a + i*h
@@ -215,59 +138,102 @@ int main() {
     // Wypisanie wymiarów siatki i lambdy
     std::cout << "węzłów przestrzennych: " << Xs << ", węzłów czasowych: " << Ts << ", lambda = " << lambda << std::endl;
 
+    // Dekompozycja macierzy metody Laasonen - wykonywana tylko raz
+    std::shared_ptr<const lupack::LU_factorization> F;
+    std::unique_ptr<lupack::LDLT_factorization> F_LDLT;
+    if (SYMETRYCZNA_LDLT) {
+        F_LDLT.reset(metodypack::utworz_faktoryzacje_Laasonen_LDLT(lambda, Xs));
+    } else {
+        F = metodypack::utworz_faktoryzacje_Laasonen_LU(lambda, Xs);
+    }
+
 
     std::set<int> save_indexes= {0, 1, 10, 30, 80, 100, 200, 300, Ts-1};
     //  Tablica do przechowywania indeksów iteracji, w których zapisywane są wyniki
 
     
-    // otwarcie pliku przed rozpoczęciem petli, aby nie nadpisywać pliku
-    std::ofstream file_errr_time("wyniki/ML_full_LU/ML_full_LU_maxerror_vs_time.csv");
-    file_errr_time << "t,e_max\n";
+    // Zapis wyników w tle: plik błędów oraz migawki wybranych poziomów czasowych
+    // (wątek obliczeniowy jedynie kopiuje dane do bufora kolejki)
+    iopack::AsyncWriter writer(X, Xs, "wyniki/ML_full_LU/ML_full_LU_maxerror_vs_time.csv", "t,e_max\n");
+
+    // Wyniki zapisywane są do pliku binarnego; pliki CSV dla skryptów gnuplot
+    // odtwarza program konwerter_htb (lub ZAPIS_CSV = true - zapis bezpośredni)
+    const bool ZAPIS_CSV = false;
+    iopack::OpisHTB opis;
+    opis.metoda = "ML_full_LU";
+    opis.kolumna = "U_ML_full_LU";
+    opis.prefiks_migawek = "wyniki/ML_full_LU/ML_full_LU_results";
+    opis.D = D; opis.b = b; opis.a = a; opis.t_max = t_max;
+    opis.h = h; opis.dt = dt; opis.lambda = lambda; opis.Ts = Ts;
+    writer.zapis_binarny("wyniki/ML_full_LU/ML_full_LU_wyniki.htb", opis, ZAPIS_CSV);
+
+    // Całe pole U(x, t) (wszystkie poziomy czasowe) w skompresowanym pliku kafli;
+    // (domyślnie wyłączone - plik rośnie z liczbą poziomów czasowych);
+    // DOKLADNOSC_POLA - maksymalny błąd bezwzględny zapisu (0 - bezstratnie)
+    const bool ZAPIS_POLA = false;
+    const double DOKLADNOSC_POLA = 1.0e-10;
+    if (ZAPIS_POLA) writer.zapis_pola("wyniki/ML_full_LU/ML_full_LU_pole.htp", DOKLADNOSC_POLA);
     long double err_kmb;
     // te instrukcje przed pętlą aby uniknąc redundancji danych w kodzie
 
-    // Pętla czasowa
+    // Rozwiązanie analityczne na siatce X (czynniki zależne od t liczone raz na poziom czasowy)
+    utilspack::RozwiazanieAnalityczne analityczne(X, Xs);
+
+    // Błąd warunku początkowego; błędy kolejnych poziomów liczone są w trakcie kroków
+    analityczne.ustaw_czas(T[0]);
+    analityczne.wartosci(U_ref);
+    err_kmb = analityczne.max_error(U);
+    writer.zapisz_blad(T[0], err_kmb);
+
+    // Pętla czasowa (na początku iteracji U i U_ref odpowiadają poziomowi T[n])
     for (int n = 0; n < Ts; n++) {
+        PROFIL_ZAKRES("petla czasowa: poziom");
+        // Poziom T[n] do pliku całego pola (wątek obliczeniowy jedynie kopiuje U)
+        if (ZAPIS_POLA) writer.zapisz_poziom(T[n], U);
+
         // Metoda KMB
-        std::string template_filename = "wyniki/ML_full_LU/ML_full_LU_results";
         if(save_indexes.count(n)){
-            // Jeśli podany indeks jest jednym z wybranych do zapisu to zapisz do pliku CSV:
-
-            //-------------------------- ZAPIS DO PLIKU CSV -------------------------------------
-            std::ofstream fout(template_filename + std::to_string(n) + "iter.csv");   // np. LU_Thomas_results0iter.csv
-            
-            fout << "x,U_ML_full_LU,U_exact\n";
-            for (i = 0; i < Xs; i++) {
-                
-                long double u_exact = utilspack::rozwiazanie_analityczne(X[i], T[n], Xs);
-                fout << X[i] << "," << U[i] <<  "," << u_exact << "\n";
-            }
-            fout.close();
+            // Jeśli podany indeks jest jednym z wybranych do zapisu to zapisz migawkę (plik .htb / CSV):
+
+            //-------------------------- ZAPIS MIGAWKI ------------------------------------------
+            writer.zapisz_migawke(n, T[n], U, U_ref);   // np. ML_full_LU_results0iter.csv
             //------------------------------------------------------------------------------------
         }
         
+        if (n + 1 == Ts) break;     // ostatni poziom - kolejny krok nie jest potrzebny
+
+        // Krok metody Laasonen połączony z wyznaczeniem błędu nowego poziomu T[n+1]
+        // (błąd liczony w trakcie podstawiania wstecznego)
+        analityczne.ustaw_czas(T[n + 1]);
+        analityczne.wartosci(U_ref);
+        if (SYMETRYCZNA_LDLT) {
+            err_kmb = metodypack::oblicz_nastepny_poziom_czasowy_Laasonen_LDLT(*F_LDLT, U, Tmp, Xs, U_ref);
+        } else {
+            err_kmb = metodypack::oblicz_nastepny_poziom_czasowy_Laasonen_LU(*F, U, Tmp, Xs, U_ref);
+        }
+
         //----------------- ZAPISANIE KROKU CAŁKOWANIA I BŁĘDU DO PLIKU CSV ------------------
-        err_kmb = utilspack::compute_max_error(U, X, T[n], Xs);
-        file_errr_time << T[n] << "," << err_kmb <<"\n";
+        writer.zapisz_blad(T[n + 1], err_kmb);
         //------------------------------------------------------------------------------------
 
-        oblicz_nastepny_poziom_czasowy_Laasonen_LU(U, Tmp, lambda, Xs);
         // Zamiana wskaźników, aby uniknąć kopiowania tablic – teraz Ue wskazuje na wynik nowej iteracji
         std::swap(U, Tmp);
 
     }
-    file_errr_time.close();
+    writer.zakoncz();
 
     // Dealokacja pamięci
     delete[] T;
     delete[] X;
     delete[] U;
     delete[] Tmp;
+    delete[] U_ref;
 
 
     auto end = std::chrono::high_resolution_clock::now(); // Zapisujemy czas zakończenia
     std::chrono::duration<double> duration = end - start; // Obliczamy różnicę czasu
     std::cout << "Czas wykonania: " << duration.count() << " sekund\n";
+    PROFIL_RAPORT(std::cout);
 
     return 0;
 }
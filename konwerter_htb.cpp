@@ -0,0 +1,119 @@
+#include <iostream>
+#include <cstdlib>
+#include <string>
+#include <vector>
+//  Pakiet dodatkowy (format binarny wyników)
+#include "pakiety/IO.h"
+//  Pakiet dodatkowy (skompresowany zapis całego pola)
+#include "pakiety/POLE.h"
+
+/*
+            Komenda do kompilacji kodu:
+            g++ konwerter_htb.cpp pakiety/IO.cpp pakiety/POLE.cpp pakiety/UTILS.cpp pakiety/CALERF.cpp pakiety/THREADS.cpp pakiety/PROFIL.cpp -pthread -o konwerter_htb
+
+            Komenda wykonująca program:
+            ./konwerter_htb wyniki/KMB/KMB_wyniki.htb [katalog]
+            ./konwerter_htb wyniki/KMB/KMB_pole.htp poziom <n>
+            ./konwerter_htb wyniki/KMB/KMB_pole.htp wezel <i>
+
+            Odtwarza z pliku .htb pliki CSV w układzie oczekiwanym przez skrypty
+            gnuplot (pliki .gp w wyniki/<metoda>):
+              - <prefiks><n>iter.csv  z kolumnami x,<kolumna>,U_exact dla każdej migawki,
+              - plik błędów z kolumnami t,e_max.
+            Bez argumentu [katalog] pliki trafiają pod ścieżki zapisane w nagłówku
+            (względem katalogu bieżącego), z nim - do podanego katalogu.
+
+            Z pliku całego pola (.htp) wypisuje na standardowe wyjście CSV
+            poziomu czasowego n (x,U) lub przebiegu w czasie w węźle i (t,U);
+            dekompresowane są tylko kafle zawierające żądane dane.
+*/
+
+
+static std::string sciezka_wyjsciowa(const std::string& sciezka, const std::string& katalog) {
+    if (katalog.empty()) return sciezka;
+    size_t p = sciezka.find_last_of("/\\");
+    std::string nazwa = (p == std::string::npos) ? sciezka : sciezka.substr(p + 1);
+    return katalog + "/" + nazwa;
+}
+
+
+
+static int wypisz_z_pola(const std::string& nazwa, const std::string& rodzaj, int k) {
+    polepack::OdczytPola pole;
+    if (!pole.otworz(nazwa)) return 1;
+
+    if (rodzaj == "poziom") {
+        std::vector<double> U(pole.N());
+        if (!pole.poziom(k, U.data())) {
+            std::cerr << "Brak poziomu czasowego " << k << " (poziomów: " << pole.liczba_poziomow() << ")\n";
+            return 1;
+        }
+        std::cout << "x,U\n";
+        for (int i = 0; i < pole.N(); i++) {
+            std::cout << pole.X()[i] << "," << U[i] << "\n";
+        }
+    } else {
+        std::vector<double> U_t(pole.liczba_poziomow());
+        if (!pole.przekroj(k, U_t.data())) {
+            std::cerr << "Brak węzła " << k << " (węzłów: " << pole.N() << ")\n";
+            return 1;
+        }
+        std::cout << "t,U\n";
+        for (int n = 0; n < pole.liczba_poziomow(); n++) {
+            std::cout << pole.T()[n] << "," << U_t[n] << "\n";
+        }
+    }
+    return 0;
+}
+
+
+
+int main(int argc, char** argv) {
+
+    if (argc == 4 && (std::string(argv[2]) == "poziom" || std::string(argv[2]) == "wezel")) {
+        return wypisz_z_pola(argv[1], argv[2], std::atoi(argv[3]));
+    }
+    if (argc < 2 || argc > 3) {
+        std::cerr << "Użycie: " << argv[0] << " plik.htb [katalog]\n"
+                  << "        " << argv[0] << " plik.htp poziom <n> | wezel <i>\n";
+        return 1;
+    }
+    std::string katalog = (argc == 3) ? argv[2] : "";
+
+    iopack::BinarnyOdczyt plik;
+    if (!plik.otworz(argv[1])) return 1;
+
+    const iopack::NaglowekHTB& nag = plik.naglowek();
+    const int N = plik.N();
+    const long double* X = plik.X();
+
+    std::cout << "metoda: " << nag.metoda << ", węzłów przestrzennych: " << N << ", węzłów czasowych: " << nag.Ts
+              << ", lambda = " << nag.lambda << ", migawek: " << plik.liczba_migawek() << std::endl;
+
+    //  Migawki - formatowanie liczb takie samo jak przy zapisie CSV w programach obliczeniowych
+    for (int k = 0; k < plik.liczba_migawek(); k++) {
+        std::string nazwa = sciezka_wyjsciowa(std::string(nag.prefiks_migawek) + std::to_string(plik.n(k)) + "iter.csv", katalog);
+        iopack::ZapisCSV fout;
+        if (!fout.otworz(nazwa)) return 1;
+        const long double* U = plik.U(k);
+        const long double* U_exact = plik.U_exact(k);
+        fout.tekst("x,").tekst(nag.kolumna).tekst(",U_exact\n");
+        for (int i = 0; i < N; i++) {
+            fout.wiersz(X[i], U[i], U_exact[i]);
+        }
+    }
+
+    //  Błąd maksymalny w funkcji czasu
+    if (plik.liczba_bledow() > 0) {
+        std::string nazwa = sciezka_wyjsciowa(nag.plik_bledu, katalog);
+        iopack::ZapisCSV fout;
+        if (!fout.otworz(nazwa)) return 1;
+        const long double* e = plik.bledy();
+        fout.tekst("t,e_max\n");
+        for (int j = 0; j < plik.liczba_bledow(); j++) {
+            fout.wiersz(e[2 * j], e[2 * j + 1]);
+        }
+    }
+
+    return 0;
+}
@@ -0,0 +1,300 @@
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <ostream>
+#include "BENCH.h"
+#include "THREADS.h"
+
+
+
+static double teraz() {
+    return std::chrono::duration<double>(std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+
+
+void benchpack::nie_usuwaj(const void* p) {
+#if defined(__GNUC__)
+    asm volatile("" : : "r"(p) : "memory");
+#else
+    static const void* volatile ujscie;
+    ujscie = p;
+    (void)ujscie;
+#endif
+}
+
+
+
+benchpack::Statystyki benchpack::zmierz(const std::function<void()>& f, const OpcjePomiaru& o) {
+    //-------------------------------------------------------------------
+    //  Liczba wywołań na próbkę podwajana jest, aż próbka trwa co
+    //  najmniej o.min_czas_probki (krótkie jądra mierzone są w serii,
+    //  aby rozdzielczość zegara nie zniekształcała wyniku). Statystyki
+    //  dotyczą czasu jednego wywołania.
+    //-------------------------------------------------------------------
+    for (int i = 0; i < o.rozgrzewka; i++) f();
+
+    long n = 1;
+    for (;;) {
+        double t0 = teraz();
+        for (long i = 0; i < n; i++) f();
+        double t = teraz() - t0;
+        if (t >= o.min_czas_probki || n >= (1L << 30)) break;
+        //  skok od razu w okolice docelowej długości, najwyżej 16x
+        long nowe = (t > 0) ? (long)(n * 1.2 * o.min_czas_probki / t) : 16 * n;
+        n = std::max(2 * n, std::min(nowe, 16 * n));
+    }
+
+    int P = std::max(1, o.powtorzenia);
+    std::vector<double> probki(P);
+    for (int p = 0; p < P; p++) {
+        double t0 = teraz();
+        for (long i = 0; i < n; i++) f();
+        probki[p] = (teraz() - t0) / n;
+    }
+    std::sort(probki.begin(), probki.end());
+
+    Statystyki s;
+    s.probki = P;
+    s.wywolan_na_probke = n;
+    s.min = probki.front();
+    s.max = probki.back();
+    s.mediana = (P % 2) ? probki[P / 2] : 0.5 * (probki[P / 2 - 1] + probki[P / 2]);
+    double suma = 0;
+    for (double t : probki) suma += t;
+    s.srednia = suma / P;
+    double wariancja = 0;
+    for (double t : probki) wariancja += (t - s.srednia) * (t - s.srednia);
+    s.odch_std = (P > 1) ? std::sqrt(wariancja / (P - 1)) : 0.0;
+    return s;
+}
+
+
+
+static void lancuchy_ld(long double* a, long iter) {
+    //  8 niezależnych łańcuchów a = a*x + y (zmienne lokalne - w rejestrach)
+    const long double x = 0.999999L, y = 1.0e-6L;
+    long double r0 = a[0], r1 = a[1], r2 = a[2], r3 = a[3], r4 = a[4], r5 = a[5], r6 = a[6], r7 = a[7];
+    for (long i = 0; i < iter; i++) {
+        r0 = r0 * x + y; r1 = r1 * x + y; r2 = r2 * x + y; r3 = r3 * x + y;
+        r4 = r4 * x + y; r5 = r5 * x + y; r6 = r6 * x + y; r7 = r7 * x + y;
+    }
+    a[0] = r0; a[1] = r1; a[2] = r2; a[3] = r3; a[4] = r4; a[5] = r5; a[6] = r6; a[7] = r7;
+}
+
+
+
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+typedef double v4d __attribute__((vector_size(32)));
+
+__attribute__((target("avx2,fma")))
+static void lancuchy_avx2(double* a, long iter) {
+    //  jak lancuchy_ld, 8 łańcuchów po 4 liczby double (FMA)
+    const v4d x = {0.999999, 0.999999, 0.999999, 0.999999};
+    const v4d y = {1.0e-6, 1.0e-6, 1.0e-6, 1.0e-6};
+    v4d r[8];
+    for (int j = 0; j < 8; j++) r[j] = v4d{a[j], a[j], a[j], a[j]};
+    for (long i = 0; i < iter; i++) {
+        r[0] = r[0] * x + y; r[1] = r[1] * x + y; r[2] = r[2] * x + y; r[3] = r[3] * x + y;
+        r[4] = r[4] * x + y; r[5] = r[5] * x + y; r[6] = r[6] * x + y; r[7] = r[7] * x + y;
+    }
+    for (int j = 0; j < 8; j++) a[j] = r[j][0] + r[j][1] + r[j][2] + r[j][3];
+}
+#endif
+
+static int lancuchy_double(double* a, long iter) {
+    //  Zwraca liczbę liczb w jednym łańcuchu (szerokość wektora)
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx2") && __builtin_cpu_supports("fma")) {
+        lancuchy_avx2(a, iter);
+        return 4;
+    }
+#endif
+    const double x = 0.999999, y = 1.0e-6;
+    double r0 = a[0], r1 = a[1], r2 = a[2], r3 = a[3], r4 = a[4], r5 = a[5], r6 = a[6], r7 = a[7];
+    for (long i = 0; i < iter; i++) {
+        r0 = r0 * x + y; r1 = r1 * x + y; r2 = r2 * x + y; r3 = r3 * x + y;
+        r4 = r4 * x + y; r5 = r5 * x + y; r6 = r6 * x + y; r7 = r7 * x + y;
+    }
+    a[0] = r0; a[1] = r1; a[2] = r2; a[3] = r3; a[4] = r4; a[5] = r5; a[6] = r6; a[7] = r7;
+    return 1;
+}
+
+
+
+benchpack::Maszyna benchpack::zmierz_maszyne(const OpcjePomiaru& o) {
+    //-------------------------------------------------------------------
+    //  Szczyt obliczeń: 8 niezależnych łańcuchów a = a*x + y w long
+    //  double (precyzja, w której liczą jądra programu) oraz w double
+    //  na wektorach. Przepustowość: triada na tablicach double po 32 MB
+    //  (24 bajty na element, jak w teście STREAM).
+    //-------------------------------------------------------------------
+    Maszyna m;
+    m.watki = threadpack::hardware_threads();
+
+    OpcjePomiaru krotko = o;
+    krotko.powtorzenia = std::min(o.powtorzenia, 5);
+
+    const long ITER = 1 << 16;
+    long double a[8];
+    Statystyki s = zmierz([&]() {
+        for (int j = 0; j < 8; j++) a[j] = 1.0L + j;
+        lancuchy_ld(a, ITER);
+        nie_usuwaj(a);
+    }, krotko);
+    m.gflops_szczyt = 2.0 * 8 * ITER / s.mediana * 1e-9;
+
+    double ad[8];
+    int szerokosc = 1;
+    s = zmierz([&]() {
+        for (int j = 0; j < 8; j++) ad[j] = 1.0 + j;
+        szerokosc = lancuchy_double(ad, ITER);
+        nie_usuwaj(ad);
+    }, krotko);
+    m.gflops_szczyt_double = 2.0 * 8 * szerokosc * ITER / s.mediana * 1e-9;
+
+    const long N = 1L << 22;
+    std::vector<double> A(N, 1.0), B(N, 2.0), C(N, 0.0);
+    s = zmierz([&]() {
+        const double q = 0.5;
+        double* c = C.data();
+        const double* pa = A.data();
+        const double* pb = B.data();
+        for (long i = 0; i < N; i++) c[i] = pa[i] + q * pb[i];
+        nie_usuwaj(c);
+    }, krotko);
+    m.gbs_pamieci = 24.0 * N / s.mediana * 1e-9;
+    return m;
+}
+
+
+
+double benchpack::roofline(const Maszyna& m, const WynikPomiaru& w) {
+    if (w.flop <= 0) return 0.0;
+    const double szczyt = w.w_double ? m.gflops_szczyt_double : m.gflops_szczyt;
+    if (w.bajty <= 0) return szczyt;
+    return std::min(szczyt, w.flop / w.bajty * m.gbs_pamieci);
+}
+
+
+
+void benchpack::wypisz(std::ostream& out, const Maszyna& m, const std::vector<WynikPomiaru>& wyniki) {
+    char linia[256];
+    std::snprintf(linia, sizeof linia,
+        "Maszyna: %d wątków, szczyt %.3g GFLOP/s (long double) / %.3g GFLOP/s (double), pamięć %.3g GB/s\n",
+        m.watki, m.gflops_szczyt, m.gflops_szczyt_double, m.gbs_pamieci);
+    out << linia;
+    std::snprintf(linia, sizeof linia, "%-25s %-19s %9s %12s %8s %9s %9s %9s %8s\n",
+        "jądro", "wariant", "N", "mediana[s]", "rsd[%]", "ns/elem", "GFLOP/s", "GB/s", "roofl[%]");
+    out << linia;
+    for (const WynikPomiaru& w : wyniki) {
+        double r = roofline(m, w);
+        double rsd = w.czas.srednia > 0 ? 100.0 * w.czas.odch_std / w.czas.srednia : 0.0;
+        //  jądra bez liczby flop (np. erfc) - "-" zamiast GFLOP/s i roofline
+        char gflops[16] = "-", roofl[16] = "-";
+        if (w.flop > 0) std::snprintf(gflops, sizeof gflops, "%.3f", w.gflops());
+        if (r > 0) std::snprintf(roofl, sizeof roofl, "%.1f", 100.0 * w.gflops() / r);
+        std::snprintf(linia, sizeof linia, "%-24s %-19s %9ld %12.4e %8.2f %9.3f %9s %9.3f %8s\n",
+            w.jadro.c_str(), w.wariant.c_str(), w.N, w.czas.mediana, rsd, w.ns_na_element(),
+            gflops, w.gbs(), roofl);
+        out << linia;
+    }
+
+    bool liczniki = false;
+    for (const WynikPomiaru& w : wyniki) liczniki = liczniki || !w.liczniki.empty();
+    if (!liczniki) return;
+    out << "\nLiczniki:\n";
+    for (const WynikPomiaru& w : wyniki) {
+        if (w.liczniki.empty()) continue;
+        std::snprintf(linia, sizeof linia, "%-24s %-19s %9ld", w.jadro.c_str(), w.wariant.c_str(), w.N);
+        out << linia;
+        for (const auto& para : w.liczniki) {
+            std::snprintf(linia, sizeof linia, "  %s %.4g", para.first.c_str(), para.second);
+            out << linia;
+        }
+        out << "\n";
+    }
+}
+
+
+
+static void liczba_json(std::ostream& out, double x) {
+    //  JSON nie ma NaN ani nieskończoności
+    if (!std::isfinite(x)) {
+        out << "null";
+        return;
+    }
+    char bufor[32];
+    std::snprintf(bufor, sizeof bufor, "%.6g", x);
+    out << bufor;
+}
+
+
+
+void benchpack::zapisz_json(std::ostream& out, const Maszyna& m, const std::vector<WynikPomiaru>& wyniki,
+        const OpcjePomiaru& o) {
+    //-------------------------------------------------------------------
+    //  Jeden obiekt: "maszyna", "opcje" i tablica "wyniki". Pola gflops,
+    //  gbs i roofline są null, gdy jądro nie ma zdefiniowanej liczby
+    //  operacji lub bajtów. Czasy w sekundach na jedno wywołanie.
+    //  Obiekt "liczniki" tylko dla pomiarów z licznikami.
+    //-------------------------------------------------------------------
+    out << "{\n  \"maszyna\": {\"watki\": " << m.watki << ", \"gflops_szczyt\": ";
+    liczba_json(out, m.gflops_szczyt);
+    out << ", \"gflops_szczyt_double\": ";
+    liczba_json(out, m.gflops_szczyt_double);
+    out << ", \"gbs_pamieci\": ";
+    liczba_json(out, m.gbs_pamieci);
+    out << ", \"sizeof_long_double\": " << sizeof(long double) << "},\n";
+    out << "  \"opcje\": {\"rozgrzewka\": " << o.rozgrzewka << ", \"powtorzenia\": " << o.powtorzenia
+        << ", \"min_czas_probki\": ";
+    liczba_json(out, o.min_czas_probki);
+    out << "},\n  \"wyniki\": [";
+
+    const double NaN = std::nan("");
+    for (size_t k = 0; k < wyniki.size(); k++) {
+        const WynikPomiaru& w = wyniki[k];
+        double r = roofline(m, w);
+        out << (k ? ",\n" : "\n") << "    {\"jadro\": \"" << w.jadro << "\", \"wariant\": \"" << w.wariant
+            << "\", \"N\": " << w.N << ", \"double\": " << (w.w_double ? "true" : "false")
+            << ", \"elementy\": ";
+        liczba_json(out, w.elementy);
+        out << ", \"flop\": ";
+        liczba_json(out, w.flop);
+        out << ", \"bajty\": ";
+        liczba_json(out, w.bajty);
+        out << ",\n     \"czas\": {\"min\": ";
+        liczba_json(out, w.czas.min);
+        out << ", \"mediana\": ";
+        liczba_json(out, w.czas.mediana);
+        out << ", \"srednia\": ";
+        liczba_json(out, w.czas.srednia);
+        out << ", \"odch_std\": ";
+        liczba_json(out, w.czas.odch_std);
+        out << ", \"max\": ";
+        liczba_json(out, w.czas.max);
+        out << ", \"probki\": " << w.czas.probki << ", \"wywolan_na_probke\": " << w.czas.wywolan_na_probke;
+        out << "},\n     \"ns_na_element\": ";
+        liczba_json(out, w.ns_na_element());
+        out << ", \"gflops\": ";
+        liczba_json(out, w.flop > 0 ? w.gflops() : NaN);
+        out << ", \"gbs\": ";
+        liczba_json(out, w.bajty > 0 ? w.gbs() : NaN);
+        out << ", \"roofline_gflops\": ";
+        liczba_json(out, r > 0 ? r : NaN);
+        out << ", \"ulamek_roofline\": ";
+        liczba_json(out, r > 0 ? w.gflops() / r : NaN);
+        if (!w.liczniki.empty()) {
+            out << ",\n     \"liczniki\": {";
+            for (size_t j = 0; j < w.liczniki.size(); j++) {
+                out << (j ? ", \"" : "\"") << w.liczniki[j].first << "\": ";
+                liczba_json(out, w.liczniki[j].second);
+            }
+            out << "}";
+        }
+        out << "}";
+    }
+    out << "\n  ]\n}\n";
+}
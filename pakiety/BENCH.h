@@ -0,0 +1,85 @@
+#ifndef __bench_h
+#define __bench_h
+
+#include <functional>
+#include <iosfwd>
+#include <string>
+#include <utility>
+#include <vector>
+
+//----------------------------------------------------------------------
+// Pakiet pomiarów wydajności jąder obliczeniowych: rozgrzewka,
+// kalibracja liczby wywołań na próbkę, powtórzenia ze statystykami,
+// przeliczenie na ns/element, GFLOP/s i GB/s oraz porównanie z
+// modelem roofline zmierzonym na bieżącej maszynie. Wyniki można
+// zapisać w formacie JSON (porównywanie wersji, wykrywanie regresji).
+//----------------------------------------------------------------------
+namespace benchpack{
+
+    struct OpcjePomiaru {
+        int rozgrzewka = 2;             //  wywołania przed pomiarem
+        int powtorzenia = 15;           //  liczba próbek
+        double min_czas_probki = 0.02;  //  [s] - próbka obejmuje tyle wywołań, by trwać co najmniej tyle
+    };
+
+    //  Statystyki czasu jednego wywołania [s]
+    struct Statystyki {
+        double min = 0, mediana = 0, srednia = 0, odch_std = 0, max = 0;
+        int probki = 0;
+        long wywolan_na_probke = 0;
+    };
+
+    //------------------------------------------------------------------
+    // Opis jądra dla jednego rozmiaru: elementy - liczba jednostek pracy
+    // w wywołaniu (np. węzeł-krok), flop i bajty - na wywołanie (0, gdy
+    // nie mają sensu, np. erfc liczone wielomianem wymiernym z gałęziami).
+    // Bajty to ruch z pamięci przy założeniu, że dane nie mieszczą się
+    // w pamięci podręcznej (dla małych N wartość GB/s jest więc umowna).
+    //------------------------------------------------------------------
+    struct WynikPomiaru {
+        std::string jadro;
+        std::string wariant;
+        long N = 0;
+        double elementy = 0;
+        double flop = 0;
+        double bajty = 0;
+        bool w_double = false;          //  obliczenia w double (inny szczyt roofline)
+        Statystyki czas;
+        //  dodatkowe wielkości na element (np. z liczników sprzętowych), nazwa - wartość
+        std::vector<std::pair<std::string, double>> liczniki;
+
+        double ns_na_element() const { return czas.mediana * 1e9 / elementy; }
+        double gflops() const { return flop > 0 ? flop / czas.mediana * 1e-9 : 0.0; }
+        double gbs() const { return bajty > 0 ? bajty / czas.mediana * 1e-9 : 0.0; }
+    };
+
+    //  Parametry modelu roofline bieżącej maszyny (zmierzone)
+    struct Maszyna {
+        int watki = 1;
+        double gflops_szczyt = 0;       //  niezależne mnożenia i dodawania long double (jeden wątek)
+        double gflops_szczyt_double = 0;//  to samo w double, wektorowo (AVX2/FMA, jeśli dostępne)
+        double gbs_pamieci = 0;         //  triada U = A + s*B na tablicach większych od L3
+    };
+
+    //  Pomiar: f wywoływana rozgrzewka razy, potem powtorzenia próbek
+    //  po wywolan_na_probke wywołań (dobrane automatycznie)
+    Statystyki zmierz(const std::function<void()>& f, const OpcjePomiaru& o = OpcjePomiaru());
+
+    //  Krótki pomiar szczytowej wydajności obliczeń i przepustowości pamięci
+    Maszyna zmierz_maszyne(const OpcjePomiaru& o = OpcjePomiaru());
+
+    //  Ograniczenie z modelu roofline: min(szczyt, intensywność * przepustowość)
+    //  [GFLOP/s]; 0, gdy pomiar nie ma liczby operacji
+    double roofline(const Maszyna& m, const WynikPomiaru& w);
+
+    //  Tabela wyników (czytelna) i zapis JSON
+    void wypisz(std::ostream& out, const Maszyna& m, const std::vector<WynikPomiaru>& wyniki);
+    void zapisz_json(std::ostream& out, const Maszyna& m, const std::vector<WynikPomiaru>& wyniki,
+        const OpcjePomiaru& o);
+
+    //  Zapobiega usunięciu przez kompilator obliczeń, których wynik nie jest używany
+    void nie_usuwaj(const void* p);
+
+}
+
+#endif
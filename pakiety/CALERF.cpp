@@ -1,6 +1,7 @@
 
 #include "math.h"
 #include "iostream"
+#include "string.h"
 
 
 #include "CALERF.h"
@@ -386,3 +387,254 @@ return  calerfpack::calerf_LD(x,2);
 
 
 
+
+
+
+
+
+////////////////////////
+// batch versions
+////////////////////////
+
+
+void  calerfpack::erfc_batch(const long double* in, long double* out, int n)
+{
+for(int i=0; i<n; i++)out[i] = calerfpack::calerf_LD(in[i],1);
+}
+
+
+
+void  calerfpack::erf_batch(const long double* in, long double* out, int n)
+{
+for(int i=0; i<n; i++)out[i] = calerfpack::calerf_LD(in[i],0);
+}
+
+
+
+
+
+//-----------------------------------------------------------------
+//  Double version evaluated on vectors of 8 arguments (GCC vector
+//  extensions). All three intervals of calerf are computed for every
+//  lane and the results are blended by masks, so there are no
+//  data-dependent branches. expl() is replaced by a vectorizable
+//  exp (Cody-Waite reduction + degree-13 Taylor polynomial), and
+//  AVX2 / AVX-512 clones are selected at load time.
+//-----------------------------------------------------------------
+#if defined(__GNUC__)
+
+#if !defined(__clang__) && (defined(__x86_64__) || defined(__i386__))
+    #define CALERF_BATCH_CLONES __attribute__((target_clones("avx512f", "avx2", "default")))
+#else
+    #define CALERF_BATCH_CLONES
+#endif
+#define CALERF_BATCH_INLINE inline __attribute__((always_inline))
+
+typedef double    vd8 __attribute__((vector_size(8 * sizeof(double))));
+typedef long long vl8 __attribute__((vector_size(8 * sizeof(long long))));
+
+static const int VL = 8;
+
+//-----------------------------------------------------------------
+//  Coefficients (double precision Cody tables)
+//-----------------------------------------------------------------
+static const double AD[5] = { 3.16112374387056560e00, 1.13864154151050156e02,
+                              3.77485237685302021e02, 3.20937758913846947e03,
+                              1.85777706184603153e-1 };
+static const double BD[4] = { 2.36012909523441209e01, 2.44024637934444173e02,
+                              1.28261652607737228e03, 2.84423683343917062e03 };
+static const double CD[9] = { 5.64188496988670089e-1, 8.88314979438837594e0,
+                              6.61191906371416295e01, 2.98635138197400131e02,
+                              8.81952221241769090e02, 1.71204761263407058e03,
+                              2.05107837782607147e03, 1.23033935479799725e03,
+                              2.15311535474403846e-8 };
+static const double DD[8] = { 1.57449261107098347e01, 1.17693950891312499e02,
+                              5.37181101862009858e02, 1.62138957456669019e03,
+                              3.29079923573345963e03, 4.36261909014324716e03,
+                              3.43936767414372164e03, 1.23033935480374942e03 };
+static const double PD[6] = { 3.05326634961232344e-1, 3.60344899949804439e-1,
+                              1.25781726111229246e-1, 1.60837851487422766e-2,
+                              6.58749161529837803e-4, 1.63153871373020978e-2 };
+static const double QD[5] = { 2.56852019228982242e00, 1.87295284992346047e00,
+                              5.27905102951428412e-1, 6.05183413124413191e-2,
+                              2.33520497626869185e-3 };
+
+static const double SQRPI_D  = 5.6418958354775628695e-1;
+static const double THRESH_D = 0.46875;
+static const double XBIG_D   = 26.543;
+
+
+
+static CALERF_BATCH_INLINE void vexp_neg(vd8& z)
+{
+//-----------------------------------------------------------------
+//  exp(z) for  -745 < z <= 0:  z = k*ln2 + r, |r| <= ln2/2,
+//  exp(r) from the Taylor polynomial of degree 13 (error < 2^-56),
+//  2^k applied in two halves so that subnormal results are exact
+//  up to the final rounding. Overwrites z with the result.
+//-----------------------------------------------------------------
+const double LOG2E  = 1.4426950408889634074;
+const double LN2_HI = 6.93147180369123816490e-01;
+const double LN2_LO = 1.90821492927058770002e-10;
+
+vd8 kd = __builtin_convertvector(
+             __builtin_convertvector(z*LOG2E - 0.5, vl8), vd8);   // round, z <= 0
+vd8 r  = (z - kd*LN2_HI) - kd*LN2_LO;
+
+vd8 p = r*(1.0/6227020800.0) + 1.0/479001600.0;
+p = p*r + 1.0/39916800.0;
+p = p*r + 1.0/3628800.0;
+p = p*r + 1.0/362880.0;
+p = p*r + 1.0/40320.0;
+p = p*r + 1.0/5040.0;
+p = p*r + 1.0/720.0;
+p = p*r + 1.0/120.0;
+p = p*r + 1.0/24.0;
+p = p*r + 1.0/6.0;
+p = p*r + 0.5;
+p = p*r + 1.0;
+p = p*r + 1.0;
+
+vl8 k  = __builtin_convertvector(kd, vl8);
+vl8 k1 = k >> 1;
+vl8 k2 = k - k1;
+vl8 e1 = (k1 + 1023) << 52;
+vl8 e2 = (k2 + 1023) << 52;
+vd8 s1, s2;
+memcpy(&s1, &e1, sizeof(s1));
+memcpy(&s2, &e2, sizeof(s2));
+z = (p*s1)*s2;
+}
+
+
+
+template <int jint>
+static CALERF_BATCH_INLINE void vcalerf(vd8& v)
+{
+//-----------------------------------------------------------------
+//  jint = 0: erf(x),  jint = 1: erfc(x);  v = x on entry,
+//  the result on exit
+//-----------------------------------------------------------------
+const vd8 x = v;
+vd8 y = x < 0.0 ? -x : x;
+vd8 yc = y < XBIG_D ? y : XBIG_D;    // also maps NaN to XBIG (fixed below)
+
+//  |x| <= 0.46875: erf = x * R1(x^2)
+vd8 ysq = yc < THRESH_D ? yc*yc : THRESH_D*THRESH_D;
+vd8 xnum = AD[4]*ysq;
+vd8 xden = ysq;
+for(int i=0; i<3; i++)
+   {
+   xnum = (xnum + AD[i])*ysq;
+   xden = (xden + BD[i])*ysq;
+   }
+vd8 r1 = x*(xnum + AD[3])/(xden + BD[3]);
+
+//  0.46875 < |x| <= 4: erfc = R2(y) * exp(-y^2)
+vd8 y2 = yc < 4.0 ? yc : 4.0;
+xnum = CD[8]*y2;
+xden = y2;
+for(int i=0; i<7; i++)
+   {
+   xnum = (xnum + CD[i])*y2;
+   xden = (xden + DD[i])*y2;
+   }
+vd8 r2 = (xnum + CD[7])/(xden + DD[7]);
+
+//  |x| > 4: erfc = (1/sqrt(pi) - R3(1/y^2)/y^2)/y * exp(-y^2)
+vd8 y3 = yc > 4.0 ? yc : 4.0;
+ysq = 1.0/(y3*y3);
+xnum = PD[5]*ysq;
+xden = ysq;
+for(int i=0; i<4; i++)
+   {
+   xnum = (xnum + PD[i])*ysq;
+   xden = (xden + QD[i])*ysq;
+   }
+vd8 r3 = ysq*(xnum + PD[4])/(xden + QD[4]);
+r3 = (SQRPI_D - r3)/y3;
+
+//  exp(-y^2) = exp(-ysq^2) * exp(-del), ysq = aint(16y)/16
+vd8 e = y <= 4.0 ? r2 : r3;
+ysq = __builtin_convertvector(__builtin_convertvector(yc*16.0, vl8), vd8)/16.0;
+vd8 del = (yc - ysq)*(yc + ysq);
+vd8 e1 = -ysq*ysq;
+vd8 e2 = -del;
+vexp_neg(e1);
+vexp_neg(e2);
+e = e1*e2*e;
+//  XBIG_D (double) < XBIG (long double), so y >= XBIG  <=>  y > XBIG_D
+e = y > XBIG_D ? 0.0 : e;
+
+vd8 result;
+if(jint == 0)
+  {
+  vd8 f = (0.5 - e) + 0.5;
+  f = x < 0.0 ? -f : f;
+  result = y <= THRESH_D ? r1 : f;
+  }
+else
+  {
+  vd8 f = x < 0.0 ? 2.0 - e : e;
+  result = y <= THRESH_D ? 1.0 - r1 : f;
+  }
+v = x == x ? result : x;
+}
+
+
+
+template <int jint>
+static CALERF_BATCH_INLINE void calerf_batch_impl(const double* in, double* out, int n)
+{
+int i = 0;
+for(; i + VL <= n; i += VL)
+   {
+   vd8 v;
+   memcpy(&v, in + i, sizeof(v));
+   vcalerf<jint>(v);
+   memcpy(out + i, &v, sizeof(v));
+   }
+if(i < n)
+  {
+  // remaining arguments padded with zeros
+  double tmp[VL] = {};
+  memcpy(tmp, in + i, (n - i)*sizeof(double));
+  vd8 v;
+  memcpy(&v, tmp, sizeof(v));
+  vcalerf<jint>(v);
+  memcpy(tmp, &v, sizeof(v));
+  memcpy(out + i, tmp, (n - i)*sizeof(double));
+  }
+}
+
+
+
+CALERF_BATCH_CLONES
+void  calerfpack::erfc_batch(const double* in, double* out, int n)
+{
+calerf_batch_impl<1>(in, out, n);
+}
+
+
+
+CALERF_BATCH_CLONES
+void  calerfpack::erf_batch(const double* in, double* out, int n)
+{
+calerf_batch_impl<0>(in, out, n);
+}
+
+#else
+
+void  calerfpack::erfc_batch(const double* in, double* out, int n)
+{
+for(int i=0; i<n; i++)out[i] = (double)calerfpack::calerf_LD(in[i],1);
+}
+
+
+
+void  calerfpack::erf_batch(const double* in, double* out, int n)
+{
+for(int i=0; i<n; i++)out[i] = (double)calerfpack::calerf_LD(in[i],0);
+}
+
+#endif
@@ -9,6 +9,22 @@ long double calerf_LD(const long double arg, const int jint);
 long double erf_LD(const long double x);
 long double erfc_LD(const long double x);
 long double erex_LD(const long double x);
+
+// Wersje tablicowe: out[i] = erfc(in[i]) (erf(in[i])) dla i = 0..n-1.
+// Wersja long double wywołuje calerf_LD dla kolejnych elementów. Wersja
+// double liczy te same przybliżenia wymierne Cody'ego bez rozgałęzień
+// (wszystkie przedziały + maskowanie) na wektorach 8 liczb, z własną
+// funkcją wykładniczą. Różnica względem (double)erfc_LD nie przekracza
+// 8 ulp (erfc_LD dla argumentów double daje 0 albo wynik znormalizowany,
+// najmniejszy erfc(26.543) ~ 2.26e-308); dla erf - 5 ulp (wyniki
+// podnormalne: 5 najmniejszych liczb podnormalnych). Sprawdzane przez
+// ./benchmark --sprawdz. (Sam algorytm Cody'ego liczony w double ze
+// std::exp daje do 7 ulp.)
+// Tablice in i out mogą być tą samą tablicą.
+void erfc_batch(const long double* in, long double* out, int n);
+void erfc_batch(const double* in, double* out, int n);
+void erf_batch(const long double* in, long double* out, int n);
+void erf_batch(const double* in, double* out, int n);
 };
 // -----------------------------------------------
 
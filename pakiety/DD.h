@@ -0,0 +1,129 @@
+#ifndef __dd_h
+#define __dd_h
+
+#include <cmath>
+
+//----------------------------------------------------------------------
+// Pakiet arytmetyki double-double: liczba reprezentowana jest jako
+// nieobliczona suma hi + lo dwóch liczb double (|lo| <= ulp(hi)/2),
+// co daje ok. 106 bitów mantysy (x87 long double: 64 bity).
+//
+// Działania zbudowane są z przekształceń bezbłędnych (two_sum,
+// two_prod) i wykonywane wyłącznie na double - w odróżnieniu od
+// long double mogą więc być wektoryzowane (np. jądra KMB w kmbpack).
+// Algorytmy zakładają brak kontrakcji a*b + c do FMA: przy kompilacji
+// z -mfma lub -march=native należy dodać -ffp-contract=off (GCC domyślnie
+// łączy takie wyrażenia, gdy procesor docelowy ma FMA).
+//
+// Zakres wykładników jest taki jak double (nie long double).
+//----------------------------------------------------------------------
+namespace ddpack{
+
+    //  s + e = a + b dokładnie (dowolne a, b)
+    inline void two_sum(double a, double b, double& s, double& e) {
+        s = a + b;
+        double bb = s - a;
+        e = (a - (s - bb)) + (b - bb);
+    }
+
+    //  s + e = a + b dokładnie, gdy |a| >= |b|
+    inline void quick_two_sum(double a, double b, double& s, double& e) {
+        s = a + b;
+        e = b - (s - a);
+    }
+
+    //  a = hi + lo, obie części z co najwyżej 26 bitami mantysy (Veltkamp)
+    inline void split(double a, double& hi, double& lo) {
+        double t = 134217729.0 * a;             //  2^27 + 1
+        hi = t - (t - a);
+        lo = a - hi;
+    }
+
+    //  p + e = a * b dokładnie; z FMA (-mfma, -march=...) jednym rozkazem,
+    //  bez - algorytmem Dekkera (wynik ten sam, bo e jest dokładne)
+    inline void two_prod(double a, double b, double& p, double& e) {
+        p = a * b;
+#ifdef __FMA__
+        e = std::fma(a, b, -p);
+#else
+        double ah, al, bh, bl;
+        split(a, ah, al);
+        split(b, bh, bl);
+        e = ((ah * bh - p) + ah * bl + al * bh) + al * bl;
+#endif
+    }
+
+    struct dd {
+        double hi, lo;                          //  typ trywialny (jak double): dd() nie zeruje, dd{} i T() zerują
+
+        dd() = default;
+        constexpr dd(double x) : hi(x), lo(0.0) {}
+        constexpr dd(float x) : hi(x), lo(0.0) {}
+        constexpr dd(int x) : hi(x), lo(0.0) {}
+        constexpr dd(double hi, double lo) : hi(hi), lo(lo) {}
+        explicit dd(long double x) : hi(static_cast<double>(x)), lo(static_cast<double>(x - static_cast<long double>(hi))) {}
+
+        explicit operator double() const { return hi + lo; }
+        explicit operator float() const { return static_cast<float>(hi + lo); }
+        explicit operator long double() const { return static_cast<long double>(hi) + static_cast<long double>(lo); }
+
+        dd& operator+=(const dd& b);
+        dd& operator-=(const dd& b);
+        dd& operator*=(const dd& b);
+        dd& operator/=(const dd& b);
+    };
+
+    inline dd operator-(const dd& a) { return dd(-a.hi, -a.lo); }
+
+    inline dd operator+(const dd& a, const dd& b) {
+        //  dodawanie z zachowaniem pełnej dokładności także przy a ~ -b
+        double s, e, t, f;
+        two_sum(a.hi, b.hi, s, e);
+        two_sum(a.lo, b.lo, t, f);
+        e += t;
+        quick_two_sum(s, e, s, e);
+        e += f;
+        quick_two_sum(s, e, s, e);
+        return dd(s, e);
+    }
+
+    inline dd operator-(const dd& a, const dd& b) { return a + (-b); }
+
+    inline dd operator*(const dd& a, const dd& b) {
+        double p, e;
+        two_prod(a.hi, b.hi, p, e);
+        e += a.hi * b.lo + a.lo * b.hi;
+        quick_two_sum(p, e, p, e);
+        return dd(p, e);
+    }
+
+    inline dd operator/(const dd& a, const dd& b) {
+        //  trzy kroki dzielenia "szkolnego": q1 + q2 + q3
+        double q1 = a.hi / b.hi;
+        dd r = a - b * dd(q1);
+        double q2 = r.hi / b.hi;
+        r = r - b * dd(q2);
+        double q3 = r.hi / b.hi;
+        double s, e;
+        quick_two_sum(q1, q2, s, e);
+        return dd(s, e) + dd(q3);
+    }
+
+    inline dd& dd::operator+=(const dd& b) { return *this = *this + b; }
+    inline dd& dd::operator-=(const dd& b) { return *this = *this - b; }
+    inline dd& dd::operator*=(const dd& b) { return *this = *this * b; }
+    inline dd& dd::operator/=(const dd& b) { return *this = *this / b; }
+
+    //  porównania: dla znormalizowanych liczb decyduje hi, przy równych hi - lo
+    inline bool operator==(const dd& a, const dd& b) { return a.hi == b.hi && a.lo == b.lo; }
+    inline bool operator!=(const dd& a, const dd& b) { return !(a == b); }
+    inline bool operator<(const dd& a, const dd& b) { return a.hi < b.hi || (a.hi == b.hi && a.lo < b.lo); }
+    inline bool operator>(const dd& a, const dd& b) { return b < a; }
+    inline bool operator<=(const dd& a, const dd& b) { return a < b || a == b; }
+    inline bool operator>=(const dd& a, const dd& b) { return b <= a; }
+
+    inline bool isfinite(const dd& a) { return std::isfinite(a.hi) && std::isfinite(a.lo); }
+
+}
+
+#endif
@@ -0,0 +1,659 @@
+#include "IO.h"
+#include "PROFIL.h"
+#include "THREADS.h"
+#include "UTILS.h"
+#include <cfloat>
+#include <charconv>
+#include <cmath>
+#include <cstring>
+#include <iostream>
+#if defined(_WIN32)
+#include <fstream>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+
+
+//  liczba prób przed uśpieniem wątku czekającego na kolejkę
+static const int IO_SPINS = 2048;
+
+
+
+//  dokładne w long double potęgi 10^0 .. 10^27 (5^27 < 2^64)
+static const int CSV_POTEGI = 28;
+static const long double POTEGI_10[CSV_POTEGI] = {
+    1e0L, 1e1L, 1e2L, 1e3L, 1e4L, 1e5L, 1e6L, 1e7L, 1e8L, 1e9L, 1e10L, 1e11L, 1e12L, 1e13L,
+    1e14L, 1e15L, 1e16L, 1e17L, 1e18L, 1e19L, 1e20L, 1e21L, 1e22L, 1e23L, 1e24L, 1e25L, 1e26L, 1e27L};
+
+
+
+static char* formatuj_ogolny(char* p, long double v, int P) {
+    //-------------------------------------------------------------------
+    //  Zapis jak printf("%.*Lg", P, v) dla typowych wartości: liczba
+    //  skalowana jest dokładną potęgą 10 do P cyfr znaczących i zaokrąglana
+    //  do całkowitej. Zwraca nullptr (zapis przez std::to_chars), gdy
+    //  potęga wykracza poza tablicę, wartość jest NaN/inf lub leży tak
+    //  blisko połowy ostatniej cyfry, że błąd skalowania mógłby zmienić
+    //  zaokrąglenie.
+    //-------------------------------------------------------------------
+    if (P < 1 || P > 15 || !std::isfinite(v)) return nullptr;
+    if (std::signbit(v)) {
+        *p++ = '-';
+        v = -v;
+    }
+    if (v == 0) {
+        *p++ = '0';
+        return p;
+    }
+
+    int e2;
+    frexpl(v, &e2);
+    int e = (int)std::floor((e2 - 1) * 0.30102999566398120);     //  przybliżenie floor(log10(v))
+    long double s = 0;
+    for (int proba = 0; proba < 3; proba++) {
+        int k = P - 1 - e;
+        if (k >= CSV_POTEGI || k <= -CSV_POTEGI) return nullptr;
+        s = (k >= 0) ? v * POTEGI_10[k] : v / POTEGI_10[-k];
+        if (s < POTEGI_10[P - 1]) e--;
+        else if (s >= POTEGI_10[P]) e++;
+        else break;
+    }
+    if (s < POTEGI_10[P - 1] || s >= POTEGI_10[P]) return nullptr;
+
+    long double calosc = floorl(s);
+    long double ulamek = s - calosc;
+    if (fabsl(ulamek - 0.5L) <= s * 1e-18L) return nullptr;
+    unsigned long long r = (unsigned long long)calosc + (ulamek > 0.5L ? 1 : 0);
+    if (r == (unsigned long long)POTEGI_10[P]) {
+        r /= 10;
+        e++;
+    }
+
+    char cyfry[16];
+    for (int i = P - 1; i >= 0; i--) {
+        cyfry[i] = (char)('0' + r % 10);
+        r /= 10;
+    }
+    int n = P;
+    while (n > 1 && cyfry[n - 1] == '0') n--;       //  %g usuwa zera końcowe
+
+    if (e >= -4 && e < P) {
+        if (e >= 0) {
+            for (int i = 0; i <= e; i++) *p++ = (i < n) ? cyfry[i] : '0';
+            if (n > e + 1) {
+                *p++ = '.';
+                for (int i = e + 1; i < n; i++) *p++ = cyfry[i];
+            }
+        } else {
+            *p++ = '0';
+            *p++ = '.';
+            for (int i = 0; i < -e - 1; i++) *p++ = '0';
+            for (int i = 0; i < n; i++) *p++ = cyfry[i];
+        }
+    } else {
+        *p++ = cyfry[0];
+        if (n > 1) {
+            *p++ = '.';
+            for (int i = 1; i < n; i++) *p++ = cyfry[i];
+        }
+        *p++ = 'e';
+        *p++ = (e < 0) ? '-' : '+';
+        int w = (e < 0) ? -e : e;
+        if (w >= 100) *p++ = (char)('0' + w / 100);
+        *p++ = (char)('0' + (w / 10) % 10);
+        *p++ = (char)('0' + w % 10);
+    }
+    return p;
+}
+
+
+
+iopack::ZapisCSV::ZapisCSV(const std::string& nazwa, FormatCSV format, int precyzja)
+    : format(format), precyzja(precyzja) {
+    otworz(nazwa);
+}
+
+
+
+iopack::ZapisCSV::~ZapisCSV() {
+    zamknij();
+}
+
+
+
+bool iopack::ZapisCSV::otworz(const std::string& nazwa) {
+    zamknij();
+    bufor.resize(CSV_BUFOR);
+    uzyte = 0;
+    plik = fopen(nazwa.c_str(), "wb");
+    if (plik == nullptr) {
+        std::cerr << "Nie można utworzyć pliku " << nazwa << "\n";
+        return false;
+    }
+    return true;
+}
+
+
+
+void iopack::ZapisCSV::oproznij() {
+    PROFIL_ZAKRES("io: fwrite CSV");
+    if (plik != nullptr && uzyte > 0) fwrite(bufor.data(), 1, uzyte, plik);
+    uzyte = 0;
+}
+
+
+
+void iopack::ZapisCSV::zamknij() {
+    if (plik == nullptr) return;
+    oproznij();
+    fclose(plik);
+    plik = nullptr;
+}
+
+
+
+iopack::ZapisCSV& iopack::ZapisCSV::tekst(const char* s, size_t n) {
+    if (uzyte + n > bufor.size()) oproznij();
+    if (n > bufor.size()) {
+        if (plik != nullptr) fwrite(s, 1, n, plik);
+        return *this;
+    }
+    memcpy(bufor.data() + uzyte, s, n);
+    uzyte += n;
+    return *this;
+}
+
+
+
+iopack::ZapisCSV& iopack::ZapisCSV::liczba(long double v) {
+    //-------------------------------------------------------------------
+    //  Formatuje liczbę bezpośrednio w buforze. Zapis stałoprzecinkowy
+    //  bardzo dużych liczb może nie zmieścić się w rezerwie - wtedy
+    //  formatowany jest w osobnym, wystarczająco dużym buforze.
+    //-------------------------------------------------------------------
+    const size_t REZERWA = 128;
+    if (uzyte + REZERWA > bufor.size()) oproznij();
+    if (bufor.size() < REZERWA) return *this;   //  plik nie był otwierany
+
+    char* poczatek = bufor.data() + uzyte;
+    char* koniec = bufor.data() + bufor.size();
+    std::to_chars_result r;
+    if (format == FormatCSV::NAJKROTSZY) {
+        r = std::to_chars(poczatek, koniec, (double)v);
+    } else if (format == FormatCSV::STALY) {
+        r = std::to_chars(poczatek, koniec, v, std::chars_format::fixed, precyzja);
+    } else {
+        char* p = formatuj_ogolny(poczatek, v, precyzja);
+        if (p != nullptr) {
+            uzyte = p - bufor.data();
+            return *this;
+        }
+        r = std::to_chars(poczatek, koniec, v, std::chars_format::general, precyzja);
+    }
+
+    if (r.ec == std::errc()) {
+        uzyte = r.ptr - bufor.data();
+    } else {
+        std::vector<char> duzy(LDBL_MAX_10_EXP + precyzja + 16);
+        r = std::to_chars(duzy.data(), duzy.data() + duzy.size(), v, std::chars_format::fixed, precyzja);
+        tekst(duzy.data(), r.ptr - duzy.data());
+    }
+    return *this;
+}
+
+
+
+static const char HTB_SYGNATURA[8] = {'H', 'E', 'A', 'T', 'B', 'I', 'N', '1'};
+
+static_assert(sizeof(iopack::NaglowekHTB) <= (size_t)iopack::HTB_NAGLOWEK,
+    "nagłówek pliku .htb nie mieści się w zarezerwowanym miejscu");
+
+
+
+static void kopiuj_napis(char* cel, size_t rozmiar, const std::string& napis) {
+    //  obcina napis tak, by zawsze zostało miejsce na kończące zero
+    size_t n = napis.size() < rozmiar - 1 ? napis.size() : rozmiar - 1;
+    memcpy(cel, napis.data(), n);
+    cel[n] = '\0';
+}
+
+
+
+iopack::BinarnyZapis::BinarnyZapis(const std::string& nazwa, const OpisHTB& opis, const long double* X, int N)
+    : plik(nullptr), pozycja(0) {
+    //-------------------------------------------------------------------
+    //  Tworzy plik, rezerwuje miejsce na nagłówek (wypełniany zerami do
+    //  czasu zamknięcia) i zapisuje siatkę X.
+    //-------------------------------------------------------------------
+    memset(&naglowek, 0, sizeof(naglowek));
+    naglowek.wersja = HTB_WERSJA;
+    naglowek.rozmiar_liczby = sizeof(long double);
+    naglowek.cyfry_mantysy = LDBL_MANT_DIG;
+    naglowek.N = N;
+    naglowek.Ts = opis.Ts;
+    naglowek.D = opis.D;
+    naglowek.b = opis.b;
+    naglowek.a = opis.a;
+    naglowek.t_max = opis.t_max;
+    naglowek.h = opis.h;
+    naglowek.dt = opis.dt;
+    naglowek.lambda = opis.lambda;
+    kopiuj_napis(naglowek.metoda, sizeof(naglowek.metoda), opis.metoda);
+    kopiuj_napis(naglowek.kolumna, sizeof(naglowek.kolumna), opis.kolumna);
+    kopiuj_napis(naglowek.prefiks_migawek, sizeof(naglowek.prefiks_migawek), opis.prefiks_migawek);
+    kopiuj_napis(naglowek.plik_bledu, sizeof(naglowek.plik_bledu), opis.plik_bledu);
+
+    plik = fopen(nazwa.c_str(), "wb");
+    if (plik == nullptr) {
+        std::cerr << "Nie można utworzyć pliku " << nazwa << "\n";
+        return;
+    }
+
+    char zera[HTB_NAGLOWEK] = {0};
+    fwrite(zera, 1, HTB_NAGLOWEK, plik);
+    pozycja = HTB_NAGLOWEK;
+    naglowek.off_X = dopisz(X, (size_t)N * sizeof(long double));
+}
+
+
+
+iopack::BinarnyZapis::~BinarnyZapis() {
+    zamknij();
+}
+
+
+
+uint64_t iopack::BinarnyZapis::dopisz(const void* dane, size_t rozmiar) {
+    //  dopisuje blok wyrównany do HTB_WYROWNANIE, zwraca jego położenie w pliku
+    static const char zera[HTB_WYROWNANIE] = {0};
+    size_t reszta = pozycja % HTB_WYROWNANIE;
+    if (reszta != 0) {
+        fwrite(zera, 1, HTB_WYROWNANIE - reszta, plik);
+        pozycja += HTB_WYROWNANIE - reszta;
+    }
+    uint64_t off = pozycja;
+    if (rozmiar > 0) fwrite(dane, 1, rozmiar, plik);
+    pozycja += rozmiar;
+    return off;
+}
+
+
+
+void iopack::BinarnyZapis::dodaj_migawke(long n, long double t, const long double* U, const long double* U_exact) {
+    PROFIL_ZAKRES("io: migawka htb");
+    if (plik == nullptr) return;
+    WpisIndeksuHTB w;
+    memset(&w, 0, sizeof(w));
+    w.n = n;
+    w.t = t;
+    w.off_U = dopisz(U, (size_t)naglowek.N * sizeof(long double));
+    w.off_exact = dopisz(U_exact, (size_t)naglowek.N * sizeof(long double));
+    indeks.push_back(w);
+}
+
+
+
+void iopack::BinarnyZapis::dodaj_blad(long double t, long double err) {
+    bledy.push_back(t);
+    bledy.push_back(err);
+}
+
+
+
+void iopack::BinarnyZapis::zamknij() {
+    //-------------------------------------------------------------------
+    //  Dopisuje błędy i indeks, a na końcu nagłówek z sygnaturą.
+    //-------------------------------------------------------------------
+    if (plik == nullptr) return;
+
+    naglowek.n_bledow = bledy.size() / 2;
+    naglowek.off_bledy = dopisz(bledy.data(), bledy.size() * sizeof(long double));
+    naglowek.n_migawek = indeks.size();
+    naglowek.off_indeks = dopisz(indeks.data(), indeks.size() * sizeof(WpisIndeksuHTB));
+    memcpy(naglowek.sygnatura, HTB_SYGNATURA, sizeof(HTB_SYGNATURA));
+
+    fseek(plik, 0, SEEK_SET);
+    fwrite(&naglowek, sizeof(naglowek), 1, plik);
+    fclose(plik);
+    plik = nullptr;
+}
+
+
+
+iopack::BinarnyOdczyt::~BinarnyOdczyt() {
+    zamknij();
+}
+
+
+
+void iopack::BinarnyOdczyt::zamknij() {
+#if !defined(_WIN32)
+    if (zmapowany) munmap(const_cast<char*>(dane), rozmiar);
+#endif
+    kopia.clear();
+    kopia.shrink_to_fit();
+    zmapowany = false;
+    dane = nullptr;
+    rozmiar = 0;
+    nag = nullptr;
+    wpisy = nullptr;
+}
+
+
+
+bool iopack::BinarnyOdczyt::otworz(const std::string& nazwa) {
+    //-------------------------------------------------------------------
+    //  Mapuje plik tylko do odczytu i sprawdza nagłówek: sygnaturę,
+    //  wersję, format long double oraz czy wszystkie tablice mieszczą
+    //  się w pliku.
+    //-------------------------------------------------------------------
+    zamknij();
+
+#if defined(_WIN32)
+    std::ifstream fin(nazwa, std::ios::binary | std::ios::ate);
+    if (!fin) {
+        std::cerr << "Nie można otworzyć pliku " << nazwa << "\n";
+        return false;
+    }
+    kopia.resize((size_t)fin.tellg());
+    fin.seekg(0);
+    fin.read(kopia.data(), kopia.size());
+    dane = kopia.data();
+    rozmiar = kopia.size();
+#else
+    int fd = open(nazwa.c_str(), O_RDONLY);
+    if (fd < 0) {
+        std::cerr << "Nie można otworzyć pliku " << nazwa << "\n";
+        return false;
+    }
+    struct stat st;
+    if (fstat(fd, &st) != 0 || st.st_size < HTB_NAGLOWEK) {
+        close(fd);
+        std::cerr << "Plik " << nazwa << " nie jest plikiem .htb\n";
+        return false;
+    }
+    void* p = mmap(nullptr, (size_t)st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd);
+    if (p == MAP_FAILED) {
+        std::cerr << "Nie można zmapować pliku " << nazwa << "\n";
+        return false;
+    }
+    dane = static_cast<const char*>(p);
+    rozmiar = (size_t)st.st_size;
+    zmapowany = true;
+#endif
+
+    nag = reinterpret_cast<const NaglowekHTB*>(dane);
+    const char* powod = nullptr;
+    if (rozmiar < (size_t)HTB_NAGLOWEK || memcmp(nag->sygnatura, HTB_SYGNATURA, sizeof(HTB_SYGNATURA)) != 0) {
+        powod = "brak sygnatury (plik niekompletny lub innego typu)";
+    } else if (nag->wersja != (uint32_t)HTB_WERSJA) {
+        powod = "nieobsługiwana wersja formatu";
+    } else if (nag->rozmiar_liczby != sizeof(long double) || nag->cyfry_mantysy != LDBL_MANT_DIG) {
+        powod = "inny format long double niż na tej maszynie";
+    } else {
+        uint64_t wiersz = (uint64_t)nag->N * sizeof(long double);
+        bool ok = nag->N > 0
+            && nag->off_X + wiersz <= rozmiar
+            && nag->off_bledy + nag->n_bledow * 2 * sizeof(long double) <= rozmiar
+            && nag->off_indeks + nag->n_migawek * sizeof(WpisIndeksuHTB) <= rozmiar;
+        if (ok) {
+            wpisy = reinterpret_cast<const WpisIndeksuHTB*>(dane + nag->off_indeks);
+            for (uint64_t k = 0; k < nag->n_migawek && ok; k++) {
+                ok = wpisy[k].off_U + wiersz <= rozmiar && wpisy[k].off_exact + wiersz <= rozmiar;
+            }
+        }
+        if (!ok) powod = "uszkodzony indeks";
+    }
+
+    if (powod != nullptr) {
+        std::cerr << "Plik " << nazwa << ": " << powod << "\n";
+        zamknij();
+        return false;
+    }
+    return true;
+}
+
+
+
+iopack::AsyncWriter::AsyncWriter(const long double* X, int N, const std::string& plik_bledu,
+        const std::string& naglowek_bledu, int pojemnosc)
+    : X(X, X + N), N(N), kolejka(pojemnosc), nazwa_bledu(plik_bledu), naglowek_bledu(naglowek_bledu) {
+    //-------------------------------------------------------------------
+    //  Uruchamia wątek zapisujący. Plik błędów tworzony jest przy
+    //  pierwszym zapisie błędu (nie powstaje w trybie tylko binarnym).
+    //  Siatka X jest kopiowana - tablica przekazana do konstruktora
+    //  może zostać zwolniona wcześniej niż obiekt.
+    //-------------------------------------------------------------------
+    watek = std::thread(&AsyncWriter::petla_zapisu, this);
+}
+
+
+
+void iopack::AsyncWriter::zapis_binarny(const std::string& nazwa, const OpisHTB& opis, bool rowniez_csv) {
+    //-------------------------------------------------------------------
+    //  Włącza zapis do pliku .htb. Wywoływać przed pierwszym komunikatem
+    //  (wątek zapisujący odczytuje te pola dopiero po odebraniu komunikatu,
+    //  a publikacja w kolejce porządkuje dostęp do nich).
+    //-------------------------------------------------------------------
+    this->opis = opis;
+    this->opis.plik_bledu = nazwa_bledu;
+    binarny.reset(new BinarnyZapis(nazwa, this->opis, X.data(), N));
+    csv = rowniez_csv;
+}
+
+
+
+iopack::AsyncWriter::~AsyncWriter() {
+    zakoncz();
+}
+
+
+
+iopack::AsyncWriter::Komunikat* iopack::AsyncWriter::zarezerwuj() {
+    //-------------------------------------------------------------------
+    //  Wolny bufor kolejki; gdy kolejka jest pełna, wątek obliczeniowy
+    //  krótko czeka aktywnie, a potem zasypia do czasu zwolnienia bufora.
+    //-------------------------------------------------------------------
+    for (int spin = 0; spin < IO_SPINS; spin++) {
+        Komunikat* k = kolejka.zarezerwuj();
+        if (k != nullptr) return k;
+        threadpack::cpu_relax();
+    }
+
+    PROFIL_ZAKRES("io: czekanie na kolejke");
+    std::unique_lock<std::mutex> lock(mtx);
+    producent_spi.store(true);
+    cv_miejsce.wait(lock, [&] { return !kolejka.pelna(); });
+    producent_spi.store(false);
+    return kolejka.zarezerwuj();
+}
+
+
+
+void iopack::AsyncWriter::opublikuj() {
+    kolejka.opublikuj();
+    if (konsument_spi.load()) {
+        std::lock_guard<std::mutex> lock(mtx);
+        cv_dane.notify_one();
+    }
+}
+
+
+
+void iopack::AsyncWriter::zapisz_blad(long double t, long double err) {
+    Komunikat* k = zarezerwuj();
+    k->rodzaj = Komunikat::BLAD;
+    k->t = t;
+    k->err = err;
+    opublikuj();
+}
+
+
+
+void iopack::AsyncWriter::zapisz_migawke(const std::string& nazwa, const std::string& naglowek, long double t,
+        const long double* U, const long double* U_exact) {
+    //-------------------------------------------------------------------
+    //  Kopiuje poziom czasowy do bufora kolejki (bufory mają stały
+    //  rozmiar N, więc po pierwszym użyciu nie ma już alokacji pamięci).
+    //
+    //  Argumenty:
+    //      nazwa    - nazwa pliku CSV
+    //      naglowek - pierwszy wiersz pliku (np. "x,U_KMB,U_exact\n")
+    //      t        - poziom czasowy migawki
+    //      U        - wartości numeryczne (N elementów)
+    //      U_exact  - wartości analityczne lub nullptr (liczy wątek zapisujący)
+    //-------------------------------------------------------------------
+    Komunikat* k = zarezerwuj();
+    k->rodzaj = Komunikat::MIGAWKA;
+    k->n = -1;
+    k->t = t;
+    k->nazwa = nazwa;
+    k->naglowek = naglowek;
+    k->U.assign(U, U + N);
+    k->ma_exact = (U_exact != nullptr);
+    if (k->ma_exact) {
+        k->U_exact.assign(U_exact, U_exact + N);
+    }
+    opublikuj();
+}
+
+
+
+void iopack::AsyncWriter::zapisz_migawke(long n, long double t, const long double* U, const long double* U_exact) {
+    //-------------------------------------------------------------------
+    //  Migawka poziomu czasowego n: w pliku .htb (gdy włączony) oraz,
+    //  gdy zapis CSV jest włączony, w pliku
+    //  "<prefiks_migawek><n>iter.csv" z nagłówkiem "x,<kolumna>,U_exact".
+    //-------------------------------------------------------------------
+    Komunikat* k = zarezerwuj();
+    k->rodzaj = Komunikat::MIGAWKA;
+    k->n = n;
+    k->t = t;
+    if (csv) {
+        k->nazwa = opis.prefiks_migawek + std::to_string(n) + "iter.csv";
+        k->naglowek = "x," + opis.kolumna + ",U_exact\n";
+    } else {
+        k->nazwa.clear();
+    }
+    k->U.assign(U, U + N);
+    k->ma_exact = (U_exact != nullptr);
+    if (k->ma_exact) {
+        k->U_exact.assign(U_exact, U_exact + N);
+    }
+    opublikuj();
+}
+
+
+
+void iopack::AsyncWriter::zapis_pola(const std::string& nazwa, double dokladnosc) {
+    //  jak zapis_binarny - wywoływać przed pierwszym komunikatem
+    pole.reset(new polepack::ZapisPola(nazwa, X.data(), N, dokladnosc));
+}
+
+
+
+void iopack::AsyncWriter::zapisz_poziom(long double t, const long double* U) {
+    Komunikat* k = zarezerwuj();
+    k->rodzaj = Komunikat::POZIOM;
+    k->t = t;
+    k->U.assign(U, U + N);
+    opublikuj();
+}
+
+
+
+void iopack::AsyncWriter::zakoncz() {
+    //-------------------------------------------------------------------
+    //  Wysyła komunikat końca, czeka na zapisanie wszystkich wcześniejszych
+    //  komunikatów i zamyka plik błędów. Kolejne wywołania nic nie robią.
+    //-------------------------------------------------------------------
+    PROFIL_ZAKRES("io: zakoncz (oczekiwanie)");
+    if (zakonczony) return;
+    zakonczony = true;
+
+    Komunikat* k = zarezerwuj();
+    k->rodzaj = Komunikat::KONIEC;
+    opublikuj();
+
+    watek.join();
+    plik_bledu.zamknij();
+    if (binarny) binarny->zamknij();
+    if (pole) pole->zamknij();
+}
+
+
+
+void iopack::AsyncWriter::zapisz_plik(const Komunikat& k) {
+    PROFIL_ZAKRES("io: migawka CSV");
+    ZapisCSV fout(k.nazwa);
+    fout.tekst(k.naglowek);
+    for (int i = 0; i < N; i++) {
+        fout.wiersz(X[i], k.U[i], k.U_exact[i]);
+    }
+}
+
+
+
+void iopack::AsyncWriter::petla_zapisu() {
+    //-------------------------------------------------------------------
+    //  Wątek zapisujący: odbiera komunikaty w kolejności wysłania.
+    //  Rozwiązanie analityczne (gdy nie zostało przekazane) liczone jest
+    //  tutaj, z własną jednowątkową pulą - wspólna pula jest w tym czasie
+    //  używana przez wątek obliczeniowy.
+    //-------------------------------------------------------------------
+    threadpack::ThreadPool pula(1);
+    utilspack::RozwiazanieAnalityczne analityczne(X.data(), N, &pula);
+
+    for (;;) {
+        Komunikat* k = nullptr;
+        for (int spin = 0; spin < IO_SPINS && k == nullptr; spin++) {
+            k = kolejka.pobierz();
+            if (k == nullptr) threadpack::cpu_relax();
+        }
+        if (k == nullptr) {
+            std::unique_lock<std::mutex> lock(mtx);
+            konsument_spi.store(true);
+            cv_dane.wait(lock, [&] { return !kolejka.pusta(); });
+            konsument_spi.store(false);
+            lock.unlock();
+            k = kolejka.pobierz();
+        }
+
+        bool koniec = (k->rodzaj == Komunikat::KONIEC);
+        if (k->rodzaj == Komunikat::BLAD) {
+            PROFIL_ZAKRES("io: blad");
+            if (binarny) binarny->dodaj_blad(k->t, k->err);
+            if (csv) {
+                if (!plik_bledu.otwarty()) {
+                    plik_bledu.otworz(nazwa_bledu);
+                    plik_bledu.tekst(naglowek_bledu);
+                }
+                plik_bledu.wiersz(k->t, k->err);
+            }
+        } else if (k->rodzaj == Komunikat::MIGAWKA) {
+            if (!k->ma_exact) {
+                PROFIL_ZAKRES("io: migawka analityczne");
+                k->U_exact.resize(N);
+                analityczne.ustaw_czas(k->t);
+                analityczne.wartosci(k->U_exact.data());
+            }
+            if (binarny && k->n >= 0) binarny->dodaj_migawke(k->n, k->t, k->U.data(), k->U_exact.data());
+            if (!k->nazwa.empty()) zapisz_plik(*k);
+        } else if (k->rodzaj == Komunikat::POZIOM) {
+            PROFIL_ZAKRES("io: poziom pola");
+            if (pole) pole->dodaj_poziom(k->t, k->U.data());
+        }
+
+        kolejka.zwolnij();
+        if (producent_spi.load()) {
+            std::lock_guard<std::mutex> lock(mtx);
+            cv_miejsce.notify_one();
+        }
+        if (koniec) return;
+    }
+}
@@ -0,0 +1,364 @@
+#ifndef __io_h
+#define __io_h
+
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <cstdio>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+#include "POLE.h"
+
+//----------------------------------------------------------------------
+// Pakiet zapisu wyników w tle. Wątek obliczeniowy jedynie kopiuje
+// bieżący poziom czasowy do wolnego bufora kolejki i liczy dalej,
+// a formatowanie liczb, ewentualne obliczenie rozwiązania analitycznego
+// oraz operacje na plikach wykonuje osobny wątek zapisujący.
+//----------------------------------------------------------------------
+namespace iopack{
+
+    //------------------------------------------------------------------
+    // Bezblokadowa kolejka cykliczna jeden producent / jeden konsument
+    // o stałej liczbie elementów. Elementy nie są tworzone ani niszczone
+    // przy przekazywaniu - producent wypełnia wolne miejsce
+    // (zarezerwuj + opublikuj), a konsument je odczytuje (pobierz +
+    // zwolnij), więc bufory wewnątrz elementów są używane wielokrotnie.
+    //------------------------------------------------------------------
+    template <typename T>
+    class SPSCRing {
+    public:
+        explicit SPSCRing(int capacity) : slots(capacity < 1 ? 1 : capacity) {}
+
+        SPSCRing(const SPSCRing&) = delete;
+        SPSCRing& operator=(const SPSCRing&) = delete;
+
+        int capacity() const { return (int)slots.size(); }
+
+        //  Producent: wolne miejsce do wypełnienia (nullptr gdy kolejka pełna)
+        T* zarezerwuj() {
+            unsigned long t = tail.load(std::memory_order_relaxed);
+            if (t - head.load(std::memory_order_acquire) == slots.size()) return nullptr;
+            return &slots[t % slots.size()];
+        }
+
+        //  Producent: udostępnienie wypełnionego miejsca konsumentowi
+        void opublikuj() {
+            tail.store(tail.load(std::memory_order_relaxed) + 1, std::memory_order_seq_cst);
+        }
+
+        //  Konsument: najstarszy opublikowany element (nullptr gdy kolejka pusta)
+        T* pobierz() {
+            unsigned long h = head.load(std::memory_order_relaxed);
+            if (h == tail.load(std::memory_order_acquire)) return nullptr;
+            return &slots[h % slots.size()];
+        }
+
+        //  Konsument: zwrócenie odczytanego miejsca producentowi
+        void zwolnij() {
+            head.store(head.load(std::memory_order_relaxed) + 1, std::memory_order_seq_cst);
+        }
+
+        bool pusta() const {
+            return head.load(std::memory_order_seq_cst) == tail.load(std::memory_order_seq_cst);
+        }
+
+        bool pelna() const {
+            return tail.load(std::memory_order_seq_cst) - head.load(std::memory_order_seq_cst) == slots.size();
+        }
+
+    private:
+        std::vector<T> slots;
+        alignas(64) std::atomic<unsigned long> head{0};     //  zapisywany tylko przez konsumenta
+        alignas(64) std::atomic<unsigned long> tail{0};     //  zapisywany tylko przez producenta
+    };
+
+
+    //------------------------------------------------------------------
+    // Binarny format wyników (.htb). Układ pliku:
+    //  - nagłówek NaglowekHTB (HTB_NAGLOWEK bajtów): siatka, metoda,
+    //    parametry fizyczne oraz położenie pozostałych części pliku,
+    //  - tablica X (N liczb long double),
+    //  - migawki: dla każdej kolejno U i U_exact (po N liczb),
+    //  - tablica błędów: pary (t, e_max) dla kolejnych poziomów czasowych,
+    //  - indeks migawek: WpisIndeksuHTB dla każdej migawki.
+    // Wszystkie tablice zaczynają się na granicy HTB_WYROWNANIE bajtów, więc
+    // po zmapowaniu pliku (BinarnyOdczyt) można z nich korzystać bezpośrednio.
+    // Liczby zapisywane są w formacie maszyny (long double, kolejność bajtów);
+    // nagłówek zawiera rozmiar i liczbę cyfr mantysy do weryfikacji.
+    // Sygnatura zapisywana jest dopiero przy zamknięciu pliku - plik
+    // z przerwanego obliczenia nie zostanie odczytany.
+    //------------------------------------------------------------------
+    const int HTB_WERSJA = 1;
+    const int HTB_NAGLOWEK = 512;
+    const int HTB_WYROWNANIE = 64;
+
+    struct NaglowekHTB {
+        char     sygnatura[8];          //  "HEATBIN1"
+        uint32_t wersja;
+        uint32_t rozmiar_liczby;        //  sizeof(long double)
+        uint32_t cyfry_mantysy;         //  LDBL_MANT_DIG
+        int32_t  N;                     //  liczba węzłów siatki przestrzennej
+        int32_t  Ts;                    //  liczba węzłów siatki czasowej
+        uint32_t zarezerwowane;
+        uint64_t off_X;
+        uint64_t off_bledy;
+        uint64_t n_bledow;
+        uint64_t off_indeks;
+        uint64_t n_migawek;
+        long double D, b, a, t_max, h, dt, lambda;
+        char     metoda[32];            //  np. "KMB"
+        char     kolumna[32];           //  nazwa kolumny w CSV, np. "U_KMB"
+        char     prefiks_migawek[128];  //  np. "wyniki/KMB/KMBresults" (+ n + "iter.csv")
+        char     plik_bledu[128];       //  np. "wyniki/KMB/KMB_maxerror_vs_time.csv"
+    };
+
+    struct WpisIndeksuHTB {
+        int64_t  n;                     //  numer poziomu czasowego
+        uint64_t off_U;
+        uint64_t off_exact;
+        uint64_t zarezerwowane;
+        long double t;
+    };
+
+    //  Opis obliczenia zapisywany w nagłówku
+    struct OpisHTB {
+        std::string metoda;
+        std::string kolumna;
+        std::string prefiks_migawek;
+        std::string plik_bledu;
+        long double D = 0, b = 0, a = 0, t_max = 0, h = 0, dt = 0, lambda = 0;
+        int Ts = 0;
+    };
+
+
+    //------------------------------------------------------------------
+    // Zapis pliku .htb: migawki dopisywane są od razu (fwrite całych
+    // tablic), błędy i indeks gromadzone w pamięci i zapisywane wraz
+    // z nagłówkiem w zamknij().
+    //------------------------------------------------------------------
+    class BinarnyZapis {
+    public:
+        BinarnyZapis(const std::string& nazwa, const OpisHTB& opis, const long double* X, int N);
+        ~BinarnyZapis();
+
+        BinarnyZapis(const BinarnyZapis&) = delete;
+        BinarnyZapis& operator=(const BinarnyZapis&) = delete;
+
+        bool otwarty() const { return plik != nullptr; }
+
+        void dodaj_migawke(long n, long double t, const long double* U, const long double* U_exact);
+        void dodaj_blad(long double t, long double err);
+        void zamknij();
+
+    private:
+        uint64_t dopisz(const void* dane, size_t rozmiar);
+
+        FILE* plik;
+        NaglowekHTB naglowek;
+        uint64_t pozycja;
+        std::vector<long double> bledy;
+        std::vector<WpisIndeksuHTB> indeks;
+    };
+
+
+    //------------------------------------------------------------------
+    // Odczyt pliku .htb przez mapowanie do pamięci (bez kopiowania:
+    // wskaźniki X(), U(k), U_exact(k), bledy() wskazują na zmapowany plik).
+    //------------------------------------------------------------------
+    class BinarnyOdczyt {
+    public:
+        BinarnyOdczyt() = default;
+        ~BinarnyOdczyt();
+
+        BinarnyOdczyt(const BinarnyOdczyt&) = delete;
+        BinarnyOdczyt& operator=(const BinarnyOdczyt&) = delete;
+
+        //  false (z komunikatem na stderr), gdy plik nie istnieje lub ma zły format
+        bool otworz(const std::string& nazwa);
+        void zamknij();
+
+        const NaglowekHTB& naglowek() const { return *nag; }
+        int N() const { return nag->N; }
+        const long double* X() const { return tablica(nag->off_X); }
+
+        int liczba_migawek() const { return (int)nag->n_migawek; }
+        long n(int k) const { return (long)wpisy[k].n; }
+        long double t(int k) const { return wpisy[k].t; }
+        const long double* U(int k) const { return tablica(wpisy[k].off_U); }
+        const long double* U_exact(int k) const { return tablica(wpisy[k].off_exact); }
+
+        //  pary (t, e_max): bledy()[2*j], bledy()[2*j+1]
+        int liczba_bledow() const { return (int)nag->n_bledow; }
+        const long double* bledy() const { return tablica(nag->off_bledy); }
+
+    private:
+        const long double* tablica(uint64_t off) const {
+            return reinterpret_cast<const long double*>(dane + off);
+        }
+
+        const char* dane = nullptr;
+        size_t rozmiar = 0;
+        const NaglowekHTB* nag = nullptr;
+        const WpisIndeksuHTB* wpisy = nullptr;
+        std::vector<char> kopia;        //  bez mmap: zawartość pliku wczytana do pamięci
+        bool zmapowany = false;
+    };
+
+
+    //------------------------------------------------------------------
+    // Szybki zapis plików CSV: liczby formatowane przez std::to_chars
+    // (bez strumieni i ustawień locale) do dużego bufora, który trafia
+    // do pliku jednym fwrite po zapełnieniu. Formaty liczb:
+    //  - OGOLNY    - jak domyślny std::ostream << (np. precyzja 6: "0.960764"),
+    //  - STALY     - jak std::fixed << std::setprecision(precyzja),
+    //  - NAJKROTSZY - najkrótszy zapis double odtwarzający dokładnie wartość.
+    //------------------------------------------------------------------
+    enum class FormatCSV { OGOLNY, STALY, NAJKROTSZY };
+
+    const size_t CSV_BUFOR = 1 << 20;
+
+    class ZapisCSV {
+    public:
+        ZapisCSV() = default;
+        explicit ZapisCSV(const std::string& nazwa, FormatCSV format = FormatCSV::OGOLNY, int precyzja = 6);
+        ~ZapisCSV();
+
+        ZapisCSV(const ZapisCSV&) = delete;
+        ZapisCSV& operator=(const ZapisCSV&) = delete;
+
+        bool otworz(const std::string& nazwa);
+        bool otwarty() const { return plik != nullptr; }
+        void zamknij();
+
+        void ustaw_format(FormatCSV format, int precyzja) { this->format = format; this->precyzja = precyzja; }
+
+        ZapisCSV& tekst(const std::string& s) { return tekst(s.data(), s.size()); }
+        ZapisCSV& tekst(const char* s, size_t n);
+        ZapisCSV& znak(char c) {
+            if (uzyte == bufor.size()) {
+                oproznij();
+                if (bufor.empty()) return *this;    //  plik nie był otwierany
+            }
+            bufor[uzyte++] = c;
+            return *this;
+        }
+        ZapisCSV& liczba(long double v);
+
+        //  wiersze "a,b\n" oraz "a,b,c\n"
+        void wiersz(long double a, long double b) {
+            liczba(a).znak(',').liczba(b).znak('\n');
+        }
+        void wiersz(long double a, long double b, long double c) {
+            liczba(a).znak(',').liczba(b).znak(',').liczba(c).znak('\n');
+        }
+
+        void oproznij();
+
+    private:
+        FILE* plik = nullptr;
+        std::vector<char> bufor;
+        size_t uzyte = 0;
+        FormatCSV format = FormatCSV::OGOLNY;
+        int precyzja = 6;
+    };
+
+
+    //  domyślna liczba buforów w kolejce zapisu
+    const int ASYNC_RING_SIZE = 64;
+
+    //------------------------------------------------------------------
+    // Zapis wyników w tle:
+    //  - zapisz_blad(t, e)  - dopisuje wiersz "t,e" do pliku błędów,
+    //  - zapisz_migawke(..) - kopiuje U (i ewentualnie U_exact) do bufora;
+    //    wątek zapisujący tworzy plik CSV "x,U,U_exact" dla tej migawki.
+    //    Gdy U_exact == nullptr, rozwiązanie analityczne dla czasu t liczy
+    //    wątek zapisujący.
+    // Formatowanie liczb (ZapisCSV, format OGOLNY) jest takie samo jak przy
+    // zapisie przez std::ofstream << w pętli czasowej. Gdy kolejka jest pełna, wątek
+    // obliczeniowy czeka na zwolnienie bufora. zakoncz() (lub destruktor)
+    // czeka na zapisanie wszystkich danych i zamyka pliki.
+    //
+    // Po wywołaniu zapis_binarny(..) (przed pierwszym komunikatem) błędy
+    // i migawki numerowane (zapisz_migawke(n, ..)) trafiają do pliku .htb;
+    // pliki CSV powstają wtedy tylko gdy rowniez_csv == true (można je
+    // odtworzyć z pliku .htb programem konwerter_htb).
+    //
+    // Po wywołaniu zapis_pola(..) kolejne poziomy czasowe przekazane przez
+    // zapisz_poziom(t, U) trafiają do skompresowanego pliku całego pola
+    // (polepack::ZapisPola); kompresja odbywa się w wątku zapisującym.
+    //------------------------------------------------------------------
+    class AsyncWriter {
+    public:
+        AsyncWriter(const long double* X, int N, const std::string& plik_bledu,
+            const std::string& naglowek_bledu, int pojemnosc = ASYNC_RING_SIZE);
+        ~AsyncWriter();
+
+        AsyncWriter(const AsyncWriter&) = delete;
+        AsyncWriter& operator=(const AsyncWriter&) = delete;
+
+        void zapisz_blad(long double t, long double err);
+        void zapisz_migawke(const std::string& nazwa, const std::string& naglowek, long double t,
+            const long double* U, const long double* U_exact = nullptr);
+        //  nazwa pliku i nagłówek CSV wg opisu przekazanego do zapis_binarny
+        void zapisz_migawke(long n, long double t, const long double* U, const long double* U_exact = nullptr);
+
+        void zapis_binarny(const std::string& nazwa, const OpisHTB& opis, bool rowniez_csv = false);
+
+        //  dokladnosc: maksymalny błąd bezwzględny zapisu pola (0 - bezstratnie)
+        void zapis_pola(const std::string& nazwa, double dokladnosc = 0.0);
+        //  kolejny poziom czasowy pola (poziomy podawane po kolei od t = 0)
+        void zapisz_poziom(long double t, const long double* U);
+
+        void zakoncz();
+
+    private:
+        struct Komunikat {
+            enum Rodzaj { BLAD, MIGAWKA, POZIOM, KONIEC } rodzaj;
+            long n;
+            long double t;
+            long double err;
+            std::string nazwa;
+            std::string naglowek;
+            bool ma_exact;
+            std::vector<long double> U;
+            std::vector<long double> U_exact;
+        };
+
+        Komunikat* zarezerwuj();
+        void opublikuj();
+        void petla_zapisu();
+        void zapisz_plik(const Komunikat& k);
+
+        std::vector<long double> X;
+        int N;
+
+        SPSCRing<Komunikat> kolejka;
+        ZapisCSV plik_bledu;                //  otwierany przy pierwszym zapisie błędu
+        std::string nazwa_bledu;
+        std::string naglowek_bledu;
+
+        //  zapis binarny (ustawiany przed pierwszym komunikatem)
+        std::unique_ptr<BinarnyZapis> binarny;
+        OpisHTB opis;
+        bool csv = true;
+
+        //  zapis całego pola (ustawiany przed pierwszym komunikatem)
+        std::unique_ptr<polepack::ZapisPola> pole;
+
+        //  usypianie wątków, gdy kolejka jest pusta (konsument) lub pełna (producent)
+        std::mutex mtx;
+        std::condition_variable cv_dane;
+        std::condition_variable cv_miejsce;
+        std::atomic<bool> konsument_spi{false};
+        std::atomic<bool> producent_spi{false};
+
+        bool zakonczony = false;
+        std::thread watek;
+    };
+
+}
+
+#endif
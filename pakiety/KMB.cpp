@@ -0,0 +1,1041 @@
+#include <chrono>
+#include <cmath>
+#include <cstring>
+#include <ostream>
+
+#include "KMB.h"
+#include "PROFIL.h"
+
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+    #include <immintrin.h>
+    #define KMB_X86_SIMD
+#endif
+
+//  Jądra skalarne nie są wstawiane do funkcji z target("avx512f") - tam
+//  kompilator mógłby złączyć mnożenie i dodawanie w FMA i "ogon" wersji
+//  wektorowej przestałby być bitowo zgodny z wersją skalarną.
+#if defined(__GNUC__)
+    #define KMB_NOINLINE __attribute__((noinline))
+#else
+    #define KMB_NOINLINE
+#endif
+
+
+
+void kmbpack::oblicz_nastepny_poziom_czasowy_KMB(const long double* U_old, long double* U_new, long double lambda, const int N) {
+    //-------------------------------------------------------------------
+    // Funkcja oblicza przybliżoną wartość funkcji na kolejnym poziomie czasowym
+    // Warunki brzegowe: U_new[0]=U_new[N-1]=0 (przyjmujemy, że już są ustawione)
+    
+    //  Argumenty:
+    //  U_old - Tablica wartości funkcji dla bieżącego poziomu czasu
+    //  U_new - Tablica wartości funkcji dla nowego poziomu czasu
+    //  lambda - parametr lambda: D*dt/h^2
+    //  N - liczba węzłów siatki przestrzennej
+
+    //  Zwraca: Nic -> operacje na wskaźnikach
+    //-------------------------------------------------------------------
+    PROFIL_ZAKRES("KMB: krok");
+    
+    // warunki brzegowe
+    U_new[0] = 0.0L;
+    U_new[N-1] = 0.0L;
+    
+
+    for (int i = 1; i + 1 < N; ++i) {
+        U_new[i] = U_old[i] + lambda * (U_old[i + 1] - 2.0L * U_old[i] + U_old[i - 1]);
+        //  Jest to przekształcony wzór KMB
+    }
+
+}
+
+
+
+template <typename T>
+KMB_NOINLINE static void kmb_scalar(const T* U_old, T* U_new, T lambda, int lo, int hi) {
+    //  Skalarna wersja jądra dla węzłów lo..hi-1 (także "ogon" wersji wektorowych)
+    for (int i = lo; i < hi; ++i) {
+        U_new[i] = U_old[i] + lambda * (U_old[i + 1] - T(2) * U_old[i] + U_old[i - 1]);
+    }
+}
+
+template <typename T>
+KMB_NOINLINE static void kmb_scalar_err(const T* U_old, T* U_new, T lambda, const T* U_ref, int lo, int hi, T& err) {
+    //  Jak kmb_scalar, dodatkowo err = max(err, |U_old[i] - U_ref[i]|)
+    for (int i = lo; i < hi; ++i) {
+        U_new[i] = U_old[i] + lambda * (U_old[i + 1] - T(2) * U_old[i] + U_old[i - 1]);
+        T e = precyzjapack::modul(U_old[i] - U_ref[i]);
+        precyzjapack::max_bledu(err, e);
+    }
+}
+
+
+
+#ifdef KMB_X86_SIMD
+//----------------------------------------------------------------------
+// Jądra wektorowe. Kolejność działań jest taka sama jak w wersji
+// skalarnej: (U[i+1] - 2U[i]) + U[i-1], potem mnożenie i dodawanie
+// (bez FMA), więc wyniki są identyczne bitowo. AVX-512F obejmuje FMA,
+// dlatego jądra AVX-512 kompilowane są z fp-contract=off - inaczej GCC
+// łączy c + lambda*s w jeden rozkaz vfmadd.
+//----------------------------------------------------------------------
+
+__attribute__((target("avx2")))
+static void kmb_avx2(const double* U_old, double* U_new, double lambda, int lo, int hi) {
+    const __m256d vl  = _mm256_set1_pd(lambda);
+    const __m256d two = _mm256_set1_pd(2.0);
+    int i = lo;
+    for (; i + 4 <= hi; i += 4) {
+        __m256d c = _mm256_loadu_pd(U_old + i);
+        __m256d l = _mm256_loadu_pd(U_old + i - 1);
+        __m256d r = _mm256_loadu_pd(U_old + i + 1);
+        __m256d s = _mm256_add_pd(_mm256_sub_pd(r, _mm256_mul_pd(two, c)), l);
+        _mm256_storeu_pd(U_new + i, _mm256_add_pd(c, _mm256_mul_pd(vl, s)));
+    }
+    kmb_scalar(U_old, U_new, lambda, i, hi);
+}
+
+__attribute__((target("avx2")))
+static void kmb_avx2(const float* U_old, float* U_new, float lambda, int lo, int hi) {
+    const __m256 vl  = _mm256_set1_ps(lambda);
+    const __m256 two = _mm256_set1_ps(2.0f);
+    int i = lo;
+    for (; i + 8 <= hi; i += 8) {
+        __m256 c = _mm256_loadu_ps(U_old + i);
+        __m256 l = _mm256_loadu_ps(U_old + i - 1);
+        __m256 r = _mm256_loadu_ps(U_old + i + 1);
+        __m256 s = _mm256_add_ps(_mm256_sub_ps(r, _mm256_mul_ps(two, c)), l);
+        _mm256_storeu_ps(U_new + i, _mm256_add_ps(c, _mm256_mul_ps(vl, s)));
+    }
+    kmb_scalar(U_old, U_new, lambda, i, hi);
+}
+
+__attribute__((target("avx512f"), optimize("fp-contract=off")))
+static void kmb_avx512(const double* U_old, double* U_new, double lambda, int lo, int hi) {
+    const __m512d vl  = _mm512_set1_pd(lambda);
+    const __m512d two = _mm512_set1_pd(2.0);
+    int i = lo;
+    for (; i + 8 <= hi; i += 8) {
+        __m512d c = _mm512_loadu_pd(U_old + i);
+        __m512d l = _mm512_loadu_pd(U_old + i - 1);
+        __m512d r = _mm512_loadu_pd(U_old + i + 1);
+        __m512d s = _mm512_add_pd(_mm512_sub_pd(r, _mm512_mul_pd(two, c)), l);
+        _mm512_storeu_pd(U_new + i, _mm512_add_pd(c, _mm512_mul_pd(vl, s)));
+    }
+    kmb_scalar(U_old, U_new, lambda, i, hi);
+}
+
+__attribute__((target("avx512f"), optimize("fp-contract=off")))
+static void kmb_avx512(const float* U_old, float* U_new, float lambda, int lo, int hi) {
+    const __m512 vl  = _mm512_set1_ps(lambda);
+    const __m512 two = _mm512_set1_ps(2.0f);
+    int i = lo;
+    for (; i + 16 <= hi; i += 16) {
+        __m512 c = _mm512_loadu_ps(U_old + i);
+        __m512 l = _mm512_loadu_ps(U_old + i - 1);
+        __m512 r = _mm512_loadu_ps(U_old + i + 1);
+        __m512 s = _mm512_add_ps(_mm512_sub_ps(r, _mm512_mul_ps(two, c)), l);
+        _mm512_storeu_ps(U_new + i, _mm512_add_ps(c, _mm512_mul_ps(vl, s)));
+    }
+    kmb_scalar(U_old, U_new, lambda, i, hi);
+}
+
+//----------------------------------------------------------------------
+// Jądra wektorowe z wyznaczaniem błędu: maksimum |U_old - U_ref| zbierane
+// jest w rejestrze i redukowane po zakończeniu pętli. Jak w wersji
+// skalarnej (precyzjapack::max_bledu) NaN w e trafia do acc i w nim
+// pozostaje: e wybierane jest, gdy e > acc (porównanie uporządkowane -
+// fałszywe dla NaN w acc) albo gdy e jest NaN.
+//----------------------------------------------------------------------
+
+__attribute__((target("avx2")))
+static void kmb_avx2_err(const double* U_old, double* U_new, double lambda, const double* U_ref,
+        int lo, int hi, double& err) {
+    const __m256d vl   = _mm256_set1_pd(lambda);
+    const __m256d two  = _mm256_set1_pd(2.0);
+    const __m256d sign = _mm256_set1_pd(-0.0);
+    __m256d acc = _mm256_set1_pd(err);
+    int i = lo;
+    for (; i + 4 <= hi; i += 4) {
+        __m256d c = _mm256_loadu_pd(U_old + i);
+        __m256d l = _mm256_loadu_pd(U_old + i - 1);
+        __m256d r = _mm256_loadu_pd(U_old + i + 1);
+        __m256d s = _mm256_add_pd(_mm256_sub_pd(r, _mm256_mul_pd(two, c)), l);
+        _mm256_storeu_pd(U_new + i, _mm256_add_pd(c, _mm256_mul_pd(vl, s)));
+        __m256d e = _mm256_andnot_pd(sign, _mm256_sub_pd(c, _mm256_loadu_pd(U_ref + i)));
+        __m256d wieksze = _mm256_or_pd(_mm256_cmp_pd(e, acc, _CMP_GT_OQ), _mm256_cmp_pd(e, e, _CMP_UNORD_Q));
+        acc = _mm256_blendv_pd(acc, e, wieksze);
+    }
+    double lanes[4];
+    _mm256_storeu_pd(lanes, acc);
+    for (int j = 0; j < 4; j++) {
+        precyzjapack::max_bledu(err, lanes[j]);
+    }
+    kmb_scalar_err(U_old, U_new, lambda, U_ref, i, hi, err);
+}
+
+__attribute__((target("avx2")))
+static void kmb_avx2_err(const float* U_old, float* U_new, float lambda, const float* U_ref,
+        int lo, int hi, float& err) {
+    const __m256 vl   = _mm256_set1_ps(lambda);
+    const __m256 two  = _mm256_set1_ps(2.0f);
+    const __m256 sign = _mm256_set1_ps(-0.0f);
+    __m256 acc = _mm256_set1_ps(err);
+    int i = lo;
+    for (; i + 8 <= hi; i += 8) {
+        __m256 c = _mm256_loadu_ps(U_old + i);
+        __m256 l = _mm256_loadu_ps(U_old + i - 1);
+        __m256 r = _mm256_loadu_ps(U_old + i + 1);
+        __m256 s = _mm256_add_ps(_mm256_sub_ps(r, _mm256_mul_ps(two, c)), l);
+        _mm256_storeu_ps(U_new + i, _mm256_add_ps(c, _mm256_mul_ps(vl, s)));
+        __m256 e = _mm256_andnot_ps(sign, _mm256_sub_ps(c, _mm256_loadu_ps(U_ref + i)));
+        __m256 wieksze = _mm256_or_ps(_mm256_cmp_ps(e, acc, _CMP_GT_OQ), _mm256_cmp_ps(e, e, _CMP_UNORD_Q));
+        acc = _mm256_blendv_ps(acc, e, wieksze);
+    }
+    float lanes[8];
+    _mm256_storeu_ps(lanes, acc);
+    for (int j = 0; j < 8; j++) {
+        precyzjapack::max_bledu(err, lanes[j]);
+    }
+    kmb_scalar_err(U_old, U_new, lambda, U_ref, i, hi, err);
+}
+
+__attribute__((target("avx512f"), optimize("fp-contract=off")))
+static void kmb_avx512_err(const double* U_old, double* U_new, double lambda, const double* U_ref,
+        int lo, int hi, double& err) {
+    const __m512d vl  = _mm512_set1_pd(lambda);
+    const __m512d two = _mm512_set1_pd(2.0);
+    __m512d acc = _mm512_set1_pd(err);
+    int i = lo;
+    for (; i + 8 <= hi; i += 8) {
+        __m512d c = _mm512_loadu_pd(U_old + i);
+        __m512d l = _mm512_loadu_pd(U_old + i - 1);
+        __m512d r = _mm512_loadu_pd(U_old + i + 1);
+        __m512d s = _mm512_add_pd(_mm512_sub_pd(r, _mm512_mul_pd(two, c)), l);
+        _mm512_storeu_pd(U_new + i, _mm512_add_pd(c, _mm512_mul_pd(vl, s)));
+        __m512d e = _mm512_abs_pd(_mm512_sub_pd(c, _mm512_loadu_pd(U_ref + i)));
+        __mmask8 wieksze = _mm512_cmp_pd_mask(e, acc, _CMP_GT_OQ) | _mm512_cmp_pd_mask(e, e, _CMP_UNORD_Q);
+        acc = _mm512_mask_mov_pd(acc, wieksze, e);
+    }
+    double lanes[8];
+    _mm512_storeu_pd(lanes, acc);
+    for (int j = 0; j < 8; j++) {
+        precyzjapack::max_bledu(err, lanes[j]);
+    }
+    kmb_scalar_err(U_old, U_new, lambda, U_ref, i, hi, err);
+}
+
+__attribute__((target("avx512f"), optimize("fp-contract=off")))
+static void kmb_avx512_err(const float* U_old, float* U_new, float lambda, const float* U_ref,
+        int lo, int hi, float& err) {
+    const __m512 vl  = _mm512_set1_ps(lambda);
+    const __m512 two = _mm512_set1_ps(2.0f);
+    __m512 acc = _mm512_set1_ps(err);
+    int i = lo;
+    for (; i + 16 <= hi; i += 16) {
+        __m512 c = _mm512_loadu_ps(U_old + i);
+        __m512 l = _mm512_loadu_ps(U_old + i - 1);
+        __m512 r = _mm512_loadu_ps(U_old + i + 1);
+        __m512 s = _mm512_add_ps(_mm512_sub_ps(r, _mm512_mul_ps(two, c)), l);
+        _mm512_storeu_ps(U_new + i, _mm512_add_ps(c, _mm512_mul_ps(vl, s)));
+        __m512 e = _mm512_abs_ps(_mm512_sub_ps(c, _mm512_loadu_ps(U_ref + i)));
+        __mmask16 wieksze = _mm512_cmp_ps_mask(e, acc, _CMP_GT_OQ) | _mm512_cmp_ps_mask(e, e, _CMP_UNORD_Q);
+        acc = _mm512_mask_mov_ps(acc, wieksze, e);
+    }
+    float lanes[16];
+    _mm512_storeu_ps(lanes, acc);
+    for (int j = 0; j < 16; j++) {
+        precyzjapack::max_bledu(err, lanes[j]);
+    }
+    kmb_scalar_err(U_old, U_new, lambda, U_ref, i, hi, err);
+}
+
+
+
+//----------------------------------------------------------------------
+// Jądra double-double (ddpack::dd). Działania z DD.h zapisane są raz,
+// jako szablony na wektorach GCC (4 lub 8 liczb double), wstawiane do
+// funkcji z target("avx2") / target("avx512f"). Tablice dd (hi, lo)
+// rozdzielane są przy odczycie na wektor części hi i wektor części lo.
+// Błąd iloczynu w two_prod liczony jest jednym rozkazem FMA (AVX-512,
+// AVX2 + FMA) albo algorytmem Dekkera (AVX2 bez FMA) - w obu przypadkach
+// dokładnie, jak w DD.h. Poza tym kontrakcja do FMA jest wyłączona, więc
+// wynik jest identyczny bitowo z wersją skalarną.
+//----------------------------------------------------------------------
+typedef double v4d __attribute__((vector_size(32)));
+typedef double v8d __attribute__((vector_size(64)));
+typedef long long v4i __attribute__((vector_size(32)));
+typedef long long v8i __attribute__((vector_size(64)));
+
+template <typename V> struct ddv { V hi, lo; };
+
+#define KMB_DD_INLINE __attribute__((always_inline)) static inline
+
+KMB_DD_INLINE void ddv_load(const ddpack::dd* p, ddv<v4d>& x) {
+    //  p[0..3] -> hi = (h0, h1, h2, h3), lo = (l0, l1, l2, l3)
+    v4d a, b;
+    std::memcpy(&a, p, sizeof(a));
+    std::memcpy(&b, p + 2, sizeof(b));
+    x.hi = __builtin_shuffle(a, b, v4i{0, 2, 4, 6});
+    x.lo = __builtin_shuffle(a, b, v4i{1, 3, 5, 7});
+}
+
+KMB_DD_INLINE void ddv_store(ddpack::dd* p, const ddv<v4d>& x) {
+    v4d a = __builtin_shuffle(x.hi, x.lo, v4i{0, 4, 1, 5});
+    v4d b = __builtin_shuffle(x.hi, x.lo, v4i{2, 6, 3, 7});
+    std::memcpy(p, &a, sizeof(a));
+    std::memcpy(p + 2, &b, sizeof(b));
+}
+
+KMB_DD_INLINE void ddv_load(const ddpack::dd* p, ddv<v8d>& x) {
+    v8d a, b;
+    std::memcpy(&a, p, sizeof(a));
+    std::memcpy(&b, p + 4, sizeof(b));
+    x.hi = __builtin_shuffle(a, b, v8i{0, 2, 4, 6, 8, 10, 12, 14});
+    x.lo = __builtin_shuffle(a, b, v8i{1, 3, 5, 7, 9, 11, 13, 15});
+}
+
+KMB_DD_INLINE void ddv_store(ddpack::dd* p, const ddv<v8d>& x) {
+    v8d a = __builtin_shuffle(x.hi, x.lo, v8i{0, 8, 1, 9, 2, 10, 3, 11});
+    v8d b = __builtin_shuffle(x.hi, x.lo, v8i{4, 12, 5, 13, 6, 14, 7, 15});
+    std::memcpy(p, &a, sizeof(a));
+    std::memcpy(p + 4, &b, sizeof(b));
+}
+
+template <typename V>
+KMB_DD_INLINE ddv<V> ddv_set1(ddpack::dd x) {
+    ddv<V> r;
+    for (unsigned j = 0; j < sizeof(V) / sizeof(double); j++) {
+        r.hi[j] = x.hi;
+        r.lo[j] = x.lo;
+    }
+    return r;
+}
+
+template <typename V>
+KMB_DD_INLINE void ddv_two_sum(const V& a, const V& b, V& s, V& e) {
+    //  (argumenty przez referencję - wektory 512-bitowe; s, e mogą być a, b)
+    V t = a + b;
+    V bb = t - a;
+    e = (a - (t - bb)) + (b - bb);
+    s = t;
+}
+
+template <typename V>
+KMB_DD_INLINE void ddv_quick_two_sum(const V& a, const V& b, V& s, V& e) {
+    V t = a + b;
+    e = b - (t - a);
+    s = t;
+}
+
+template <typename V>
+KMB_DD_INLINE void ddv_split(const V& a, V& hi, V& lo) {
+    V t = 134217729.0 * a;
+    hi = t - (t - a);
+    lo = a - hi;
+}
+
+template <typename V>
+KMB_DD_INLINE ddv<V> ddv_add(const ddv<V>& a, const ddv<V>& b) {
+    V s, e, t, f;
+    ddv_two_sum(a.hi, b.hi, s, e);
+    ddv_two_sum(a.lo, b.lo, t, f);
+    e += t;
+    ddv_quick_two_sum(s, e, s, e);
+    e += f;
+    ddv_quick_two_sum(s, e, s, e);
+    return { s, e };
+}
+
+template <typename V>
+KMB_DD_INLINE ddv<V> ddv_neg(const ddv<V>& a) { return { -a.hi, -a.lo }; }
+
+template <typename V>
+KMB_DD_INLINE void ddv_fms(const V& a, const V& b, const V& p, V& e) {
+    //  e = a * b - p z jednym zaokrągleniem; w funkcjach z FMA - rozkaz vfmsub
+    for (unsigned j = 0; j < sizeof(V) / sizeof(double); j++) {
+        e[j] = __builtin_fma(a[j], b[j], -p[j]);
+    }
+}
+
+template <bool FMA, typename V>
+KMB_DD_INLINE ddv<V> ddv_mul(const ddv<V>& a, const ddv<V>& b) {
+    V p = a.hi * b.hi;
+    V e;
+    if constexpr (FMA) {
+        ddv_fms(a.hi, b.hi, p, e);
+    } else {
+        V ah, al, bh, bl;
+        ddv_split(a.hi, ah, al);
+        ddv_split(b.hi, bh, bl);
+        e = ((ah * bh - p) + ah * bl + al * bh) + al * bl;
+    }
+    e += a.hi * b.lo + a.lo * b.hi;
+    ddv_quick_two_sum(p, e, p, e);
+    return { p, e };
+}
+
+template <bool FMA, typename V>
+KMB_DD_INLINE ddv<V> ddv_kmb(const ddpack::dd* U, const ddv<V>& vl, const ddv<V>& two) {
+    //  c + lambda * ((r - 2c) + l), jak w kmb_scalar (U wskazuje węzeł c)
+    ddv<V> c, l, r;
+    ddv_load(U, c);
+    ddv_load(U - 1, l);
+    ddv_load(U + 1, r);
+    ddv<V> s = ddv_add(ddv_add(r, ddv_neg(ddv_mul<FMA>(two, c))), l);
+    return ddv_add(c, ddv_mul<FMA>(vl, s));
+}
+
+template <bool FMA, typename V>
+KMB_DD_INLINE int kmb_dd_simd(const ddpack::dd* U_old, ddpack::dd* U_new, ddpack::dd lambda, int lo, int hi) {
+    //  węzły lo..i-1 (i - zwracany początek "ogona" dla wersji skalarnej)
+    const int W = sizeof(V) / sizeof(double);
+    const ddv<V> vl  = ddv_set1<V>(lambda);
+    const ddv<V> two = ddv_set1<V>(ddpack::dd(2.0));
+    int i = lo;
+    for (; i + W <= hi; i += W) {
+        ddv_store(U_new + i, ddv_kmb<FMA, V>(U_old + i, vl, two));
+    }
+    return i;
+}
+
+template <bool FMA, typename V>
+KMB_DD_INLINE int kmb_dd_simd_err(const ddpack::dd* U_old, ddpack::dd* U_new, ddpack::dd lambda,
+        const ddpack::dd* U_ref, int lo, int hi, ddpack::dd& err) {
+    //  |d| i maksimum z porównaniami jak w DD.h; NaN (w części hi) jak w max_bledu
+    const int W = sizeof(V) / sizeof(double);
+    const ddv<V> vl  = ddv_set1<V>(lambda);
+    const ddv<V> two = ddv_set1<V>(ddpack::dd(2.0));
+    ddv<V> acc = ddv_set1<V>(err);
+    int i = lo;
+    for (; i + W <= hi; i += W) {
+        ddv_store(U_new + i, ddv_kmb<FMA, V>(U_old + i, vl, two));
+
+        ddv<V> c, ref;
+        ddv_load(U_old + i, c);
+        ddv_load(U_ref + i, ref);
+        ddv<V> d = ddv_add(c, ddv_neg(ref));
+        auto ujemne = (d.hi < 0.0) | ((d.hi == 0.0) & (d.lo < 0.0));
+        ddv<V> e = { ujemne ? -d.hi : d.hi, ujemne ? -d.lo : d.lo };
+
+        auto wieksze = (acc.hi < e.hi) | ((acc.hi == e.hi) & (acc.lo < e.lo)) | (e.hi != e.hi);
+        acc.hi = wieksze ? e.hi : acc.hi;
+        acc.lo = wieksze ? e.lo : acc.lo;
+    }
+    ddpack::dd lanes[W];
+    ddv_store(lanes, acc);
+    for (int j = 0; j < W; j++) {
+        precyzjapack::max_bledu(err, lanes[j]);
+    }
+    return i;
+}
+
+__attribute__((target("avx2")))
+static void kmb_avx2_dekker(const ddpack::dd* U_old, ddpack::dd* U_new, ddpack::dd lambda, int lo, int hi) {
+    int i = kmb_dd_simd<false, v4d>(U_old, U_new, lambda, lo, hi);
+    kmb_scalar(U_old, U_new, lambda, i, hi);
+}
+
+__attribute__((target("avx2")))
+static void kmb_avx2_dekker_err(const ddpack::dd* U_old, ddpack::dd* U_new, ddpack::dd lambda,
+        const ddpack::dd* U_ref, int lo, int hi, ddpack::dd& err) {
+    int i = kmb_dd_simd_err<false, v4d>(U_old, U_new, lambda, U_ref, lo, hi, err);
+    kmb_scalar_err(U_old, U_new, lambda, U_ref, i, hi, err);
+}
+
+__attribute__((target("avx2,fma"), optimize("fp-contract=off")))
+static void kmb_avx2_fma(const ddpack::dd* U_old, ddpack::dd* U_new, ddpack::dd lambda, int lo, int hi) {
+    int i = kmb_dd_simd<true, v4d>(U_old, U_new, lambda, lo, hi);
+    kmb_scalar(U_old, U_new, lambda, i, hi);
+}
+
+__attribute__((target("avx2,fma"), optimize("fp-contract=off")))
+static void kmb_avx2_fma_err(const ddpack::dd* U_old, ddpack::dd* U_new, ddpack::dd lambda,
+        const ddpack::dd* U_ref, int lo, int hi, ddpack::dd& err) {
+    int i = kmb_dd_simd_err<true, v4d>(U_old, U_new, lambda, U_ref, lo, hi, err);
+    kmb_scalar_err(U_old, U_new, lambda, U_ref, i, hi, err);
+}
+
+static bool procesor_ma_fma() {
+    static const bool fma = []() {
+        __builtin_cpu_init();
+        return __builtin_cpu_supports("fma") != 0;
+    }();
+    return fma;
+}
+
+//  AVX2 dla dd: wariant z FMA, jeśli procesor go ma (prawie każdy z AVX2)
+static void kmb_avx2(const ddpack::dd* U_old, ddpack::dd* U_new, ddpack::dd lambda, int lo, int hi) {
+    if (procesor_ma_fma()) kmb_avx2_fma(U_old, U_new, lambda, lo, hi);
+    else                   kmb_avx2_dekker(U_old, U_new, lambda, lo, hi);
+}
+
+static void kmb_avx2_err(const ddpack::dd* U_old, ddpack::dd* U_new, ddpack::dd lambda, const ddpack::dd* U_ref,
+        int lo, int hi, ddpack::dd& err) {
+    if (procesor_ma_fma()) kmb_avx2_fma_err(U_old, U_new, lambda, U_ref, lo, hi, err);
+    else                   kmb_avx2_dekker_err(U_old, U_new, lambda, U_ref, lo, hi, err);
+}
+
+//  AVX-512F obejmuje FMA na wektorach 512-bitowych
+__attribute__((target("avx512f"), optimize("fp-contract=off")))
+static void kmb_avx512(const ddpack::dd* U_old, ddpack::dd* U_new, ddpack::dd lambda, int lo, int hi) {
+    int i = kmb_dd_simd<true, v8d>(U_old, U_new, lambda, lo, hi);
+    kmb_scalar(U_old, U_new, lambda, i, hi);
+}
+
+__attribute__((target("avx512f"), optimize("fp-contract=off")))
+static void kmb_avx512_err(const ddpack::dd* U_old, ddpack::dd* U_new, ddpack::dd lambda, const ddpack::dd* U_ref,
+        int lo, int hi, ddpack::dd& err) {
+    int i = kmb_dd_simd_err<true, v8d>(U_old, U_new, lambda, U_ref, lo, hi, err);
+    kmb_scalar_err(U_old, U_new, lambda, U_ref, i, hi, err);
+}
+
+#undef KMB_DD_INLINE
+#endif
+
+
+
+kmbpack::ISA kmbpack::wybrane_isa() {
+    //-------------------------------------------------------------------
+    //  Wykrycie możliwości procesora (wykonywane raz, przy pierwszym użyciu)
+    //-------------------------------------------------------------------
+    static const ISA isa = []() {
+#ifdef KMB_X86_SIMD
+        __builtin_cpu_init();
+        if (__builtin_cpu_supports("avx512f")) return ISA::AVX512;
+        if (__builtin_cpu_supports("avx2"))    return ISA::AVX2;
+#endif
+        return ISA::SCALAR;
+    }();
+    return isa;
+}
+
+
+
+const char* kmbpack::nazwa_isa(ISA isa) {
+    switch (isa) {
+        case ISA::AVX512: return "AVX-512";
+        case ISA::AVX2:   return "AVX2";
+        default:          return "skalarne";
+    }
+}
+
+
+
+template <typename T>
+static void kmb_range(kmbpack::ISA isa, const T* U_old, T* U_new, T lambda, int lo, int hi) {
+    //-------------------------------------------------------------------
+    //  Wybór jądra dla węzłów wewnętrznych lo..hi-1; zestaw instrukcji
+    //  ograniczany jest do dostępnego na danym procesorze.
+    //-------------------------------------------------------------------
+    kmbpack::ISA dostepne = kmbpack::wybrane_isa();
+    if (isa > dostepne) isa = dostepne;
+
+#ifdef KMB_X86_SIMD
+    if (isa == kmbpack::ISA::AVX512) { kmb_avx512(U_old, U_new, lambda, lo, hi); return; }
+    if (isa == kmbpack::ISA::AVX2)   { kmb_avx2(U_old, U_new, lambda, lo, hi);   return; }
+#endif
+    kmb_scalar(U_old, U_new, lambda, lo, hi);
+}
+
+static void kmb_range(kmbpack::ISA, const long double* U_old, long double* U_new, long double lambda, int lo, int hi) {
+    //  long double - tylko wersja skalarna
+    kmb_scalar(U_old, U_new, lambda, lo, hi);
+}
+
+#ifdef PRECYZJA_FLOAT128
+static void kmb_range(kmbpack::ISA, const precyzjapack::float128* U_old, precyzjapack::float128* U_new,
+        precyzjapack::float128 lambda, int lo, int hi) {
+    kmb_scalar(U_old, U_new, lambda, lo, hi);
+}
+#endif
+
+
+
+template <typename T>
+static void kmb_dispatch(kmbpack::ISA isa, const T* U_old, T* U_new, T lambda, int N) {
+    U_new[0] = T(0);
+    U_new[N - 1] = T(0);
+
+    kmb_range(isa, U_old, U_new, lambda, 1, N - 1);
+}
+
+
+
+template <typename T>
+static void kmb_range_err(kmbpack::ISA isa, const T* U_old, T* U_new, T lambda, const T* U_ref,
+        int lo, int hi, T& err) {
+    kmbpack::ISA dostepne = kmbpack::wybrane_isa();
+    if (isa > dostepne) isa = dostepne;
+
+#ifdef KMB_X86_SIMD
+    if (isa == kmbpack::ISA::AVX512) { kmb_avx512_err(U_old, U_new, lambda, U_ref, lo, hi, err); return; }
+    if (isa == kmbpack::ISA::AVX2)   { kmb_avx2_err(U_old, U_new, lambda, U_ref, lo, hi, err);   return; }
+#endif
+    kmb_scalar_err(U_old, U_new, lambda, U_ref, lo, hi, err);
+}
+
+static void kmb_range_err(kmbpack::ISA, const long double* U_old, long double* U_new, long double lambda,
+        const long double* U_ref, int lo, int hi, long double& err) {
+    kmb_scalar_err(U_old, U_new, lambda, U_ref, lo, hi, err);
+}
+
+#ifdef PRECYZJA_FLOAT128
+static void kmb_range_err(kmbpack::ISA, const precyzjapack::float128* U_old, precyzjapack::float128* U_new,
+        precyzjapack::float128 lambda, const precyzjapack::float128* U_ref, int lo, int hi,
+        precyzjapack::float128& err) {
+    kmb_scalar_err(U_old, U_new, lambda, U_ref, lo, hi, err);
+}
+#endif
+
+
+
+template <typename T>
+static T kmb_dispatch_err(kmbpack::ISA isa, const T* U_old, T* U_new, T lambda, const T* U_ref, int N) {
+    //  węzły brzegowe: tylko błąd, wartości U_new = 0
+    T err = T(0);
+    T e0 = precyzjapack::modul(U_old[0] - U_ref[0]);
+    precyzjapack::max_bledu(err, e0);
+    T e1 = precyzjapack::modul(U_old[N - 1] - U_ref[N - 1]);
+    precyzjapack::max_bledu(err, e1);
+
+    U_new[0] = T(0);
+    U_new[N - 1] = T(0);
+
+    kmb_range_err(isa, U_old, U_new, lambda, U_ref, 1, N - 1, err);
+    return err;
+}
+
+
+
+void kmbpack::oblicz_nastepny_poziom_czasowy_KMB(const double* U_old, double* U_new, double lambda, const int N) {
+    //-------------------------------------------------------------------
+    //  Wersja double (argumenty jak w wersji long double); jądro
+    //  wybierane automatycznie na podstawie możliwości procesora
+    //-------------------------------------------------------------------
+    kmb_dispatch(wybrane_isa(), U_old, U_new, lambda, N);
+}
+
+
+
+void kmbpack::oblicz_nastepny_poziom_czasowy_KMB(const float* U_old, float* U_new, float lambda, const int N) {
+    kmb_dispatch(wybrane_isa(), U_old, U_new, lambda, N);
+}
+
+
+
+void kmbpack::oblicz_nastepny_poziom_czasowy_KMB(ISA isa, const double* U_old, double* U_new, double lambda, const int N) {
+    kmb_dispatch(isa, U_old, U_new, lambda, N);
+}
+
+
+
+void kmbpack::oblicz_nastepny_poziom_czasowy_KMB(ISA isa, const float* U_old, float* U_new, float lambda, const int N) {
+    kmb_dispatch(isa, U_old, U_new, lambda, N);
+}
+
+
+
+long double kmbpack::oblicz_nastepny_poziom_czasowy_KMB(const long double* U_old, long double* U_new,
+        long double lambda, const int N, const long double* U_ref) {
+    //-------------------------------------------------------------------
+    //  Krok KMB połączony z wyznaczeniem błędu poziomu U_old
+    //
+    //  Argumenty:
+    //  U_old  - Tablica wartości funkcji dla bieżącego poziomu czasu
+    //  U_new  - Tablica wartości funkcji dla nowego poziomu czasu
+    //  lambda - parametr lambda: D*dt/h^2
+    //  N      - liczba węzłów siatki przestrzennej
+    //  U_ref  - wartości odniesienia dla poziomu U_old (np. analityczne)
+    //
+    //  Zwraca: max |U_old[i] - U_ref[i]|
+    //-------------------------------------------------------------------
+    PROFIL_ZAKRES("KMB: krok + blad");
+    return kmb_dispatch_err(ISA::SCALAR, U_old, U_new, lambda, U_ref, N);
+}
+
+
+
+double kmbpack::oblicz_nastepny_poziom_czasowy_KMB(const double* U_old, double* U_new, double lambda,
+        const int N, const double* U_ref) {
+    return kmb_dispatch_err(wybrane_isa(), U_old, U_new, lambda, U_ref, N);
+}
+
+
+
+float kmbpack::oblicz_nastepny_poziom_czasowy_KMB(const float* U_old, float* U_new, float lambda,
+        const int N, const float* U_ref) {
+    return kmb_dispatch_err(wybrane_isa(), U_old, U_new, lambda, U_ref, N);
+}
+
+
+
+void kmbpack::oblicz_nastepny_poziom_czasowy_KMB(const ddpack::dd* U_old, ddpack::dd* U_new, ddpack::dd lambda,
+        const int N) {
+    kmb_dispatch(wybrane_isa(), U_old, U_new, lambda, N);
+}
+
+
+
+void kmbpack::oblicz_nastepny_poziom_czasowy_KMB(ISA isa, const ddpack::dd* U_old, ddpack::dd* U_new,
+        ddpack::dd lambda, const int N) {
+    kmb_dispatch(isa, U_old, U_new, lambda, N);
+}
+
+
+
+ddpack::dd kmbpack::oblicz_nastepny_poziom_czasowy_KMB(const ddpack::dd* U_old, ddpack::dd* U_new,
+        ddpack::dd lambda, const int N, const ddpack::dd* U_ref) {
+    return kmb_dispatch_err(wybrane_isa(), U_old, U_new, lambda, U_ref, N);
+}
+
+
+
+#ifdef PRECYZJA_FLOAT128
+void kmbpack::oblicz_nastepny_poziom_czasowy_KMB(const precyzjapack::float128* U_old, precyzjapack::float128* U_new,
+        precyzjapack::float128 lambda, const int N) {
+    kmb_dispatch(ISA::SCALAR, U_old, U_new, lambda, N);
+}
+
+
+
+precyzjapack::float128 kmbpack::oblicz_nastepny_poziom_czasowy_KMB(const precyzjapack::float128* U_old,
+        precyzjapack::float128* U_new, precyzjapack::float128 lambda, const int N, const precyzjapack::float128* U_ref) {
+    return kmb_dispatch_err(ISA::SCALAR, U_old, U_new, lambda, U_ref, N);
+}
+#endif
+
+
+
+template <typename T>
+static void kmb_multi(const T* U_old, T* U_new, T lambda, int N, int k, int tile) {
+    //-------------------------------------------------------------------
+    //  Blokowanie czasowe (kafelki trapezowe z nakładaniem): dla kafelka
+    //  [s, e) kopiujemy do bufora lokalnego węzły [s-k, e+k), a następnie
+    //  w każdym kroku j przeliczamy obszar zwężony o j węzłów z każdej
+    //  strony (na brzegach siatki obszar się nie zwęża - tam U=0).
+    //  Po k krokach w buforze znajdują się poprawne wartości dla [s, e).
+    //
+    //  Argumenty:
+    //      U_old   - Tablica wartości funkcji dla bieżącego poziomu czasu
+    //      U_new   - Tablica wartości funkcji po k krokach
+    //      lambda  - parametr lambda: D*dt/h^2
+    //      N       - liczba węzłów siatki przestrzennej
+    //      k       - liczba kroków czasowych
+    //      tile    - długość kafelka (liczba wyznaczanych węzłów)
+    //-------------------------------------------------------------------
+    if (k <= 0) {
+        for (int i = 0; i < N; i++) U_new[i] = U_old[i];
+        return;
+    }
+    if (tile < 1) tile = 1;
+
+    const kmbpack::ISA isa = kmbpack::wybrane_isa();
+
+    T* buf_a = new T[tile + 2 * k];
+    T* buf_b = new T[tile + 2 * k];
+
+    for (int s = 0; s < N; s += tile) {
+        const int e  = (s + tile < N) ? s + tile : N;
+        const int lo = (s - k > 0) ? s - k : 0;
+        const int hi = (e + k < N) ? e + k : N;
+
+        //  bufory indeksowane lokalnie: węzeł globalny g -> g - lo
+        for (int g = lo; g < hi; g++) {
+            buf_a[g - lo] = U_old[g];
+        }
+
+        T* a = buf_a;
+        T* b = buf_b;
+        for (int j = 1; j <= k; j++) {
+            //  węzły wewnętrzne, dla których znane są wartości sąsiadów
+            //  z poprzedniego kroku
+            int i_lo = (lo == 0) ? 1 : lo + j;
+            int i_hi = (hi == N) ? N - 1 : hi - j;
+
+            kmb_range(isa, a - lo, b - lo, lambda, i_lo, i_hi);
+
+            // warunki brzegowe
+            if (lo == 0) b[0] = T(0);
+            if (hi == N) b[N - 1 - lo] = T(0);
+
+            T* tmp = a; a = b; b = tmp;
+        }
+
+        for (int g = s; g < e; g++) {
+            U_new[g] = a[g - lo];
+        }
+    }
+
+    delete[] buf_a;
+    delete[] buf_b;
+}
+
+
+
+void kmbpack::oblicz_k_poziomow_czasowych_KMB(const long double* U_old, long double* U_new, long double lambda,
+        const int N, const int k, const int tile) {
+    kmb_multi(U_old, U_new, lambda, N, k, tile);
+}
+
+
+
+void kmbpack::oblicz_k_poziomow_czasowych_KMB(const double* U_old, double* U_new, double lambda,
+        const int N, const int k, const int tile) {
+    kmb_multi(U_old, U_new, lambda, N, k, tile);
+}
+
+
+
+void kmbpack::oblicz_k_poziomow_czasowych_KMB(const float* U_old, float* U_new, float lambda,
+        const int N, const int k, const int tile) {
+    kmb_multi(U_old, U_new, lambda, N, k, tile);
+}
+
+
+
+template <typename T>
+kmbpack::ParallelKMB<T>::ParallelKMB(int N, int n_threads)
+        : N(N), n_threads(n_threads < 1 ? 1 : n_threads), barrier(n_threads < 1 ? 1 : n_threads) {
+    //-------------------------------------------------------------------
+    //  Argumenty:
+    //      N           - liczba węzłów siatki przestrzennej
+    //      n_threads   - liczba wątków (łącznie z wątkiem wywołującym)
+    //-------------------------------------------------------------------
+
+    //  tablice bez inicjalizacji - pierwszego zapisu dokonują wątki robocze
+    buf[0] = new T[N];
+    buf[1] = new T[N];
+
+    //  podział na fragmenty wyrównane do linii pamięci podręcznej (64 B),
+    //  aby sąsiednie wątki nie zapisywały tej samej linii
+    const int align = (64 / (int)sizeof(T) > 0) ? 64 / (int)sizeof(T) : 1;
+    const int blocks = (N + align - 1) / align;
+    for (int id = 0; id < this->n_threads; id++) {
+        long lo = (long)blocks * id / this->n_threads * align;
+        long hi = (long)blocks * (id + 1) / this->n_threads * align;
+        chunk_lo.push_back(lo < N ? (int)lo : N);
+        chunk_hi.push_back(hi < N ? (int)hi : N);
+    }
+
+    bledy.assign(this->n_threads, T(0));
+
+    for (int id = 1; id < this->n_threads; id++) {
+        workers.emplace_back(&ParallelKMB::worker_loop, this, id);
+    }
+
+    //  first-touch fragmentu wątku wywołującego, a następnie czekamy,
+    //  aż wszystkie wątki zainicjalizują swoje fragmenty
+    for (int i = chunk_lo[0]; i < chunk_hi[0]; i++) {
+        buf[0][i] = T(0);
+        buf[1][i] = T(0);
+    }
+    barrier.wait();
+}
+
+
+
+template <typename T>
+kmbpack::ParallelKMB<T>::~ParallelKMB() {
+    {
+        std::lock_guard<std::mutex> lock(mtx);
+        stop = true;
+        generation.fetch_add(1, std::memory_order_release);
+    }
+    cv.notify_all();
+    for (std::thread& t : workers) {
+        t.join();
+    }
+    delete[] buf[0];
+    delete[] buf[1];
+}
+
+
+
+template <typename T>
+void kmbpack::ParallelKMB<T>::worker_loop(int id) {
+    for (int i = chunk_lo[id]; i < chunk_hi[id]; i++) {
+        buf[0][i] = T(0);
+        buf[1][i] = T(0);
+    }
+    barrier.wait();
+
+    unsigned long seen = 0;
+    for (;;) {
+        //  krótkie aktywne oczekiwanie na kolejne polecenie (typowo advance
+        //  wywoływane jest w pętli), potem uśpienie na zmiennej warunkowej
+        for (int spins = 0; spins < 2048 && generation.load(std::memory_order_acquire) == seen; spins++) {
+            threadpack::cpu_relax();
+        }
+        {
+            std::unique_lock<std::mutex> lock(mtx);
+            cv.wait(lock, [&] { return generation.load(std::memory_order_relaxed) != seen; });
+            seen = generation.load(std::memory_order_relaxed);
+            if (stop) return;
+        }
+        run_steps(id);
+    }
+}
+
+
+
+template <typename T>
+void kmbpack::ParallelKMB<T>::run_steps(int id) {
+    //-------------------------------------------------------------------
+    //  cmd_steps kroków na fragmencie [lo, hi); po każdym kroku bariera,
+    //  dzięki której sąsiednie wątki widzą aktualne wartości halo
+    //-------------------------------------------------------------------
+    const int lo = chunk_lo[id];
+    const int hi = chunk_hi[id];
+    const int i_lo = (lo > 1) ? lo : 1;
+    const int i_hi = (hi < N - 1) ? hi : N - 1;
+    const kmbpack::ISA isa = kmbpack::wybrane_isa();
+
+    //  kopie polecenia - wątek wywołujący może je zmienić w kolejnym
+    //  advance, zanim ten wątek opuści ostatnią barierę
+    const int steps = cmd_steps;
+    const T lambda = cmd_lambda;
+
+    if (cmd_U_old != nullptr) {
+        //  step(): jeden krok na tablicach wywołującego, z błędem fragmentu
+        const T* U_old = cmd_U_old;
+        T* U_new = cmd_U_new;
+        const T* U_ref = cmd_U_ref;
+        T err = T(0);
+        if (U_ref != nullptr) {
+            if (i_lo < i_hi) kmb_range_err(isa, U_old, U_new, lambda, U_ref, i_lo, i_hi, err);
+            if (lo == 0 && hi > 0) {
+                T e = precyzjapack::modul(U_old[0] - U_ref[0]);
+                precyzjapack::max_bledu(err, e);
+            }
+            if (hi == N && lo < N) {
+                T e = precyzjapack::modul(U_old[N - 1] - U_ref[N - 1]);
+                precyzjapack::max_bledu(err, e);
+            }
+        } else if (i_lo < i_hi) {
+            kmb_range(isa, U_old, U_new, lambda, i_lo, i_hi);
+        }
+        if (lo == 0 && hi > 0) U_new[0] = T(0);
+        if (hi == N && lo < N) U_new[N - 1] = T(0);
+        bledy[id] = err;
+
+        barrier.wait();
+        return;
+    }
+
+    T* a = buf[cur];
+    T* b = buf[cur ^ 1];
+
+    for (int s = 0; s < steps; s++) {
+        if (i_lo < i_hi) kmb_range(isa, a, b, lambda, i_lo, i_hi);
+
+        // warunki brzegowe
+        if (lo == 0 && hi > 0) b[0] = T(0);
+        if (hi == N && lo < N) b[N - 1] = T(0);
+
+        barrier.wait();
+        T* tmp = a; a = b; b = tmp;
+    }
+}
+
+
+
+template <typename T>
+void kmbpack::ParallelKMB<T>::advance(T lambda, int steps) {
+    if (steps <= 0) return;
+
+    {
+        std::lock_guard<std::mutex> lock(mtx);
+        cmd_lambda = lambda;
+        cmd_steps = steps;
+        cmd_U_old = nullptr;
+        generation.fetch_add(1, std::memory_order_release);
+    }
+    cv.notify_all();
+
+    run_steps(0);
+    //  run_steps kończy się barierą - wszystkie wątki skończyły
+
+    cur ^= (steps & 1);
+}
+
+
+
+template <typename T>
+T kmbpack::ParallelKMB<T>::step(const T* U_old, T* U_new, T lambda, const T* U_ref) {
+    {
+        std::lock_guard<std::mutex> lock(mtx);
+        cmd_lambda = lambda;
+        cmd_steps = 1;
+        cmd_U_old = U_old;
+        cmd_U_new = U_new;
+        cmd_U_ref = U_ref;
+        generation.fetch_add(1, std::memory_order_release);
+    }
+    cv.notify_all();
+
+    run_steps(0);
+    //  run_steps kończy się barierą - błędy wszystkich fragmentów są gotowe
+
+    T err = T(0);
+    for (int id = 0; id < n_threads; id++) {
+        precyzjapack::max_bledu(err, bledy[id]);
+    }
+    return err;
+}
+
+
+
+template <typename T>
+void kmbpack::raport_skalowania(std::ostream& out, int N, int steps, int max_threads) {
+    //-------------------------------------------------------------------
+    //  Argumenty:
+    //      out         - strumień, do którego wypisywany jest raport
+    //      N           - liczba węzłów (dla 1 wątku w skalowaniu słabym)
+    //      steps       - liczba kroków czasowych w pomiarze
+    //      max_threads - największa sprawdzana liczba wątków
+    //-------------------------------------------------------------------
+    std::vector<int> counts;
+    for (int p = 1; p < max_threads; p *= 2) counts.push_back(p);
+    counts.push_back(max_threads < 1 ? 1 : max_threads);
+
+    auto zmierz = [&](int n, int p) {
+        ParallelKMB<T> engine(n, p);
+        T* U = engine.U();
+        for (int i = 1; i < n - 1; i++) U[i] = T(1);
+        engine.advance(T(0.4), 1);  // rozgrzewka
+
+        auto start = std::chrono::steady_clock::now();
+        engine.advance(T(0.4), steps);
+        auto end = std::chrono::steady_clock::now();
+        return std::chrono::duration<double>(end - start).count();
+    };
+
+    out << "Skalowanie silne (N = " << N << ", kroków = " << steps << ")\n";
+    out << "watki,czas[s],ns/wezel-krok,przyspieszenie,efektywnosc\n";
+    double t1 = 0.0;
+    for (int p : counts) {
+        double t = zmierz(N, p);
+        if (p == 1) t1 = t;
+        out << p << "," << t << "," << t * 1e9 / ((double)N * steps) << ","
+            << t1 / t << "," << t1 / t / p << "\n";
+    }
+
+    out << "Skalowanie słabe (N = " << N << " na wątek, kroków = " << steps << ")\n";
+    out << "watki,N,czas[s],ns/wezel-krok,efektywnosc\n";
+    for (int p : counts) {
+        double t = zmierz(N * p, p);
+        if (p == 1) t1 = t;
+        out << p << "," << N * p << "," << t << "," << t * 1e9 / ((double)N * p * steps) << ","
+            << t1 / t << "\n";
+    }
+}
+
+
+
+//  Jawne instancje dla wszystkich typów skalarnych (PRECYZJA.h)
+#define KMB_ROWNOLEGLY_INSTANCJE(T) \
+    template class kmbpack::ParallelKMB<T>; \
+    template void kmbpack::raport_skalowania<T>(std::ostream&, int, int, int);
+
+PRECYZJA_DLA_TYPOW(KMB_ROWNOLEGLY_INSTANCJE)
@@ -0,0 +1,164 @@
+#ifndef __kmb_h
+#define __kmb_h
+
+#include <condition_variable>
+#include <iosfwd>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "PRECYZJA.h"
+#include "THREADS.h"
+
+//----------------------------------------------------------------------
+// Pakiet z jądrami obliczeniowymi Klasycznej Metody Bezpośredniej (KMB):
+//      U_new[i] = U_old[i] + lambda*(U_old[i+1] - 2U_old[i] + U_old[i-1])
+// Wersja long double jest wersją referencyjną. Wersje double/float
+// (oraz double-double, ddpack::dd) korzystają z instrukcji wektorowych
+// (AVX2 / AVX-512), wybieranych w czasie działania programu na podstawie
+// możliwości procesora.
+//----------------------------------------------------------------------
+namespace kmbpack{
+
+    //  Zestawy instrukcji, którymi mogą być realizowane jądra double/float
+    enum class ISA { SCALAR, AVX2, AVX512 };
+
+    //  Zestaw instrukcji wybrany dla bieżącego procesora
+    ISA wybrane_isa();
+    const char* nazwa_isa(ISA isa);
+
+    //  Wersja referencyjna (long double)
+    void oblicz_nastepny_poziom_czasowy_KMB(const long double* U_old, long double* U_new, long double lambda, const int N);
+
+    //  Wersje wektorowe (wynik zgodny bitowo z wersją skalarną tej samej precyzji)
+    void oblicz_nastepny_poziom_czasowy_KMB(const double* U_old, double* U_new, double lambda, const int N);
+    void oblicz_nastepny_poziom_czasowy_KMB(const float* U_old, float* U_new, float lambda, const int N);
+
+    //------------------------------------------------------------------
+    //  Wykonanie k kroków czasowych naraz z blokowaniem czasowym: siatka
+    //  dzielona jest na kafelki o długości tile węzłów, a każdy kafelek
+    //  (wraz z k-węzłowym marginesem z obu stron) przechodzi przez k kroków
+    //  w pamięci podręcznej. Wynik jest bitowo identyczny z k wywołaniami
+    //  oblicz_nastepny_poziom_czasowy_KMB; U_old nie jest modyfikowane,
+    //  U_old i U_new nie mogą się pokrywać.
+    //------------------------------------------------------------------
+    const int KMB_TILE = 2048;
+    //  liczba kroków w jednym bloku czasowym metody "KMB" z rejestru (metodypack)
+    const int KMB_KROKI_NARAZ = 16;
+
+    void oblicz_k_poziomow_czasowych_KMB(const long double* U_old, long double* U_new, long double lambda,
+        const int N, const int k, const int tile = KMB_TILE);
+    void oblicz_k_poziomow_czasowych_KMB(const double* U_old, double* U_new, double lambda,
+        const int N, const int k, const int tile = KMB_TILE);
+    void oblicz_k_poziomow_czasowych_KMB(const float* U_old, float* U_new, float lambda,
+        const int N, const int k, const int tile = KMB_TILE);
+
+    //------------------------------------------------------------------
+    //  Krok KMB połączony z wyznaczaniem błędu: oprócz U_new funkcja
+    //  zwraca max |U_old[i] - U_ref[i]| (po wszystkich N węzłach), liczone
+    //  w tym samym przejściu po U_old - monitorowanie błędu nie wymaga
+    //  osobnego odczytu tablicy. U_ref to np. rozwiązanie analityczne
+    //  na poziomie czasowym U_old. U_new jest identyczne jak w wersji bez U_ref.
+    //------------------------------------------------------------------
+    long double oblicz_nastepny_poziom_czasowy_KMB(const long double* U_old, long double* U_new, long double lambda,
+        const int N, const long double* U_ref);
+    double oblicz_nastepny_poziom_czasowy_KMB(const double* U_old, double* U_new, double lambda,
+        const int N, const double* U_ref);
+    float oblicz_nastepny_poziom_czasowy_KMB(const float* U_old, float* U_new, float lambda,
+        const int N, const float* U_ref);
+
+    //  Wersje double-double (ddpack::dd): jądra AVX-512 lub AVX2 (błąd iloczynu
+    //  z FMA, a bez FMA - algorytmem Dekkera); wynik zgodny bitowo z wersją skalarną
+    void oblicz_nastepny_poziom_czasowy_KMB(const ddpack::dd* U_old, ddpack::dd* U_new, ddpack::dd lambda, const int N);
+    ddpack::dd oblicz_nastepny_poziom_czasowy_KMB(const ddpack::dd* U_old, ddpack::dd* U_new, ddpack::dd lambda,
+        const int N, const ddpack::dd* U_ref);
+
+#ifdef PRECYZJA_FLOAT128
+    //  Wersje __float128 (skalarne, programowe - do badań dokładności)
+    void oblicz_nastepny_poziom_czasowy_KMB(const precyzjapack::float128* U_old, precyzjapack::float128* U_new,
+        precyzjapack::float128 lambda, const int N);
+    precyzjapack::float128 oblicz_nastepny_poziom_czasowy_KMB(const precyzjapack::float128* U_old,
+        precyzjapack::float128* U_new, precyzjapack::float128 lambda, const int N, const precyzjapack::float128* U_ref);
+#endif
+
+    //  Wymuszenie konkretnego zestawu instrukcji (np. do porównań wydajności);
+    //  zestaw niedostępny na danym procesorze zastępowany jest najlepszym
+    //  dostępnym (wybrane_isa(): AVX-512 -> AVX2 -> wersja skalarna)
+    void oblicz_nastepny_poziom_czasowy_KMB(ISA isa, const double* U_old, double* U_new, double lambda, const int N);
+    void oblicz_nastepny_poziom_czasowy_KMB(ISA isa, const float* U_old, float* U_new, float lambda, const int N);
+    void oblicz_nastepny_poziom_czasowy_KMB(ISA isa, const ddpack::dd* U_old, ddpack::dd* U_new, ddpack::dd lambda,
+        const int N);
+
+
+    //------------------------------------------------------------------
+    //  Równoległy silnik KMB z dekompozycją obszaru. Siatka dzielona jest
+    //  na ciągłe fragmenty, po jednym na wątek; wątki tworzone są raz
+    //  w konstruktorze i każdy z nich jako pierwszy zapisuje "swój"
+    //  fragment tablic (first-touch - strony pamięci trafiają do węzła
+    //  NUMA wątku). Węzły brzegowe sąsiednich fragmentów (halo) są
+    //  odczytywane bezpośrednio z pamięci wspólnej, a kroki czasowe
+    //  rozdziela bariera z aktywnym oczekiwaniem (threadpack::SpinBarrier).
+    //
+    //  Użycie: wpisać warunek początkowy do U(), wywołać advance(...),
+    //  wynik znajduje się ponownie w U(). Pojedynczy krok na tablicach
+    //  wywołującego (np. w pętli czasowej z monitorowaniem błędu)
+    //  wykonuje step(...) - tymi samymi wątkami i z tym samym podziałem.
+    //------------------------------------------------------------------
+    template <typename T>
+    class ParallelKMB {
+    public:
+        ParallelKMB(int N, int n_threads);
+        ~ParallelKMB();
+
+        ParallelKMB(const ParallelKMB&) = delete;
+        ParallelKMB& operator=(const ParallelKMB&) = delete;
+
+        T* U() { return buf[cur]; }
+        const T* U() const { return buf[cur]; }
+        int size() const { return N; }
+        int threads() const { return n_threads; }
+
+        //  Wykonuje steps kroków czasowych metody KMB
+        void advance(T lambda, int steps);
+
+        //  Jeden krok U_old -> U_new (tablice N węzłów, poza U()); gdy podano
+        //  U_ref, zwraca max |U_old[i] - U_ref[i]| (jak oblicz_nastepny_poziom_czasowy_KMB), inaczej 0
+        T step(const T* U_old, T* U_new, T lambda, const T* U_ref = nullptr);
+
+    private:
+        void worker_loop(int id);
+        void run_steps(int id);
+
+        int N;
+        int n_threads;
+        T* buf[2];
+        int cur = 0;
+        std::vector<int> chunk_lo, chunk_hi;
+
+        threadpack::SpinBarrier barrier;
+        std::vector<std::thread> workers;
+        std::mutex mtx;
+        std::condition_variable cv;
+        std::atomic<unsigned long> generation{0};
+        bool stop = false;
+
+        T cmd_lambda = T(0);
+        int cmd_steps = 0;
+        const T* cmd_U_old = nullptr;   //  step(): tablice wywołującego (nullptr - advance)
+        T* cmd_U_new = nullptr;
+        const T* cmd_U_ref = nullptr;
+        std::vector<T> bledy;           //  step(): błędy fragmentów wątków
+    };
+
+    //  Minimalna liczba węzłów na wątek, poniżej której dodatkowe wątki
+    //  nie przyspieszają kroku (koszt bariery ~ koszt kroku na fragmencie)
+    const int KMB_ROWNOLEGLY_MIN_WEZLOW = 4096;
+
+    //  Raport skalowania silnika ParallelKMB: silne (stałe N, rosnąca
+    //  liczba wątków) i słabe (N proporcjonalne do liczby wątków)
+    template <typename T>
+    void raport_skalowania(std::ostream& out, int N, int steps, int max_threads);
+
+}
+
+#endif
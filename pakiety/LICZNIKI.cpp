@@ -0,0 +1,370 @@
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <ostream>
+#include "LICZNIKI.h"
+
+#ifdef __linux__
+#include <cerrno>
+#include <dirent.h>
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+
+
+static double teraz() {
+    return std::chrono::duration<double>(std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+
+
+const char* licznikipack::nazwa_zdarzenia(Zdarzenie z) {
+    switch (z) {
+        case CYKLE:         return "cykle";
+        case INSTRUKCJE:    return "instrukcje";
+        case LLC_ODWOLANIA: return "odwolania_LLC";
+        case LLC_CHYBIENIA: return "chybienia_LLC";
+        case OPERACJE_FP:   return "operacje_FP";
+        case CZAS_ZADANIA:  return "czas_zadania_ns";
+        case BLEDY_STRON:   return "bledy_stron";
+        case PAMIEC_BAJTY:  return "bajty_pamieci";
+        default:            return "?";
+    }
+}
+
+
+
+double licznikipack::Wyniki::ipc() const {
+    if (!ma(CYKLE) || !ma(INSTRUKCJE) || wartosc[CYKLE] <= 0) return 0.0;
+    return wartosc[INSTRUKCJE] / wartosc[CYKLE];
+}
+
+
+
+double licznikipack::Wyniki::gbs_pamieci() const {
+    if (!ma(PAMIEC_BAJTY) || czas <= 0) return 0.0;
+    return wartosc[PAMIEC_BAJTY] / czas * 1e-9;
+}
+
+
+
+#ifdef __linux__
+
+static std::string czytaj_plik(const std::string& nazwa) {
+    std::ifstream f(nazwa);
+    std::string s;
+    std::getline(f, s);
+    return s;
+}
+
+
+
+static void dodaj_blad(std::string& opis, const std::string& nazwa, const std::string& blad) {
+    //  kolejne zdarzenia z tym samym błędem łączone są w jeden wpis
+    const std::string koncowka = ": " + blad;
+    if (opis.size() >= koncowka.size() && opis.compare(opis.size() - koncowka.size(), koncowka.size(), koncowka) == 0) {
+        opis.insert(opis.size() - koncowka.size(), ", " + nazwa);
+        return;
+    }
+    if (!opis.empty()) opis += "; ";
+    opis += nazwa + koncowka;
+}
+
+
+
+static std::vector<int> watki_procesu() {
+    std::vector<int> tid;
+    DIR* d = opendir("/proc/self/task");
+    if (d == nullptr) {
+        tid.push_back(0);       //  tylko bieżący wątek
+        return tid;
+    }
+    while (dirent* e = readdir(d)) {
+        if (e->d_name[0] != '.') tid.push_back(std::atoi(e->d_name));
+    }
+    closedir(d);
+    return tid;
+}
+
+
+
+static int perf_event_open(perf_event_attr* attr, int pid, int cpu) {
+    return (int)syscall(__NR_perf_event_open, attr, pid, cpu, -1, 0UL);
+}
+
+
+
+licznikipack::LicznikiSprzetowe::LicznikiSprzetowe(uint64_t surowe_fp) {
+    otworz(CYKLE, PERF_TYPE_HARDWARE, PERF_COUNT_HW_CPU_CYCLES);
+    otworz(INSTRUKCJE, PERF_TYPE_HARDWARE, PERF_COUNT_HW_INSTRUCTIONS);
+    otworz(LLC_ODWOLANIA, PERF_TYPE_HARDWARE, PERF_COUNT_HW_CACHE_REFERENCES);
+    otworz(LLC_CHYBIENIA, PERF_TYPE_HARDWARE, PERF_COUNT_HW_CACHE_MISSES);
+    if (surowe_fp != 0) otworz(OPERACJE_FP, PERF_TYPE_RAW, surowe_fp);
+    otworz(CZAS_ZADANIA, PERF_TYPE_SOFTWARE, PERF_COUNT_SW_TASK_CLOCK);
+    otworz(BLEDY_STRON, PERF_TYPE_SOFTWARE, PERF_COUNT_SW_PAGE_FAULTS);
+    otworz_uncore();
+
+    if (!opis_bledow.empty()) {
+        std::string paranoid = czytaj_plik("/proc/sys/kernel/perf_event_paranoid");
+        if (!paranoid.empty()) opis_bledow += " (perf_event_paranoid = " + paranoid + ")";
+    }
+}
+
+
+
+licznikipack::LicznikiSprzetowe::~LicznikiSprzetowe() {
+    for (const Deskryptor& d : fds) close(d.fd);
+}
+
+
+
+void licznikipack::LicznikiSprzetowe::otworz(Zdarzenie z, uint32_t typ, uint64_t config) {
+    //-------------------------------------------------------------------
+    //  Licznik dla każdego wątku procesu (inherit - także dla wątków
+    //  utworzonych później). Wystarczy, że uda się otworzyć licznik
+    //  pierwszego wątku; wątki zakończone w międzyczasie są pomijane.
+    //-------------------------------------------------------------------
+    perf_event_attr attr;
+    std::memset(&attr, 0, sizeof attr);
+    attr.size = sizeof attr;
+    attr.type = typ;
+    attr.config = config;
+    attr.disabled = 1;
+    attr.inherit = 1;
+    attr.exclude_kernel = (typ != PERF_TYPE_SOFTWARE);
+    attr.exclude_hv = 1;
+    attr.read_format = PERF_FORMAT_TOTAL_TIME_ENABLED | PERF_FORMAT_TOTAL_TIME_RUNNING;
+
+    bool pierwszy = true;
+    for (int tid : watki_procesu()) {
+        int fd = perf_event_open(&attr, tid, -1);
+        if (fd < 0) {
+            if (pierwszy) {
+                dodaj_blad(opis_bledow, nazwa_zdarzenia(z), std::strerror(errno));
+                return;
+            }
+            continue;
+        }
+        pierwszy = false;
+        fds.push_back(Deskryptor{fd, z, 1.0});
+    }
+}
+
+
+
+static bool ustaw_pole(const std::string& urzadzenie, const std::string& klucz, uint64_t wartosc, uint64_t& config) {
+    //  format/<klucz> ma postać "config:a-b" lub "config:a" (bity pola w config)
+    std::string format = czytaj_plik(urzadzenie + "/format/" + klucz);
+    if (format.compare(0, 7, "config:") != 0) return false;
+    int a = 0, b = 0;
+    int n = std::sscanf(format.c_str() + 7, "%d-%d", &a, &b);
+    if (n < 1) return false;
+    if (n == 1) b = a;
+    uint64_t maska = (b - a + 1 >= 64) ? ~0ULL : ((1ULL << (b - a + 1)) - 1);
+    config |= (wartosc & maska) << a;
+    return true;
+}
+
+
+
+static bool koduj_zdarzenie(const std::string& urzadzenie, const std::string& opis, uint64_t& config) {
+    //  opis zdarzenia z sysfs, np. "event=0x04,umask=0x03"
+    config = 0;
+    size_t p = 0;
+    while (p < opis.size()) {
+        size_t q = opis.find(',', p);
+        if (q == std::string::npos) q = opis.size();
+        std::string term = opis.substr(p, q - p);
+        size_t r = term.find('=');
+        std::string klucz = term.substr(0, r);
+        uint64_t wartosc = (r == std::string::npos) ? 1 : std::strtoull(term.c_str() + r + 1, nullptr, 0);
+        if (!ustaw_pole(urzadzenie, klucz, wartosc, config)) return false;
+        p = q + 1;
+    }
+    return true;
+}
+
+
+
+void licznikipack::LicznikiSprzetowe::otworz_uncore() {
+    //-------------------------------------------------------------------
+    //  Ruch kontrolera pamięci: zdarzenia cas_count_read/cas_count_write
+    //  wszystkich urządzeń uncore_imc* (procesory Intel). Liczniki uncore
+    //  liczą dla całego gniazda (pid = -1), więc zwykle wymagają
+    //  perf_event_paranoid <= 0 lub uprawnień CAP_PERFMON.
+    //-------------------------------------------------------------------
+    const std::string katalog = "/sys/bus/event_source/devices";
+    DIR* d = opendir(katalog.c_str());
+    if (d == nullptr) return;
+
+    int otwarte = 0, urzadzenia = 0;
+    std::string blad;
+    while (dirent* e = readdir(d)) {
+        if (std::strncmp(e->d_name, "uncore_imc", 10) != 0) continue;
+        std::string urzadzenie = katalog + "/" + e->d_name;
+        urzadzenia++;
+
+        uint32_t typ = (uint32_t)std::atoi(czytaj_plik(urzadzenie + "/type").c_str());
+        int cpu = std::atoi(czytaj_plik(urzadzenie + "/cpumask").c_str());
+
+        for (const char* nazwa : {"cas_count_read", "cas_count_write"}) {
+            std::string ev = urzadzenie + "/events/" + nazwa;
+            std::string opis = czytaj_plik(ev);
+            uint64_t config;
+            if (opis.empty() || !koduj_zdarzenie(urzadzenie, opis, config)) continue;
+
+            //  skala: zwykle 6.103515625e-5 z jednostką MiB (64 bajty na zliczenie)
+            double skala = std::atof(czytaj_plik(ev + ".scale").c_str());
+            std::string jednostka = czytaj_plik(ev + ".unit");
+            if (skala <= 0) skala = 64.0;
+            else if (jednostka == "MiB") skala *= 1048576.0;
+
+            perf_event_attr attr;
+            std::memset(&attr, 0, sizeof attr);
+            attr.size = sizeof attr;
+            attr.type = typ;
+            attr.config = config;
+            attr.disabled = 1;
+            attr.read_format = PERF_FORMAT_TOTAL_TIME_ENABLED | PERF_FORMAT_TOTAL_TIME_RUNNING;
+
+            int fd = perf_event_open(&attr, -1, cpu);
+            if (fd < 0) {
+                blad = std::strerror(errno);
+                continue;
+            }
+            fds.push_back(Deskryptor{fd, PAMIEC_BAJTY, skala});
+            otwarte++;
+        }
+    }
+    closedir(d);
+
+    if (urzadzenia == 0) {
+        dodaj_blad(opis_bledow, "bajty_pamieci", "brak liczników uncore_imc");
+    } else if (otwarte == 0) {
+        dodaj_blad(opis_bledow, "bajty_pamieci", blad.empty() ? "brak zdarzeń cas_count" : blad);
+    }
+}
+
+
+
+bool licznikipack::LicznikiSprzetowe::sprzetowe() const {
+    for (const Deskryptor& d : fds) {
+        if (d.z != CZAS_ZADANIA && d.z != BLEDY_STRON) return true;
+    }
+    return false;
+}
+
+
+
+void licznikipack::LicznikiSprzetowe::start() {
+    for (const Deskryptor& d : fds) {
+        ioctl(d.fd, PERF_EVENT_IOC_RESET, 0);
+        ioctl(d.fd, PERF_EVENT_IOC_ENABLE, 0);
+    }
+    start_czas = teraz();
+}
+
+
+
+licznikipack::Wyniki licznikipack::LicznikiSprzetowe::stop() {
+    //-------------------------------------------------------------------
+    //  Suma po wątkach (i urządzeniach uncore); przy multipleksowaniu
+    //  liczników wartość skalowana jest przez czas_włączenia/czas_pracy.
+    //-------------------------------------------------------------------
+    Wyniki w;
+    w.czas = teraz() - start_czas;
+    for (const Deskryptor& d : fds) {
+        ioctl(d.fd, PERF_EVENT_IOC_DISABLE, 0);
+    }
+    for (const Deskryptor& d : fds) {
+        uint64_t dane[3] = {0, 0, 0};
+        if (read(d.fd, dane, sizeof dane) != (ssize_t)sizeof dane) continue;
+        double v = (double)dane[0];
+        if (dane[2] > 0 && dane[2] < dane[1]) v *= (double)dane[1] / (double)dane[2];
+        w.dostepne[d.z] = true;
+        w.wartosc[d.z] += v * d.skala;
+    }
+    return w;
+}
+
+#else
+
+licznikipack::LicznikiSprzetowe::LicznikiSprzetowe(uint64_t) {
+    opis_bledow = "liczniki perf_event_open dostępne tylko w systemie Linux";
+}
+
+licznikipack::LicznikiSprzetowe::~LicznikiSprzetowe() {}
+
+void licznikipack::LicznikiSprzetowe::otworz(Zdarzenie, uint32_t, uint64_t) {}
+
+void licznikipack::LicznikiSprzetowe::otworz_uncore() {}
+
+bool licznikipack::LicznikiSprzetowe::sprzetowe() const { return false; }
+
+void licznikipack::LicznikiSprzetowe::start() { start_czas = teraz(); }
+
+licznikipack::Wyniki licznikipack::LicznikiSprzetowe::stop() {
+    Wyniki w;
+    w.czas = teraz() - start_czas;
+    return w;
+}
+
+#endif
+
+
+
+licznikipack::Wyniki licznikipack::LicznikiSprzetowe::zmierz(const std::function<void()>& f) {
+    start();
+    f();
+    return stop();
+}
+
+
+
+std::vector<std::pair<std::string, double>> licznikipack::jako_pary(const Wyniki& w, double elementy) {
+    std::vector<std::pair<std::string, double>> pary;
+    for (int z = 0; z < LICZBA_ZDARZEN; z++) {
+        if (!w.dostepne[z]) continue;
+        pary.emplace_back(nazwa_zdarzenia((Zdarzenie)z), w.wartosc[z]);
+        if (elementy > 0 && z != CZAS_ZADANIA) {
+            pary.emplace_back(std::string(nazwa_zdarzenia((Zdarzenie)z)) + "_na_element", w.wartosc[z] / elementy);
+        }
+    }
+    if (w.ipc() > 0) pary.emplace_back("IPC", w.ipc());
+    if (w.ma(PAMIEC_BAJTY)) pary.emplace_back("GBs_pamieci", w.gbs_pamieci());
+    return pary;
+}
+
+
+
+void licznikipack::wypisz(std::ostream& out, const Wyniki& w, double elementy, const char* jednostka) {
+    char linia[160];
+    std::snprintf(linia, sizeof linia, "Liczniki (czas pomiaru %.4f s):\n", w.czas);
+    out << linia;
+    bool cokolwiek = false;
+    for (int z = 0; z < LICZBA_ZDARZEN; z++) {
+        if (!w.dostepne[z]) continue;
+        cokolwiek = true;
+        if (elementy > 0) {
+            std::snprintf(linia, sizeof linia, "  %-18s %16.0f  (%.4g na %s)\n",
+                nazwa_zdarzenia((Zdarzenie)z), w.wartosc[z], w.wartosc[z] / elementy, jednostka);
+        } else {
+            std::snprintf(linia, sizeof linia, "  %-18s %16.0f\n", nazwa_zdarzenia((Zdarzenie)z), w.wartosc[z]);
+        }
+        out << linia;
+    }
+    if (!cokolwiek) out << "  brak dostępnych liczników\n";
+    if (w.ipc() > 0) {
+        std::snprintf(linia, sizeof linia, "  IPC %.3f\n", w.ipc());
+        out << linia;
+    }
+    if (w.ma(PAMIEC_BAJTY)) {
+        std::snprintf(linia, sizeof linia, "  przepustowość pamięci %.3f GB/s\n", w.gbs_pamieci());
+        out << linia;
+    }
+}
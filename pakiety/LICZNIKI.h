@@ -0,0 +1,93 @@
+#ifndef __liczniki_h
+#define __liczniki_h
+
+#include <cstdint>
+#include <functional>
+#include <iosfwd>
+#include <string>
+#include <utility>
+#include <vector>
+
+//----------------------------------------------------------------------
+// Pakiet liczników sprzętowych procesora (Linux, perf_event_open):
+// cykle, instrukcje, odwołania i chybienia LLC, opcjonalnie operacje
+// zmiennoprzecinkowe (surowy kod zdarzenia - zależny od procesora)
+// oraz ruch kontrolera pamięci z liczników uncore (uncore_imc,
+// jeśli system na to pozwala). Zawsze próbowane są też liczniki
+// programowe jądra (czas zadania, błędy stron).
+//
+// Liczniki otwierane są osobno (brak jednego nie blokuje pozostałych)
+// dla wszystkich istniejących wątków procesu i dziedziczone przez
+// wątki tworzone później. Niedostępność liczników (kontener, maszyna
+// wirtualna, perf_event_paranoid) nie jest błędem - pomiar zwraca
+// wtedy tylko to, co udało się otworzyć, a komunikat() mówi dlaczego.
+//
+// Uwaga: zdarzenia FP_ARITH procesorów Intel nie obejmują operacji x87,
+// w których liczą jądra long double programu.
+//----------------------------------------------------------------------
+namespace licznikipack{
+
+    enum Zdarzenie {
+        CYKLE, INSTRUKCJE, LLC_ODWOLANIA, LLC_CHYBIENIA, OPERACJE_FP,
+        CZAS_ZADANIA,               //  [ns] licznik programowy
+        BLEDY_STRON,                //  licznik programowy
+        PAMIEC_BAJTY,               //  odczyty + zapisy kontrolera pamięci (uncore)
+        LICZBA_ZDARZEN
+    };
+
+    const char* nazwa_zdarzenia(Zdarzenie z);
+
+    struct Wyniki {
+        bool dostepne[LICZBA_ZDARZEN] = {};
+        double wartosc[LICZBA_ZDARZEN] = {};    //  przeskalowane przy multipleksowaniu
+        double czas = 0;                        //  [s] czas zegarowy pomiaru
+
+        bool ma(Zdarzenie z) const { return dostepne[z]; }
+        double ipc() const;                     //  0, gdy brak cykli lub instrukcji
+        double gbs_pamieci() const;             //  0, gdy brak liczników uncore
+    };
+
+    class LicznikiSprzetowe {
+    public:
+        //  surowe_fp - kod zdarzenia PERF_TYPE_RAW dla operacji FP (0 - bez)
+        explicit LicznikiSprzetowe(uint64_t surowe_fp = 0);
+        ~LicznikiSprzetowe();
+
+        LicznikiSprzetowe(const LicznikiSprzetowe&) = delete;
+        LicznikiSprzetowe& operator=(const LicznikiSprzetowe&) = delete;
+
+        //  czy otwarto którykolwiek licznik sprzętowy (nie programowy)
+        bool sprzetowe() const;
+        //  opis liczników, których nie udało się otworzyć (pusty, gdy wszystkie są)
+        const std::string& komunikat() const { return opis_bledow; }
+
+        void start();
+        Wyniki stop();
+
+        //  start(), f(), stop()
+        Wyniki zmierz(const std::function<void()>& f);
+
+    private:
+        struct Deskryptor {
+            int fd;
+            Zdarzenie z;
+            double skala;           //  mnożnik wartości (uncore: bajty na zliczenie)
+        };
+
+        void otworz(Zdarzenie z, uint32_t typ, uint64_t config);
+        void otworz_uncore();
+
+        std::vector<Deskryptor> fds;
+        std::string opis_bledow;
+        double start_czas = 0;
+    };
+
+    //  Raport: wartości, IPC, wartości na element (np. węzeł-krok) i GB/s
+    void wypisz(std::ostream& out, const Wyniki& w, double elementy = 0, const char* jednostka = "element");
+
+    //  Pary (nazwa, wartość) do zapisu w raportach (np. JSON benchmarku)
+    std::vector<std::pair<std::string, double>> jako_pary(const Wyniki& w, double elementy = 0);
+
+}
+
+#endif
@@ -1,8 +1,12 @@
 #include <stdio.h>
 #include <stdlib.h>
 #include <math.h>
+#include <float.h>
 
 #include "LU.h"
+#include "PRECYZJA.h"
+#include "PROFIL.h"
+#include "THREADS.h"
 
 using namespace std;
 
@@ -25,7 +29,8 @@ void lupack::swap(int* a, int* b) {
 }
 
 
-void lupack::LU_decompose(long double A[], int index[], int N){
+template <typename T>
+void lupack::LU_decompose(T A[], int index[], int N){
     //---------------------------------------------------------------------
 //  Funkcja dokonująca dekompozycji LU macierzy A z częściowym wyborem
 //  elementu podstawowego, ale bez fizycznej zamiany wierszy.
@@ -54,9 +59,16 @@ void lupack::LU_decompose(long double A[], int index[], int N){
 //  elementy macierzy – pamiętamy, że odczytujemy
 //  je zawsze poprzez indeksację: A[index[r]*n+c].
 //---------------------------------------------------------------------
+    PROFIL_ZAKRES("LU: dekompozycja pelna");
 
     
     
+    //  Dla większych macierzy korzystamy z wersji blokowej (wynik identyczny)
+    if (N >= LU_BLOCKED_MIN_N) {
+        lupack::LU_decompose_blocked(A, index, N);
+        return;
+    }
+
     //  Inicjalizacja tablicy index – początkowy porządek naturalny: 0, 1, 2, ..., n-1
     for (int i = 0; i < N; i++) {
         index[i] = i;
@@ -68,23 +80,23 @@ void lupack::LU_decompose(long double A[], int index[], int N){
         
         //  zamiana wiersza (wybór elementu podstawowego) wykonujemy TYLKO wtedy,
         //  gdy bieżący element podstawowy (A[index[k]*n+k]) jest równy 0.
-        if (fabsl(A[index[k] * N + k]) == 0) {
+        if (precyzjapack::modul(A[index[k] * N + k]) == 0) {
             
             //  Gdy obecny el. podstawowy = 0, to szukany jest inny, największy 
             //  spośród pozostałych elementów w kolumnie k:
             
             int swapIndex = k;
-            long double maxVal = fabsl(A[index[k] * N + k]);
+            T maxVal = precyzjapack::modul(A[index[k] * N + k]);
             
             for (int i = k + 1; i < N; i++) {
-                long double val = fabsl(A[index[i] * N + k]);
+                T val = precyzjapack::modul(A[index[i] * N + k]);
                 if (val > maxVal) {
                     maxVal = val;
                     swapIndex = i;
                 }
             }
 
-            if (maxVal == 0.0L) {printf("\nLU-macierz jest osobilwa/bliska osobilwosci.\n"); exit(1);}
+            if (maxVal == T(0)) {printf("\nLU-macierz jest osobilwa/bliska osobilwosci.\n"); exit(1);}
             // Obsłużenie sytuacji, gdy macierz jest osobliwa lub bardzo bliska osobliwości
         
 
@@ -96,7 +108,7 @@ void lupack::LU_decompose(long double A[], int index[], int N){
         
         // Eliminacja Gaussa: dla każdego wirtualnego wiersza poniżej (i = k+1,..., n-1)
         for (int i = k + 1; i < N; i++) {
-            long double multiplier = A[index[i] * N + k] / A[index[k] * N + k];  
+            T multiplier = A[index[i] * N + k] / A[index[k] * N + k];  
             
             // Zapisujemy mnożnik w miejscu elementu A (on stanowi element L, przyjmujemy L[i,k]=multiplier)
             A[index[i] * N + k] = multiplier;
@@ -112,7 +124,8 @@ void lupack::LU_decompose(long double A[], int index[], int N){
 
 
 
-void lupack::LU_solve(long double A[], int index[], long double b[], int N) {
+template <typename T>
+void lupack::LU_solve(T A[], int index[], T b[], int N) {
 //---------------------------------------------------------------------
 //  Funkcja rozwiązująca układ równań Ax = b, wykorzystując wcześniej
 //  wykonaną dekompozycję LU, przy czym wszystkie operacje odbywają się
@@ -147,7 +160,7 @@ void lupack::LU_solve(long double A[], int index[], long double b[], int N) {
 for (int i = 0; i < N; i++) {
     // Inicjujemy zmienną 'sum' wartością elementu b odpowiadającą bieżącemu równaniu, 
     // już przestawionego przez pivoting (indeksowanym przez index[i]).
-    long double sum = b[index[i]];
+    T sum = b[index[i]];
 
     // Odejmujemy wpływ poprzednich elementów (L jest jednostkowa na przekątnej, 
     // a mnożniki są zapisane w A w pozycji: A[index[i] * N + j])
@@ -177,7 +190,7 @@ for (int i = 0; i < N; i++) {
 for (int i = N - 1; i >= 0; i--) {
     // Inicjujemy zmienną 'sum' wartością odpowiadającą elementowi y, który wcześniej zapisaliśmy 
     // w wektorze b w wyniku forward substitution.
-    long double sum = b[index[i]];
+    T sum = b[index[i]];
 
     // Iterujemy po kolumnach dla każdego równania (od i+1 do N-1), 
     // czyli po elementach macierzy U należących do prawej strony przekątnej.
@@ -202,11 +215,30 @@ for (int i = N - 1; i >= 0; i--) {
 }
 
 
+// 3. Po podstawieniach x[i] znajduje się w b[index[i]] - jeśli dekompozycja
+// zamieniała wiersze, przywracamy naturalną kolejność rozwiązania.
+bool permuted = false;
+for (int i = 0; i < N; i++) {
+    if (index[i] != i) { permuted = true; break; }
+}
+if (permuted) {
+    T* x = new T[N];
+    for (int i = 0; i < N; i++) {
+        x[i] = b[index[i]];
+    }
+    for (int i = 0; i < N; i++) {
+        b[i] = x[i];
+    }
+    delete[] x;
 }
 
 
+}
+
 
-void lupack::LU_decompose_and_solve(long double A[], long double b[], int N){
+
+template <typename T>
+void lupack::LU_decompose_and_solve(T A[], T b[], int N){
 //---------------------------------------------------------------------
 //  Funkcja dekomponuje przekazaną macierz na macierze L oraz U,
 //  a następnie rozwiązuje układ równań
@@ -228,4 +260,1139 @@ void lupack::LU_decompose_and_solve(long double A[], long double b[], int N){
     lupack::LU_solve(A, index, b, N);
 
     delete[] index;
-}
\ No newline at end of file
+}
+
+
+template <typename T>
+static inline void schur_kernel_4(T* c, const T* L, const T* P, int kb) {
+//---------------------------------------------------------------------
+//  Mikrojądro aktualizacji dopełnienia Schura dla 4 sąsiednich kolumn
+//  jednego wiersza: c[0..3] -= sum_p L[p] * P[p][0..3]
+//  P jest spakowanym fragmentem U12 (4 kolumny na wiersz panelu).
+//  Odejmowanie wykonywane jest w kolejności p = 0,1,..., tak jak w
+//  algorytmie niezblokowanym - wynik jest bitowo identyczny.
+//---------------------------------------------------------------------
+    T c0 = c[0], c1 = c[1], c2 = c[2], c3 = c[3];
+
+    for (int p = 0; p < kb; p++) {
+        T l = L[p];
+        c0 -= l * P[4 * p + 0];
+        c1 -= l * P[4 * p + 1];
+        c2 -= l * P[4 * p + 2];
+        c3 -= l * P[4 * p + 3];
+    }
+
+    c[0] = c0; c[1] = c1; c[2] = c2; c[3] = c3;
+}
+
+
+
+template <typename T>
+void lupack::LU_decompose_blocked(T A[], int index[], int N, int nb, threadpack::ThreadPool* pool) {
+//---------------------------------------------------------------------
+//  Blokowa (panelowa) wersja dekompozycji LU. Macierz dzielona jest na
+//  panele o szerokości nb kolumn; dla każdego panelu:
+//      1) dekompozycja panelu (kolumny k0..k1-1, wszystkie wiersze >= k0),
+//      2) wyznaczenie bloku U12 (wiersze panelu, kolumny >= k1),
+//      3) aktualizacja dopełnienia Schura A22 -= L21 * U12 mikrojądrem
+//         działającym na spakowanym U12, podzielona między wątki puli.
+//
+//  Wynik (układ L\U w tablicy A i permutacja index[]) jest taki sam jak
+//  w LU_decompose - kolejność operacji zmiennoprzecinkowych na każdym
+//  elemencie jest zachowana, więc LU_solve działa bez zmian.
+//
+//  Argumenty:
+//      A[]             - JEDNOWYMIAROWA tablica zawierająca macierz (porządek wierszowy)
+//      index[]         - Tablica indeksów wirtualnych wierszy (jak w LU_decompose)
+//      N               - Rozmiar macierzy
+//      nb              - szerokość panelu
+//      pool            - pula wątków (nullptr -> threadpack::global_pool())
+//
+//  Zwraca: 
+//      -Nic -> funkcja zamienia wartości bezpośrednio w przekazanych elem.
+//---------------------------------------------------------------------
+    PROFIL_ZAKRES("LU: dekompozycja blokowa");
+
+    if (pool == nullptr) pool = &threadpack::global_pool();
+    if (nb < 1) nb = 1;
+
+    //  liczba pasków 4-kolumnowych U12 przetwarzanych jednorazowo przez wątek
+    //  (blok nb x 4*STRIPS mieści się w pamięci podręcznej L2)
+    const int STRIPS = 64;
+
+    for (int i = 0; i < N; i++) {
+        index[i] = i;
+    }
+
+    //  bufor na spakowany blok U12 (paski po 4 kolumny)
+    T* pack = new T[(long)nb * (N + 4)];
+
+    for (int k0 = 0; k0 < N; k0 += nb) {
+        const int kb = (nb < N - k0) ? nb : N - k0;
+        const int k1 = k0 + kb;
+
+        //------------------------- 1) PANEL ---------------------------
+        for (int k = k0; k < k1; k++) {
+            if (precyzjapack::modul(A[index[k] * N + k]) == 0) {
+                int swapIndex = k;
+                T maxVal = precyzjapack::modul(A[index[k] * N + k]);
+
+                for (int i = k + 1; i < N; i++) {
+                    T val = precyzjapack::modul(A[index[i] * N + k]);
+                    if (val > maxVal) {
+                        maxVal = val;
+                        swapIndex = i;
+                    }
+                }
+
+                if (maxVal == T(0)) {printf("\nLU-macierz jest osobilwa/bliska osobilwosci.\n"); exit(1);}
+
+                if (swapIndex != k) {
+                    lupack::swap(&index[k], &index[swapIndex]);
+                }
+            }
+
+            const T* rk = A + (long)index[k] * N;
+            for (int i = k + 1; i < N; i++) {
+                T* ri = A + (long)index[i] * N;
+                T multiplier = ri[k] / rk[k];
+                ri[k] = multiplier;
+
+                for (int j = k + 1; j < k1; j++) {
+                    ri[j] -= multiplier * rk[j];
+                }
+            }
+        }
+
+        if (k1 == N) break;
+
+        const int ncols   = N - k1;
+        const int nstrips = (ncols + 3) / 4;
+
+        //------------------------- 2) U12 -----------------------------
+        //  podstawianie w przód z L11 (jedynki na przekątnej) - niezależne
+        //  dla każdej kolumny, więc dzielimy kolumny między wątki.
+        //  Od razu pakujemy gotowe U12 w paski po 4 kolumny.
+        pool->parallel_for(0, nstrips, [&](int s_lo, int s_hi) {
+            int j_lo = k1 + 4 * s_lo;
+            int j_hi = k1 + 4 * s_hi;
+            if (j_hi > N) j_hi = N;
+
+            for (int r = k0 + 1; r < k1; r++) {
+                T* rr = A + (long)index[r] * N;
+                for (int p = k0; p < r; p++) {
+                    T l = rr[p];
+                    const T* rp = A + (long)index[p] * N;
+                    for (int j = j_lo; j < j_hi; j++) {
+                        rr[j] -= l * rp[j];
+                    }
+                }
+            }
+
+            for (int s = s_lo; s < s_hi; s++) {
+                T* P = pack + (long)s * kb * 4;
+                for (int p = 0; p < kb; p++) {
+                    const T* rp = A + (long)index[k0 + p] * N;
+                    for (int c = 0; c < 4; c++) {
+                        int j = k1 + 4 * s + c;
+                        P[4 * p + c] = (j < N) ? rp[j] : T(0);
+                    }
+                }
+            }
+        });
+
+        //------------------------- 3) A22 -= L21*U12 ------------------
+        pool->parallel_for(k1, N, [&](int i_lo, int i_hi) {
+            for (int s0 = 0; s0 < nstrips; s0 += STRIPS) {
+                int s1 = (s0 + STRIPS < nstrips) ? s0 + STRIPS : nstrips;
+
+                for (int i = i_lo; i < i_hi; i++) {
+                    T* ri = A + (long)index[i] * N;
+                    const T* L = ri + k0;
+
+                    for (int s = s0; s < s1; s++) {
+                        const T* P = pack + (long)s * kb * 4;
+                        int j = k1 + 4 * s;
+
+                        if (j + 4 <= N) {
+                            schur_kernel_4(ri + j, L, P, kb);
+                        } else {
+                            //  ostatni, niepełny pasek kolumn
+                            for (int c = 0; j + c < N; c++) {
+                                T acc = ri[j + c];
+                                for (int p = 0; p < kb; p++) {
+                                    acc -= L[p] * P[4 * p + c];
+                                }
+                                ri[j + c] = acc;
+                            }
+                        }
+                    }
+                }
+            }
+        });
+    }
+
+    delete[] pack;
+}
+
+
+
+template <typename T>
+lupack::BandMatrixT<T>::BandMatrixT(int N, int kl, int ku) : N(N), kl(kl), ku(ku), ld(2 * kl + ku + 1) {
+//---------------------------------------------------------------------
+//  Alokuje macierz pasmową N x N i wypełnia ją zerami (także miejsce
+//  na wypełnienie powstające podczas dekompozycji).
+//---------------------------------------------------------------------
+    data = new T[(long)N * ld]();
+}
+
+
+
+template <typename T>
+lupack::BandMatrixT<T>::~BandMatrixT() {
+    delete[] data;
+}
+
+
+
+template <typename T>
+void lupack::LU_decompose(BandMatrixT<T>& A, int index[]) {
+//---------------------------------------------------------------------
+//  Dekompozycja LU macierzy pasmowej. Eliminacja obejmuje wyłącznie
+//  elementy pasma, więc koszt wynosi O(N*kl*(kl+ku)) zamiast O(N^3).
+//
+//  Tak jak w wersji dla macierzy pełnej, wiersze zamieniane są TYLKO
+//  wtedy, gdy bieżący element podstawowy jest równy 0. Zamiana jest
+//  tu fizyczna (ale tylko dla kolumn >= k), a index[k] zapamiętuje
+//  numer wiersza zamienionego z wierszem k w k-tym kroku.
+//
+//  Argumenty:
+//      A               - macierz pasmowa; po wykonaniu funkcji zawiera
+//                        mnożniki L (pod przekątną, L[i,i]=1 niejawnie)
+//                        oraz macierz U (wraz z ewentualnym wypełnieniem)
+//
+//      index[]         - tablica (rozmiar N) numerów wierszy zamienionych
+//                        w kolejnych krokach eliminacji
+//
+//  Zwraca: 
+//      -Nic -> funkcja zamienia wartości bezpośrednio w przekazanych elem.
+//---------------------------------------------------------------------
+    PROFIL_ZAKRES("LU: dekompozycja pasmowa");
+
+    const int N = A.N;
+
+    //  ju - ostatnia kolumna, w której mogą znajdować się niezerowe
+    //  elementy bieżącego wiersza (rośnie przy zamianach wierszy)
+    int ju = 0;
+
+    for (int k = 0; k < N; k++) {
+
+        //  liczba wierszy pod przekątną, które mają niezerowy element w kolumnie k
+        int km = (A.kl < N - 1 - k) ? A.kl : N - 1 - k;
+
+        int p = k;
+        if (precyzjapack::modul(A.at(k, k)) == 0) {
+            
+            //  Gdy obecny el. podstawowy = 0, to szukany jest inny, największy 
+            //  spośród pozostałych elementów w kolumnie k (w obrębie pasma):
+            T maxVal = T(0);
+            
+            for (int i = k + 1; i <= k + km; i++) {
+                T val = precyzjapack::modul(A.at(i, k));
+                if (val > maxVal) {
+                    maxVal = val;
+                    p = i;
+                }
+            }
+
+            if (maxVal == T(0)) {printf("\nLU-macierz jest osobilwa/bliska osobilwosci.\n"); exit(1);}
+        }
+        index[k] = p;
+
+        int ju_k = (p + A.ku < N - 1) ? p + A.ku : N - 1;
+        if (ju_k > ju) ju = ju_k;
+
+        if (p != k) {
+            //  fizyczna zamiana wierszy k oraz p (tylko część od kolumny k)
+            for (int j = k; j <= ju; j++) {
+                T temp = A.at(k, j);
+                A.at(k, j) = A.at(p, j);
+                A.at(p, j) = temp;
+            }
+        }
+
+        // Eliminacja Gaussa w obrębie pasma
+        T pivot = A.at(k, k);
+        for (int i = k + 1; i <= k + km; i++) {
+            T multiplier = A.at(i, k) / pivot;
+            A.at(i, k) = multiplier;
+
+            for (int j = k + 1; j <= ju; j++) {
+                A.at(i, j) -= multiplier * A.at(k, j);
+            }
+        }
+    }
+}
+
+
+
+template <typename T>
+void lupack::LU_solve(const BandMatrixT<T>& A, const int index[], T b[]) {
+//---------------------------------------------------------------------
+//  Rozwiązanie układu Ax = b przy użyciu dekompozycji LU macierzy
+//  pasmowej (wynik funkcji LU_decompose dla BandMatrix).
+//      1) Podstawienie w przód: zamiany wierszy z index[] stosowane są
+//         krok po kroku, tak jak podczas dekompozycji,
+//      2) Podstawienie wstecz: U*x = y (U ma szerokość kl+ku nad przekątną).
+//  Wynik (rozwiązanie x) jest zapisywany w tablicy b.
+//
+//  Argumenty:
+//      A               - zdekomponowana macierz pasmowa
+//      index[]         - tablica zamian wierszy z LU_decompose
+//      b[]             - tablica wyrazów wolnych (do niej także zapisywane rozwiązania)
+//
+//  Zwraca: 
+//      Nic -> funkcja zamienia wartości bezpośrednio w przekazanych elem.
+//---------------------------------------------------------------------
+
+    const int N = A.N;
+    const int ku_fill = A.kl + A.ku;
+
+    // 1. Forward substitution
+    for (int k = 0; k < N; k++) {
+        int p = index[k];
+        if (p != k) {
+            T temp = b[k];
+            b[k] = b[p];
+            b[p] = temp;
+        }
+
+        int km = (A.kl < N - 1 - k) ? A.kl : N - 1 - k;
+        for (int i = k + 1; i <= k + km; i++) {
+            b[i] -= A.at(i, k) * b[k];
+        }
+    }
+
+    // 2. Backward substitution
+    for (int i = N - 1; i >= 0; i--) {
+        T sum = b[i];
+        int jmax = (i + ku_fill < N - 1) ? i + ku_fill : N - 1;
+
+        for (int j = i + 1; j <= jmax; j++) {
+            sum -= A.at(i, j) * b[j];
+        }
+        b[i] = sum / A.at(i, i);
+    }
+}
+
+
+
+template <typename T>
+T lupack::LU_solve(const BandMatrixT<T>& A, const int index[], T b[], const T x_ref[]) {
+//---------------------------------------------------------------------
+//  Jak LU_solve dla BandMatrix, dodatkowo każde x[i] porównywane jest
+//  z x_ref[i] zaraz po obliczeniu w podstawianiu wstecznym.
+//
+//  Zwraca: 
+//      max |x[i] - x_ref[i]|
+//---------------------------------------------------------------------
+
+    const int N = A.N;
+    const int ku_fill = A.kl + A.ku;
+
+    // 1. Forward substitution
+    for (int k = 0; k < N; k++) {
+        int p = index[k];
+        if (p != k) {
+            T temp = b[k];
+            b[k] = b[p];
+            b[p] = temp;
+        }
+
+        int km = (A.kl < N - 1 - k) ? A.kl : N - 1 - k;
+        for (int i = k + 1; i <= k + km; i++) {
+            b[i] -= A.at(i, k) * b[k];
+        }
+    }
+
+    // 2. Backward substitution + błąd
+    T max_err = T(0);
+    for (int i = N - 1; i >= 0; i--) {
+        T sum = b[i];
+        int jmax = (i + ku_fill < N - 1) ? i + ku_fill : N - 1;
+
+        for (int j = i + 1; j <= jmax; j++) {
+            sum -= A.at(i, j) * b[j];
+        }
+        b[i] = sum / A.at(i, i);
+
+        T e = precyzjapack::modul(b[i] - x_ref[i]);
+        precyzjapack::max_bledu(max_err, e);
+    }
+    return max_err;
+}
+
+
+
+template <typename T>
+void lupack::LU_decompose_and_solve(BandMatrixT<T>& A, T b[]) {
+//---------------------------------------------------------------------
+//  Funkcja dekomponuje przekazaną macierz pasmową na macierze L oraz U,
+//  a następnie rozwiązuje układ równań
+//
+//  Argumenty:
+//      A               - macierz pasmowa (modyfikowana w miejscu)
+//      b[]             - tablica wyrazów wolnych (do niej także zapisywane rozwiązania)
+//
+//  Zwraca: 
+//      Nic -> funkcja zamienia wartości bezpośrednio w przekazanych elem.
+//---------------------------------------------------------------------
+
+    int* index = new int[A.N];
+
+    lupack::LU_decompose(A, index);
+    lupack::LU_solve(A, index, b);
+
+    delete[] index;
+}
+
+
+
+template <typename T>
+lupack::LU_factorizationT<T>::LU_factorizationT(const T A[], int N) : N(N), band(nullptr) {
+//---------------------------------------------------------------------
+//  Kopiuje macierz pełną A (N x N, porządek wierszowy) i wykonuje jej
+//  dekompozycję LU. Przekazana tablica nie jest modyfikowana.
+//---------------------------------------------------------------------
+    this->A = new T[(long)N * N];
+    for (long i = 0; i < (long)N * N; i++) {
+        this->A[i] = A[i];
+    }
+    index = new int[N];
+
+    lupack::LU_decompose(this->A, index, N);
+}
+
+
+
+template <typename T>
+lupack::LU_factorizationT<T>::LU_factorizationT(const BandMatrixT<T>& A) : N(A.N), A(nullptr) {
+//---------------------------------------------------------------------
+//  Kopiuje macierz pasmową A i wykonuje jej dekompozycję LU.
+//  Przekazana macierz nie jest modyfikowana.
+//---------------------------------------------------------------------
+    band = new BandMatrixT<T>(A.N, A.kl, A.ku);
+    for (long i = 0; i < (long)A.N * A.ld; i++) {
+        band->data[i] = A.data[i];
+    }
+    index = new int[N];
+
+    lupack::LU_decompose(*band, index);
+}
+
+
+
+template <typename T>
+lupack::LU_factorizationT<T>::~LU_factorizationT() {
+    delete[] A;
+    delete band;
+    delete[] index;
+}
+
+
+
+template <typename T>
+void lupack::LU_solve(const LU_factorizationT<T>& F, T b[]) {
+//---------------------------------------------------------------------
+//  Rozwiązuje układ Ax = b przy użyciu gotowej dekompozycji F.
+//  Wynik zapisywany jest w tablicy b.
+//---------------------------------------------------------------------
+    if (F.band != nullptr) {
+        lupack::LU_solve(*F.band, F.index, b);
+    } else {
+        lupack::LU_solve(F.A, F.index, b, F.N);
+    }
+}
+
+
+
+template <typename T>
+std::shared_ptr<const lupack::LU_factorizationT<T>> lupack::LU_cacheT<T>::get(int N,
+        const std::vector<long double>& coef, const std::function<LU_factorizationT<T>*()>& build) {
+//---------------------------------------------------------------------
+//  Argumenty:
+//      N       - rozmiar macierzy
+//      coef    - współczynniki jednoznacznie wyznaczające macierz
+//      build   - funkcja budująca nową dekompozycję (wywoływana tylko
+//                przy braku wpisu w pamięci podręcznej)
+//
+//  Zwraca: dekompozycję odpowiadającą kluczowi (N, coef)
+//
+//  Dekompozycja budowana jest poza sekcją krytyczną - wątki pobierające
+//  różne klucze nie czekają na siebie. Gdy dwa wątki zbudują ten sam
+//  klucz jednocześnie, zapamiętywana jest pierwsza dekompozycja.
+//---------------------------------------------------------------------
+    auto szukaj = [&]() -> std::shared_ptr<const LU_factorizationT<T>> {
+        for (auto it = entries.begin(); it != entries.end(); ++it) {
+            if (it->N == N && it->coef == coef) {
+                //  przeniesienie wpisu na początek listy (ostatnio używany)
+                entries.splice(entries.begin(), entries, it);
+                return entries.front().F;
+            }
+        }
+        return nullptr;
+    };
+
+    {
+        std::lock_guard<std::mutex> lock(mtx);
+        std::shared_ptr<const LU_factorizationT<T>> F = szukaj();
+        if (F) return F;
+    }
+
+    std::shared_ptr<const LU_factorizationT<T>> F(build());
+
+    std::lock_guard<std::mutex> lock(mtx);
+    std::shared_ptr<const LU_factorizationT<T>> G = szukaj();
+    if (G) return G;
+    entries.push_front(Entry{N, coef, F});
+
+    while ((int)entries.size() > capacity) {
+        entries.pop_back();
+    }
+    return F;
+}
+
+
+
+template <typename T>
+void lupack::LU_cacheT<T>::clear() {
+    std::lock_guard<std::mutex> lock(mtx);
+    entries.clear();
+}
+
+
+
+template <typename T>
+T lupack::LU_solve(const LU_factorizationT<T>& F, T b[], const T x_ref[]) {
+//---------------------------------------------------------------------
+//  Rozwiązuje układ Ax = b przy użyciu gotowej dekompozycji F i zwraca
+//  max |x[i] - x_ref[i]|. Wynik zapisywany jest w tablicy b.
+//---------------------------------------------------------------------
+    if (F.band != nullptr) {
+        return lupack::LU_solve(*F.band, F.index, b, x_ref);
+    }
+
+    lupack::LU_solve(F.A, F.index, b, F.N);
+    T max_err = T(0);
+    for (int i = 0; i < F.N; i++) {
+        T e = precyzjapack::modul(b[i] - x_ref[i]);
+        precyzjapack::max_bledu(max_err, e);
+    }
+    return max_err;
+}
+
+
+
+template <typename TF>
+lupack::LU_refinementT<TF>::LU_refinementT(const long double A[], int N, int max_iter)
+    : N(N), band(nullptr), norm_A(0.0L), max_iter(max_iter) {
+//---------------------------------------------------------------------
+//  Kopiuje macierz pełną A (do residuów), wyznacza ||A|| i wykonuje
+//  dekompozycję LU macierzy zaokrąglonej do TF.
+//---------------------------------------------------------------------
+    PROFIL_ZAKRES("LU: dekompozycja mieszana");
+
+    this->A = new long double[(long)N * N];
+    TF* A_TF = new TF[(long)N * N];
+    for (int i = 0; i < N; i++) {
+        long double suma = 0.0L;
+        for (int j = 0; j < N; j++) {
+            long double a = A[(long)i * N + j];
+            this->A[(long)i * N + j] = a;
+            A_TF[(long)i * N + j] = static_cast<TF>(a);
+            suma += fabsl(a);
+        }
+        if (suma > norm_A) norm_A = suma;
+    }
+
+    F = new LU_factorizationT<TF>(A_TF, N);
+    delete[] A_TF;
+
+    x = new long double[N];
+    r = new long double[N];
+    d = new TF[N];
+}
+
+
+
+template <typename TF>
+lupack::LU_refinementT<TF>::LU_refinementT(const BandMatrix& A, int max_iter)
+    : N(A.N), A(nullptr), norm_A(0.0L), max_iter(max_iter) {
+//---------------------------------------------------------------------
+//  Jak wyżej, dla macierzy pasmowej (kopiowane jest całe pasmo).
+//---------------------------------------------------------------------
+    PROFIL_ZAKRES("LU: dekompozycja mieszana");
+
+    band = new BandMatrix(A.N, A.kl, A.ku);
+    BandMatrixT<TF> A_TF(A.N, A.kl, A.ku);
+    for (long i = 0; i < (long)A.N * A.ld; i++) {
+        band->data[i] = A.data[i];
+        A_TF.data[i] = static_cast<TF>(A.data[i]);
+    }
+    for (int i = 0; i < N; i++) {
+        int jmin = (i - A.kl > 0) ? i - A.kl : 0;
+        int jmax = (i + A.ku < N - 1) ? i + A.ku : N - 1;
+        long double suma = 0.0L;
+        for (int j = jmin; j <= jmax; j++) {
+            suma += fabsl(A.at(i, j));
+        }
+        if (suma > norm_A) norm_A = suma;
+    }
+
+    F = new LU_factorizationT<TF>(A_TF);
+
+    x = new long double[N];
+    r = new long double[N];
+    d = new TF[N];
+}
+
+
+
+template <typename TF>
+lupack::LU_refinementT<TF>::~LU_refinementT() {
+    delete[] A;
+    delete band;
+    delete F;
+    delete[] x;
+    delete[] r;
+    delete[] d;
+}
+
+
+
+template <typename TF>
+static long double residuum(const lupack::LU_refinementT<TF>& F, const long double b[], const long double x[],
+        long double r[]) {
+//---------------------------------------------------------------------
+//  r = b - A x dla oryginalnej macierzy A (long double)
+//
+//  Zwraca: ||r|| (maksimum modułów)
+//---------------------------------------------------------------------
+    const int N = F.N;
+    long double norma = 0.0L;
+
+    for (int i = 0; i < N; i++) {
+        long double suma = b[i];
+        if (F.band != nullptr) {
+            const lupack::BandMatrix& A = *F.band;
+            int jmin = (i - A.kl > 0) ? i - A.kl : 0;
+            int jmax = (i + A.ku < N - 1) ? i + A.ku : N - 1;
+            for (int j = jmin; j <= jmax; j++) {
+                suma -= A.at(i, j) * x[j];
+            }
+        } else {
+            const long double* wiersz = F.A + (long)i * N;
+            for (int j = 0; j < N; j++) {
+                suma -= wiersz[j] * x[j];
+            }
+        }
+        r[i] = suma;
+        if (fabsl(suma) > norma) norma = fabsl(suma);
+    }
+    return norma;
+}
+
+
+
+template <typename TF>
+int lupack::LU_solve(const LU_refinementT<TF>& F, long double b[]) {
+//---------------------------------------------------------------------
+//  Rozwiązanie układu Ax = b z dekompozycją w precyzji TF i poprawkami
+//  liczonymi z residuum w long double (opis kryterium w LU.h).
+//
+//  Argumenty:
+//      F       - macierz i jej dekompozycja w precyzji TF
+//      b[]     - tablica wyrazów wolnych (do niej zapisywane jest rozwiązanie)
+//
+//  Zwraca:
+//      liczbę poprawek (0 - wystarczyło rozwiązanie w TF) albo -1, gdy
+//      poprawianie nie jest zbieżne w F.max_iter krokach
+//---------------------------------------------------------------------
+    PROFIL_ZAKRES("LU: rozwiazanie z poprawkami");
+
+    const int N = F.N;
+    long double* x = F.x;
+    long double* r = F.r;
+    TF* d = F.d;
+
+    //  przybliżenie początkowe: rozwiązanie w precyzji TF
+    for (int i = 0; i < N; i++) d[i] = static_cast<TF>(b[i]);
+    lupack::LU_solve(*F.F, d);
+    for (int i = 0; i < N; i++) x[i] = static_cast<long double>(d[i]);
+
+    const long double tol = F.norm_A * LDBL_EPSILON * sqrtl((long double)N);
+    int iter = 0;
+    for (;;) {
+        long double norma_r = residuum(F, b, x, r);
+        long double norma_x = 0.0L;
+        for (int i = 0; i < N; i++) {
+            if (fabsl(x[i]) > norma_x) norma_x = fabsl(x[i]);
+        }
+        if (norma_r <= norma_x * tol) break;
+        if (iter == F.max_iter) {
+            iter = -1;
+            break;
+        }
+
+        //  poprawka: A d = r w precyzji TF
+        for (int i = 0; i < N; i++) d[i] = static_cast<TF>(r[i]);
+        lupack::LU_solve(*F.F, d);
+        for (int i = 0; i < N; i++) x[i] += static_cast<long double>(d[i]);
+        iter++;
+    }
+
+    for (int i = 0; i < N; i++) b[i] = x[i];
+    return iter;
+}
+
+
+
+template <typename T>
+lupack::SymBandMatrixT<T>::SymBandMatrixT(int N, int k) : N(N), k(k), ld(k + 1) {
+//---------------------------------------------------------------------
+//  Alokuje symetryczną macierz pasmową N x N (dolne pasmo) i wypełnia
+//  ją zerami. Dekompozycja LDL^T nie powoduje wypełnienia poza pasmem.
+//---------------------------------------------------------------------
+    data = new T[(long)N * ld]();
+}
+
+
+
+template <typename T>
+lupack::SymBandMatrixT<T>::~SymBandMatrixT() {
+    delete[] data;
+}
+
+
+
+template <typename T>
+void lupack::LDLT_decompose(T AP[], int n) {
+//---------------------------------------------------------------------
+//  Dekompozycja LDL^T macierzy symetrycznej pełnej, przechowywanej jako
+//  dolny trójkąt wierszami (AP[i*(i+1)/2 + j], j <= i). Wiersz i liczony
+//  jest z gotowych wierszy 0..i-1 (wariant Crouta):
+//      w_j = A(i,j) - sum_{m<j} w_m L(j,m)     (w_j = L(i,j) D_j),
+//      L(i,j) = w_j / D_j,   D_i = A(i,i) - sum_{j<i} L(i,j) w_j
+//  Pętla wewnętrzna to iloczyn skalarny dwóch ciągłych fragmentów wierszy.
+//
+//  Argumenty:
+//      AP[]            - dolny trójkąt macierzy; po wykonaniu funkcji zawiera
+//                        D (na przekątnej) oraz mnożniki L (pod przekątną)
+//      n               - rozmiar macierzy
+//
+//  Zwraca:
+//      Nic -> funkcja zamienia wartości bezpośrednio w przekazanych elem.
+//---------------------------------------------------------------------
+    PROFIL_ZAKRES("LDLT: dekompozycja pelna");
+
+    for (int i = 0; i < n; i++) {
+        T* Li = AP + (long)i * (i + 1) / 2;
+
+        for (int j = 0; j < i; j++) {
+            const T* Lj = AP + (long)j * (j + 1) / 2;
+            T s = Li[j];
+            for (int m = 0; m < j; m++) {
+                s -= Li[m] * Lj[m];
+            }
+            Li[j] = s;
+        }
+
+        T d = Li[i];
+        for (int j = 0; j < i; j++) {
+            T l = Li[j] / AP[(long)j * (j + 1) / 2 + j];
+            d -= l * Li[j];
+            Li[j] = l;
+        }
+
+        if (precyzjapack::modul(d) == 0) {printf("\nLDLT-zerowy element macierzy D (macierz nie jest dodatnio okreslona).\n"); exit(1);}
+        Li[i] = d;
+    }
+}
+
+
+
+template <typename T>
+void lupack::LDLT_solve(const T AP[], T b[], int n) {
+//---------------------------------------------------------------------
+//  Rozwiązanie układu Ax = b przy użyciu dekompozycji LDL^T macierzy
+//  pełnej (wynik LDLT_decompose):
+//      1) L y = b (podstawienie w przód),  2) z = D^-1 y,
+//      3) L^T x = z (podstawienie wstecz: po wyznaczeniu x[i] odejmowany
+//         jest wiersz i macierzy L, czyli kolumna L^T).
+//  Wynik (rozwiązanie x) jest zapisywany w tablicy b.
+//---------------------------------------------------------------------
+
+    // 1. Forward substitution
+    for (int i = 1; i < n; i++) {
+        const T* Li = AP + (long)i * (i + 1) / 2;
+        T s = b[i];
+        for (int j = 0; j < i; j++) {
+            s -= Li[j] * b[j];
+        }
+        b[i] = s;
+    }
+
+    // 2. Diagonal
+    for (int i = 0; i < n; i++) {
+        b[i] /= AP[(long)i * (i + 1) / 2 + i];
+    }
+
+    // 3. Backward substitution
+    for (int i = n - 1; i > 0; i--) {
+        const T* Li = AP + (long)i * (i + 1) / 2;
+        T x = b[i];
+        for (int j = 0; j < i; j++) {
+            b[j] -= Li[j] * x;
+        }
+    }
+}
+
+
+
+template <typename T>
+void lupack::LDLT_decompose(SymBandMatrixT<T>& A) {
+//---------------------------------------------------------------------
+//  Dekompozycja LDL^T symetrycznej macierzy pasmowej - jak dla macierzy
+//  pełnej, z sumami ograniczonymi do pasma (wiersz i zaczyna się od
+//  kolumny i-k). Koszt O(N k^2), bez wypełnienia.
+//
+//  Argumenty:
+//      A               - macierz pasmowa; po wykonaniu funkcji zawiera
+//                        D (na przekątnej) oraz mnożniki L (pod przekątną)
+//
+//  Zwraca:
+//      Nic -> funkcja zamienia wartości bezpośrednio w przekazanych elem.
+//---------------------------------------------------------------------
+    PROFIL_ZAKRES("LDLT: dekompozycja pasmowa");
+
+    const int N = A.N;
+
+    for (int i = 0; i < N; i++) {
+        int j0 = (i - A.k > 0) ? i - A.k : 0;
+
+        for (int j = j0; j < i; j++) {
+            T s = A.at(i, j);
+            for (int m = j0; m < j; m++) {
+                s -= A.at(i, m) * A.at(j, m);
+            }
+            A.at(i, j) = s;
+        }
+
+        T d = A.at(i, i);
+        for (int j = j0; j < i; j++) {
+            T l = A.at(i, j) / A.at(j, j);
+            d -= l * A.at(i, j);
+            A.at(i, j) = l;
+        }
+
+        if (precyzjapack::modul(d) == 0) {printf("\nLDLT-zerowy element macierzy D (macierz nie jest dodatnio okreslona).\n"); exit(1);}
+        A.at(i, i) = d;
+    }
+}
+
+
+
+template <typename T>
+void lupack::LDLT_solve(const SymBandMatrixT<T>& A, T b[]) {
+//---------------------------------------------------------------------
+//  Rozwiązanie układu Ax = b przy użyciu dekompozycji LDL^T macierzy
+//  pasmowej (kroki jak dla macierzy pełnej, w obrębie pasma).
+//  Wynik (rozwiązanie x) jest zapisywany w tablicy b.
+//---------------------------------------------------------------------
+    const int N = A.N;
+
+    // 1. Forward substitution
+    for (int i = 1; i < N; i++) {
+        int j0 = (i - A.k > 0) ? i - A.k : 0;
+        T s = b[i];
+        for (int j = j0; j < i; j++) {
+            s -= A.at(i, j) * b[j];
+        }
+        b[i] = s;
+    }
+
+    // 2. Diagonal
+    for (int i = 0; i < N; i++) {
+        b[i] /= A.at(i, i);
+    }
+
+    // 3. Backward substitution
+    for (int i = N - 1; i >= 0; i--) {
+        int j0 = (i - A.k > 0) ? i - A.k : 0;
+        T x = b[i];
+        for (int j = j0; j < i; j++) {
+            b[j] -= A.at(i, j) * x;
+        }
+    }
+}
+
+
+
+template <typename T>
+T lupack::LDLT_solve(const SymBandMatrixT<T>& A, T b[], const T x_ref[]) {
+//---------------------------------------------------------------------
+//  Jak LDLT_solve dla SymBandMatrix, dodatkowo każde x[i] porównywane
+//  jest z x_ref[i] zaraz po obliczeniu w podstawianiu wstecznym.
+//
+//  Zwraca:
+//      max |x[i] - x_ref[i]|
+//---------------------------------------------------------------------
+    const int N = A.N;
+
+    // 1. Forward substitution
+    for (int i = 1; i < N; i++) {
+        int j0 = (i - A.k > 0) ? i - A.k : 0;
+        T s = b[i];
+        for (int j = j0; j < i; j++) {
+            s -= A.at(i, j) * b[j];
+        }
+        b[i] = s;
+    }
+
+    // 2. Diagonal
+    for (int i = 0; i < N; i++) {
+        b[i] /= A.at(i, i);
+    }
+
+    // 3. Backward substitution + błąd (x[i] jest ostateczne po
+    //    uwzględnieniu wierszy i+1..i+k, czyli na początku kroku i)
+    T max_err = T(0);
+    for (int i = N - 1; i >= 0; i--) {
+        int j0 = (i - A.k > 0) ? i - A.k : 0;
+        T x = b[i];
+        for (int j = j0; j < i; j++) {
+            b[j] -= A.at(i, j) * x;
+        }
+
+        T e = precyzjapack::modul(x - x_ref[i]);
+        precyzjapack::max_bledu(max_err, e);
+    }
+    return max_err;
+}
+
+
+
+template <typename T>
+void lupack::LDLT_decompose_tridiagonal(T d[], T e[], int n) {
+//---------------------------------------------------------------------
+//  Dekompozycja LDL^T symetrycznej macierzy trójdiagonalnej:
+//      l_i = e_i / D_i,   D_{i+1} = d_{i+1} - l_i e_i
+//
+//  Argumenty:
+//      d[]             - przekątna (n); po wykonaniu funkcji zawiera D
+//      e[]             - przekątna pod główną (n-1); po wykonaniu - mnożniki L
+//      n               - rozmiar macierzy
+//
+//  Zwraca:
+//      Nic -> funkcja zamienia wartości bezpośrednio w przekazanych elem.
+//---------------------------------------------------------------------
+    PROFIL_ZAKRES("LDLT: dekompozycja trojdiagonalna");
+
+    for (int i = 0; i < n - 1; i++) {
+        if (precyzjapack::modul(d[i]) == 0) {printf("\nLDLT-zerowy element macierzy D (macierz nie jest dodatnio okreslona).\n"); exit(1);}
+        T l = e[i] / d[i];
+        d[i + 1] -= l * e[i];
+        e[i] = l;
+    }
+    if (precyzjapack::modul(d[n - 1]) == 0) {printf("\nLDLT-zerowy element macierzy D (macierz nie jest dodatnio okreslona).\n"); exit(1);}
+}
+
+
+
+template <typename T>
+void lupack::LDLT_solve_tridiagonal(const T d[], const T e[], T b[], int n) {
+//---------------------------------------------------------------------
+//  Rozwiązanie układu Ax = b przy użyciu dekompozycji LDL^T macierzy
+//  trójdiagonalnej (wynik LDLT_decompose_tridiagonal). Wynik w b.
+//---------------------------------------------------------------------
+
+    // 1. Forward substitution
+    for (int i = 1; i < n; i++) {
+        b[i] -= e[i - 1] * b[i - 1];
+    }
+
+    // 2. Diagonal + 3. Backward substitution
+    b[n - 1] = b[n - 1] / d[n - 1];
+    for (int i = n - 2; i >= 0; i--) {
+        b[i] = b[i] / d[i] - e[i] * b[i + 1];
+    }
+}
+
+
+
+template <typename T>
+T lupack::LDLT_solve_tridiagonal(const T d[], const T e[], T b[], int n, const T x_ref[]) {
+//---------------------------------------------------------------------
+//  Jak LDLT_solve_tridiagonal, dodatkowo zwraca max |x[i] - x_ref[i]|
+//  (liczony w podstawianiu wstecznym).
+//---------------------------------------------------------------------
+
+    // 1. Forward substitution
+    for (int i = 1; i < n; i++) {
+        b[i] -= e[i - 1] * b[i - 1];
+    }
+
+    // 2. Diagonal + 3. Backward substitution + błąd
+    b[n - 1] = b[n - 1] / d[n - 1];
+    T max_err = precyzjapack::modul(b[n - 1] - x_ref[n - 1]);
+    for (int i = n - 2; i >= 0; i--) {
+        b[i] = b[i] / d[i] - e[i] * b[i + 1];
+
+        T err = precyzjapack::modul(b[i] - x_ref[i]);
+        precyzjapack::max_bledu(max_err, err);
+    }
+    return max_err;
+}
+
+
+
+template <typename T>
+lupack::LDLT_factorizationT<T>::LDLT_factorizationT(const T AP[], int N)
+    : N(N), band(nullptr), d(nullptr), e(nullptr) {
+//---------------------------------------------------------------------
+//  Kopiuje dolny trójkąt macierzy pełnej (N(N+1)/2 elementów) i wykonuje
+//  jego dekompozycję LDL^T. Przekazana tablica nie jest modyfikowana.
+//---------------------------------------------------------------------
+    const long rozmiar = (long)N * (N + 1) / 2;
+    this->AP = new T[rozmiar];
+    for (long i = 0; i < rozmiar; i++) {
+        this->AP[i] = AP[i];
+    }
+
+    lupack::LDLT_decompose(this->AP, N);
+}
+
+
+
+template <typename T>
+lupack::LDLT_factorizationT<T>::LDLT_factorizationT(const SymBandMatrixT<T>& A)
+    : N(A.N), AP(nullptr), d(nullptr), e(nullptr) {
+//---------------------------------------------------------------------
+//  Kopiuje symetryczną macierz pasmową A i wykonuje jej dekompozycję
+//  LDL^T. Przekazana macierz nie jest modyfikowana.
+//---------------------------------------------------------------------
+    band = new SymBandMatrixT<T>(A.N, A.k);
+    for (long i = 0; i < (long)A.N * A.ld; i++) {
+        band->data[i] = A.data[i];
+    }
+
+    lupack::LDLT_decompose(*band);
+}
+
+
+
+template <typename T>
+lupack::LDLT_factorizationT<T>::LDLT_factorizationT(const T d[], const T e[], int N)
+    : N(N), AP(nullptr), band(nullptr) {
+//---------------------------------------------------------------------
+//  Kopiuje przekątne d (N) i e (N-1) symetrycznej macierzy
+//  trójdiagonalnej i wykonuje jej dekompozycję LDL^T.
+//---------------------------------------------------------------------
+    this->d = new T[N];
+    this->e = new T[N > 1 ? N - 1 : 1];
+    for (int i = 0; i < N; i++) this->d[i] = d[i];
+    for (int i = 0; i < N - 1; i++) this->e[i] = e[i];
+
+    lupack::LDLT_decompose_tridiagonal(this->d, this->e, N);
+}
+
+
+
+template <typename T>
+lupack::LDLT_factorizationT<T>::~LDLT_factorizationT() {
+    delete[] AP;
+    delete band;
+    delete[] d;
+    delete[] e;
+}
+
+
+
+template <typename T>
+void lupack::LDLT_solve(const LDLT_factorizationT<T>& F, T b[]) {
+//---------------------------------------------------------------------
+//  Rozwiązuje układ Ax = b przy użyciu gotowej dekompozycji F.
+//  Wynik zapisywany jest w tablicy b.
+//---------------------------------------------------------------------
+    if (F.d != nullptr) {
+        lupack::LDLT_solve_tridiagonal(F.d, F.e, b, F.N);
+    } else if (F.band != nullptr) {
+        lupack::LDLT_solve(*F.band, b);
+    } else {
+        lupack::LDLT_solve(F.AP, b, F.N);
+    }
+}
+
+
+
+template <typename T>
+T lupack::LDLT_solve(const LDLT_factorizationT<T>& F, T b[], const T x_ref[]) {
+//---------------------------------------------------------------------
+//  Rozwiązuje układ Ax = b przy użyciu gotowej dekompozycji F i zwraca
+//  max |x[i] - x_ref[i]|. Wynik zapisywany jest w tablicy b.
+//---------------------------------------------------------------------
+    if (F.d != nullptr) {
+        return lupack::LDLT_solve_tridiagonal(F.d, F.e, b, F.N, x_ref);
+    }
+    if (F.band != nullptr) {
+        return lupack::LDLT_solve(*F.band, b, x_ref);
+    }
+
+    lupack::LDLT_solve(F.AP, b, F.N);
+    T max_err = T(0);
+    for (int i = 0; i < F.N; i++) {
+        T err = precyzjapack::modul(b[i] - x_ref[i]);
+        precyzjapack::max_bledu(max_err, err);
+    }
+    return max_err;
+}
+
+
+
+//  Jawne instancje dla wszystkich typów skalarnych (PRECYZJA.h)
+#define LU_INSTANCJE(T) \
+    template void lupack::LU_decompose<T>(T[], int[], int); \
+    template void lupack::LU_solve<T>(T[], int[], T[], int); \
+    template void lupack::LU_decompose_and_solve<T>(T[], T[], int); \
+    template void lupack::LU_decompose_blocked<T>(T[], int[], int, int, threadpack::ThreadPool*); \
+    template struct lupack::BandMatrixT<T>; \
+    template void lupack::LU_decompose<T>(BandMatrixT<T>&, int[]); \
+    template void lupack::LU_solve<T>(const BandMatrixT<T>&, const int[], T[]); \
+    template T lupack::LU_solve<T>(const BandMatrixT<T>&, const int[], T[], const T[]); \
+    template void lupack::LU_decompose_and_solve<T>(BandMatrixT<T>&, T[]); \
+    template struct lupack::LU_factorizationT<T>; \
+    template void lupack::LU_solve<T>(const LU_factorizationT<T>&, T[]); \
+    template T lupack::LU_solve<T>(const LU_factorizationT<T>&, T[], const T[]); \
+    template class lupack::LU_cacheT<T>; \
+    template struct lupack::SymBandMatrixT<T>; \
+    template void lupack::LDLT_decompose<T>(T[], int); \
+    template void lupack::LDLT_solve<T>(const T[], T[], int); \
+    template void lupack::LDLT_decompose<T>(SymBandMatrixT<T>&); \
+    template void lupack::LDLT_solve<T>(const SymBandMatrixT<T>&, T[]); \
+    template T lupack::LDLT_solve<T>(const SymBandMatrixT<T>&, T[], const T[]); \
+    template void lupack::LDLT_decompose_tridiagonal<T>(T[], T[], int); \
+    template void lupack::LDLT_solve_tridiagonal<T>(const T[], const T[], T[], int); \
+    template T lupack::LDLT_solve_tridiagonal<T>(const T[], const T[], T[], int, const T[]); \
+    template struct lupack::LDLT_factorizationT<T>; \
+    template void lupack::LDLT_solve<T>(const LDLT_factorizationT<T>&, T[]); \
+    template T lupack::LDLT_solve<T>(const LDLT_factorizationT<T>&, T[], const T[]);
+
+PRECYZJA_DLA_TYPOW(LU_INSTANCJE)
+
+//  Dekompozycja z poprawianiem: tylko precyzje niższe niż long double
+#define LU_POPRAWIANIE_INSTANCJE(TF) \
+    template struct lupack::LU_refinementT<TF>; \
+    template int lupack::LU_solve<TF>(const LU_refinementT<TF>&, long double[]);
+
+LU_POPRAWIANIE_INSTANCJE(float)
+LU_POPRAWIANIE_INSTANCJE(double)
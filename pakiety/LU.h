@@ -1,12 +1,251 @@
 #ifndef __lu_h
 #define __lu_h
 
+#include <functional>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+namespace threadpack{ class ThreadPool; }
+
+//----------------------------------------------------------------------
+// Dekompozycja LU macierzy pełnych i pasmowych. Procedury, macierz
+// pasmowa, gotowa dekompozycja i jej pamięć podręczna są szablonami
+// typu skalarnego T (jawne instancje dla typów z PRECYZJA.h); nazwy
+// bez przyrostka T oznaczają wersje long double.
+//----------------------------------------------------------------------
 namespace lupack{
 
+    const int LU_BLOCK         = 64;    // domyślna szerokość panelu w wersji blokowej
+    const int LU_BLOCKED_MIN_N = 128;   // od tego rozmiaru LU_decompose używa wersji blokowej
+
+    //------------------------------------------------------------------
+    // Macierz pasmowa przechowywana wierszami: wiersz i zawiera kolumny
+    // od i-kl do i+ku+kl. Dodatkowe kl pozycji nad pasmem to miejsce na
+    // wypełnienie powstające przy zamianie wierszy (wybór el. podstawowego).
+    //
+    //      element (i,j) -> data[i*ld + (j - i + kl)],   ld = 2*kl + ku + 1
+    //------------------------------------------------------------------
+    template <typename T>
+    struct BandMatrixT {
+        int N;              // rozmiar macierzy
+        int kl;             // liczba przekątnych pod główną
+        int ku;             // liczba przekątnych nad główną
+        int ld;             // długość wiersza w tablicy data
+        T* data;
+
+        BandMatrixT(int N, int kl, int ku);
+        ~BandMatrixT();
+
+        BandMatrixT(const BandMatrixT&) = delete;
+        BandMatrixT& operator=(const BandMatrixT&) = delete;
+
+        T& at(int i, int j) { return data[i * ld + (j - i + kl)]; }
+        const T& at(int i, int j) const { return data[i * ld + (j - i + kl)]; }
+    };
+
+    using BandMatrix = BandMatrixT<long double>;
+
     void swap(int* a, int* b);
-    void LU_decompose(long double A[], int index[], int n);
-    void LU_solve(long double A[], int index[], long double b[], int n);
-    void LU_decompose_and_solve(long double A[], long double b[], int n);
+    template <typename T> void LU_decompose(T A[], int index[], int n);
+    template <typename T> void LU_solve(T A[], int index[], T b[], int n);
+    template <typename T> void LU_decompose_and_solve(T A[], T b[], int n);
+
+    template <typename T>
+    void LU_decompose_blocked(T A[], int index[], int n, int nb = LU_BLOCK,
+        threadpack::ThreadPool* pool = nullptr);
+
+    template <typename T> void LU_decompose(BandMatrixT<T>& A, int index[]);
+    template <typename T> void LU_solve(const BandMatrixT<T>& A, const int index[], T b[]);
+    template <typename T> T LU_solve(const BandMatrixT<T>& A, const int index[], T b[], const T x_ref[]);
+    template <typename T> void LU_decompose_and_solve(BandMatrixT<T>& A, T b[]);
+
+
+    //------------------------------------------------------------------
+    // Gotowa dekompozycja LU (macierzy pełnej albo pasmowej): dekompozycja
+    // wykonywana jest raz w konstruktorze, a LU_solve(F, b) rozwiązuje
+    // dowolnie wiele układów z tą samą macierzą.
+    //------------------------------------------------------------------
+    template <typename T>
+    struct LU_factorizationT {
+        int N;
+        T* A;                   // L\U macierzy pełnej (nullptr dla wersji pasmowej)
+        BandMatrixT<T>* band;   // L\U macierzy pasmowej (nullptr dla wersji pełnej)
+        int* index;
+
+        LU_factorizationT(const T A[], int N);             // kopiuje i dekomponuje A
+        LU_factorizationT(const BandMatrixT<T>& A);        // kopiuje i dekomponuje A
+        ~LU_factorizationT();
+
+        LU_factorizationT(const LU_factorizationT&) = delete;
+        LU_factorizationT& operator=(const LU_factorizationT&) = delete;
+    };
+
+    using LU_factorization = LU_factorizationT<long double>;
+
+    template <typename T> void LU_solve(const LU_factorizationT<T>& F, T b[]);
+
+    //  Wersje z wyznaczaniem błędu: zwracają max |x[i] - x_ref[i]|
+    //  (x_ref - np. rozwiązanie analityczne). Dla macierzy pasmowej błąd
+    //  liczony jest w trakcie podstawiania wstecznego, dla pełnej - po
+    //  przywróceniu kolejności rozwiązania.
+    template <typename T> T LU_solve(const LU_factorizationT<T>& F, T b[], const T x_ref[]);
+
+
+    //------------------------------------------------------------------
+    // Dekompozycja w niższej precyzji z iteracyjnym poprawianiem
+    // rozwiązania: macierz A (long double) zaokrąglana jest do TF (float
+    // albo double) i dekomponowana w tej precyzji, a rozwiązanie
+    // poprawiane jest krokami
+    //
+    //      r = b - A x  (long double, oryginalna macierz A),
+    //      A d = r      (dekompozycja w TF),   x = x + d,
+    //
+    // aż do residuum na poziomie dokładności long double:
+    //      ||r|| <= ||x|| * ||A|| * LDBL_EPSILON * sqrt(N)   (normy max)
+    // Koszt dekompozycji (O(N^3) albo O(N*kl*(kl+ku))) ponoszony jest
+    // w szybkiej precyzji TF, a każda poprawka kosztuje tyle co mnożenie
+    // przez A i jedno rozwiązanie. Jawne instancje: float, double.
+    //------------------------------------------------------------------
+    const int LU_REFINE_MAX_ITER = 30;  // domyślna maksymalna liczba poprawek
+
+    template <typename TF>
+    struct LU_refinementT {
+        int N;
+        long double* A;             // kopia macierzy pełnej (nullptr dla wersji pasmowej)
+        BandMatrix* band;           // kopia macierzy pasmowej (nullptr dla wersji pełnej)
+        long double norm_A;         // ||A|| (maksimum sum modułów w wierszach)
+        LU_factorizationT<TF>* F;   // dekompozycja A zaokrąglonej do TF
+        int max_iter;               // maksymalna liczba poprawek
+
+        //  bufory robocze LU_solve (x, r - long double, d - TF; po N elementów),
+        //  alokowane raz - rozwiązanie w pętli czasowej nie alokuje pamięci,
+        //  ale jednej dekompozycji nie można używać w kilku wątkach naraz
+        mutable long double* x;
+        mutable long double* r;
+        mutable TF* d;
+
+        LU_refinementT(const long double A[], int N, int max_iter = LU_REFINE_MAX_ITER);
+        LU_refinementT(const BandMatrix& A, int max_iter = LU_REFINE_MAX_ITER);
+        ~LU_refinementT();
+
+        LU_refinementT(const LU_refinementT&) = delete;
+        LU_refinementT& operator=(const LU_refinementT&) = delete;
+    };
+
+    //  Rozwiązuje Ax = b z dokładnością long double (wynik w b). Zwraca
+    //  liczbę wykonanych poprawek albo -1, gdy poprawianie nie osiągnęło
+    //  dokładności w max_iter krokach (macierz zbyt źle uwarunkowana
+    //  dla precyzji TF) - b zawiera wtedy ostatnie przybliżenie.
+    template <typename TF> int LU_solve(const LU_refinementT<TF>& F, long double b[]);
+
+
+    //------------------------------------------------------------------
+    // Dekompozycja A = L D L^T macierzy symetrycznych (dodatnio
+    // określonych - bez wyboru elementu podstawowego): L dolnotrójkątna
+    // z jedynkami na przekątnej (niejawnie), D diagonalna. Przechowywany
+    // jest tylko dolny trójkąt, a koszt to połowa kosztu LU (N^3/3 flop
+    // dla macierzy pełnej). W odróżnieniu od Cholesky'ego nie wymaga
+    // pierwiastków (działa dla wszystkich typów z PRECYZJA.h). Po
+    // dekompozycji przekątna zawiera D, a elementy pod nią - mnożniki L.
+    //
+    // Warianty przechowywania:
+    //   pełna        - dolny trójkąt wierszami ("packed"), n(n+1)/2 elementów:
+    //                      element (i,j), j <= i -> AP[i*(i+1)/2 + j]
+    //   pasmowa      - SymBandMatrixT: przekątna i k przekątnych pod nią
+    //                  (np. k = Nx dla 5-punktowej dyfuzji 2D na siatce Nx x Ny)
+    //   trójdiagonalna - przekątna d[0..n-1] i przekątna pod nią e[0..n-2]
+    //                      (e[i] = A(i+1, i))
+    //------------------------------------------------------------------
+    template <typename T>
+    struct SymBandMatrixT {
+        int N;              // rozmiar macierzy
+        int k;              // liczba przekątnych pod główną
+        int ld;             // długość wiersza w tablicy data (k + 1)
+        T* data;
+
+        //      element (i,j), i-k <= j <= i -> data[i*ld + (j - i + k)]
+        SymBandMatrixT(int N, int k);
+        ~SymBandMatrixT();
+
+        SymBandMatrixT(const SymBandMatrixT&) = delete;
+        SymBandMatrixT& operator=(const SymBandMatrixT&) = delete;
+
+        T& at(int i, int j) { return data[i * ld + (j - i + k)]; }
+        const T& at(int i, int j) const { return data[i * ld + (j - i + k)]; }
+    };
+
+    using SymBandMatrix = SymBandMatrixT<long double>;
+
+    template <typename T> void LDLT_decompose(T AP[], int n);
+    template <typename T> void LDLT_solve(const T AP[], T b[], int n);
+
+    template <typename T> void LDLT_decompose(SymBandMatrixT<T>& A);
+    template <typename T> void LDLT_solve(const SymBandMatrixT<T>& A, T b[]);
+    template <typename T> T LDLT_solve(const SymBandMatrixT<T>& A, T b[], const T x_ref[]);
+
+    template <typename T> void LDLT_decompose_tridiagonal(T d[], T e[], int n);
+    template <typename T> void LDLT_solve_tridiagonal(const T d[], const T e[], T b[], int n);
+    template <typename T> T LDLT_solve_tridiagonal(const T d[], const T e[], T b[], int n, const T x_ref[]);
+
+    //  Gotowa dekompozycja LDL^T (jeden z trzech wariantów, pozostałe
+    //  wskaźniki są nullptr); LDLT_solve(F, b) jak LU_solve(F, b)
+    template <typename T>
+    struct LDLT_factorizationT {
+        int N;
+        T* AP;                      // L\D macierzy pełnej (dolny trójkąt)
+        SymBandMatrixT<T>* band;    // L\D macierzy pasmowej
+        T* d;                       // D macierzy trójdiagonalnej
+        T* e;                       // mnożniki L macierzy trójdiagonalnej
+
+        LDLT_factorizationT(const T AP[], int N);                  // kopiuje i dekomponuje dolny trójkąt
+        LDLT_factorizationT(const SymBandMatrixT<T>& A);           // kopiuje i dekomponuje A
+        LDLT_factorizationT(const T d[], const T e[], int N);      // kopiuje i dekomponuje macierz trójdiagonalną
+        ~LDLT_factorizationT();
+
+        LDLT_factorizationT(const LDLT_factorizationT&) = delete;
+        LDLT_factorizationT& operator=(const LDLT_factorizationT&) = delete;
+    };
+
+    using LDLT_factorization = LDLT_factorizationT<long double>;
+
+    template <typename T> void LDLT_solve(const LDLT_factorizationT<T>& F, T b[]);
+    //  z wyznaczaniem błędu: max |x[i] - x_ref[i]| (liczony w podstawianiu wstecznym)
+    template <typename T> T LDLT_solve(const LDLT_factorizationT<T>& F, T b[], const T x_ref[]);
+
+
+    //------------------------------------------------------------------
+    // Niewielka pamięć podręczna dekompozycji, w której kluczem jest
+    // rozmiar macierzy oraz współczynniki, z których jest ona budowana
+    // (np. {lambda} dla macierzy metody Laasonen). Przechowuje co najwyżej
+    // capacity wpisów, usuwając najdawniej używany. Bezpieczna wątkowo.
+    //------------------------------------------------------------------
+    template <typename T>
+    class LU_cacheT {
+    public:
+        explicit LU_cacheT(int capacity = 4) : capacity(capacity) {}
+
+        //  Zwraca dekompozycję dla klucza (N, coef); jeśli jej nie ma,
+        //  buduje ją funkcją build i zapamiętuje.
+        std::shared_ptr<const LU_factorizationT<T>> get(int N, const std::vector<long double>& coef,
+            const std::function<LU_factorizationT<T>*()>& build);
+
+        void clear();
+
+    private:
+        struct Entry {
+            int N;
+            std::vector<long double> coef;
+            std::shared_ptr<const LU_factorizationT<T>> F;
+        };
+
+        int capacity;
+        std::list<Entry> entries;   // od ostatnio używanego
+        std::mutex mtx;
+    };
+
+    using LU_cache = LU_cacheT<long double>;
 }
 
-#endif
\ No newline at end of file
+#endif
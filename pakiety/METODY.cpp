@@ -0,0 +1,799 @@
+#include <algorithm>
+#include <map>
+#include <mutex>
+#include <sstream>
+#include <tuple>
+#include "METODY.h"
+#include "KMB.h"
+#include "PROFIL.h"
+#include "THREADS.h"
+
+
+
+template <typename T>
+static void wypelnij_przekatne_Laasonen(long double lambda, const int N, T l[], T d[], T u[]) {
+    //  Przekątne macierzy trójdiagonalnej metody Laasonen
+    for (int i = 0; i < N; ++i) {
+        // Uzupełnienie macierzy A (a właściwie jej diagonali) odpowiednimi wyrazami
+
+        if (i == 0 || i == N - 1) {
+            //  Warunki brzegowe: U = 0 na brzegach(pierwszy i ostatni węzeł)
+            //  Poniższe przekształcenie wynika bezpośrednio z postaci 
+            //  macierzy A w metodzie Laasonen, gdzie 1. i ostatni wiersz
+            //  odpowiadają za wartości funkcji na brzegach
+
+            l[i] = T(0);
+            d[i] = T(1);
+            u[i] = T(0);
+
+        } else {
+            //  Pozostałe wyrazy macierzy A są tutaj obliczane.
+            //  Poniższe wynika z przekształcenia równania w metodzie Laasonen
+            
+            l[i] = static_cast<T>(-lambda);
+            d[i] = static_cast<T>(1.0L + 2.0L * lambda);
+            u[i] = static_cast<T>(-lambda);
+        }
+    }
+}
+
+
+
+template <typename T>
+thomaspack::ThomasFactorT<T>* metodypack::utworz_faktoryzacje_Laasonen_Thomas(long double lambda, const int N) {
+    //-------------------------------------------------------------------
+    //  Funkcja buduje macierz trójdiagonalną metody Laasonen i wykonuje
+    //  jej faktoryzację. Macierz nie zmienia się pomiędzy krokami czasowymi,
+    //  więc faktoryzacja wykonywana jest tylko raz na całą symulację.
+    //
+    //  Argumenty:
+    //      lambda  - parametr lambda: D*dt/h^2
+    //      N - liczba węzłów siatki przestrzennej
+    //
+    //  Zwraca: Wskaźnik na faktoryzację (zwalniana przez delete)
+    //-------------------------------------------------------------------
+    PROFIL_ZAKRES("ML: faktoryzacja Thomas");
+
+    // Alokacja tablic na współczynniki układu trójdiagonalnego
+    T* l = new T[N]; // dolna przekątna
+    T* d = new T[N]; // główna przekątna
+    T* u = new T[N]; // górna przekątna
+
+    wypelnij_przekatne_Laasonen(lambda, N, l, d, u);
+
+    thomaspack::ThomasFactorT<T>* F = new thomaspack::ThomasFactorT<T>(N, l, d, u);
+
+    delete[] l;
+    delete[] d;
+    delete[] u;
+    //  Zwolnienie zbędnych zasobów
+
+    return F;
+}
+
+
+
+template <typename T>
+thomaspack::ThomasParallelFactorT<T>* metodypack::utworz_faktoryzacje_Laasonen_Thomas_rownolegla(long double lambda,
+        const int N) {
+    //-------------------------------------------------------------------
+    //  Jak utworz_faktoryzacje_Laasonen_Thomas, ale faktoryzacja dla
+    //  równoległej wersji algorytmu (SPIKE) na threadpack::global_pool()
+    //
+    //  Zwraca: Wskaźnik na faktoryzację (zwalniana przez delete)
+    //-------------------------------------------------------------------
+    PROFIL_ZAKRES("ML: faktoryzacja Thomas (równoległa)");
+
+    T* l = new T[N];
+    T* d = new T[N];
+    T* u = new T[N];
+
+    wypelnij_przekatne_Laasonen(lambda, N, l, d, u);
+
+    thomaspack::ThomasParallelFactorT<T>* F = new thomaspack::ThomasParallelFactorT<T>(N, l, d, u);
+
+    delete[] l;
+    delete[] d;
+    delete[] u;
+
+    return F;
+}
+
+
+
+template <typename FT, typename T>
+static T krok_Laasonen_Thomas(const FT& F, const T* U_old, T* U_new, const int N, const T* U_ref) {
+    //  Wyrazy wolne zapisujemy od razu w U_new - rozwiązanie odbywa się w miejscu
+    U_new[0] = T(0);
+    for (int i = 1; i < N - 1; ++i) {
+        U_new[i] = U_old[i];
+    }
+    U_new[N - 1] = T(0);
+
+    if (U_ref != nullptr) {
+        return thomaspack::thomas_factor_solve(F, U_new, U_new, U_ref);
+    }
+    thomaspack::thomas_factor_solve(F, U_new, U_new);
+    return T(0);
+}
+
+
+
+template <typename T>
+T metodypack::oblicz_nastepny_poziom_czasowy_Laasonen_Thomas(const thomaspack::ThomasFactorT<T>& F, 
+        const T* U_old, T* U_new, const int N, const T* U_ref) {
+    //-------------------------------------------------------------------
+    //  Funkcja oblicza przybliżoną wartość funkcji na kolejnym poziomie czasowym
+    //  Rozwiązuje układ równań z macierzą trójdiagonalną za pomocą
+    //  algorytmu Thomasa, korzystając z gotowej faktoryzacji macierzy
+    //  (tylko eliminacja wektora wyrazów wolnych i podstawianie wsteczne).
+    //  Warunki brzegowe: U_new[0]=U_new[N-1]=0 (wyrazy wolne na brzegach)
+    //
+    //  Argumenty:
+    //      F       - faktoryzacja macierzy metody Laasonen
+    //      U_old   - Tablica wartości funkcji dla bieżącego poziomu czasu
+    //      U_new   - Tablica wartości funkcji dla nowego poziomu czasu
+    //      N - liczba węzłów siatki przestrzennej
+    //      U_ref   - (opcjonalnie) rozwiązanie odniesienia dla nowego poziomu;
+    //                błąd liczony jest w trakcie podstawiania wstecznego
+    //
+    //  Zwraca: max |U_new[i] - U_ref[i]| (0 gdy nie podano U_ref)
+    //-------------------------------------------------------------------
+    PROFIL_ZAKRES("ML_Thomas: krok");
+
+    return krok_Laasonen_Thomas(F, U_old, U_new, N, U_ref);
+}
+
+
+
+template <typename T>
+T metodypack::oblicz_nastepny_poziom_czasowy_Laasonen_Thomas(const thomaspack::ThomasParallelFactorT<T>& F, 
+        const T* U_old, T* U_new, const int N, const T* U_ref) {
+    //  Jak wyżej, z faktoryzacją równoległą (bloki na puli wątków F.pool)
+    PROFIL_ZAKRES("ML_Thomas: krok (równoległy)");
+
+    return krok_Laasonen_Thomas(F, U_old, U_new, N, U_ref);
+}
+
+
+
+template <typename T>
+static void wypelnij_macierz_Laasonen(lupack::BandMatrixT<T>& A, long double lambda) {
+    //  Macierz pasmowa (kl = ku = 1) metody Laasonen, opis poniżej
+    const int N = A.N;
+    for (int i = 0; i < N; ++i) {
+        
+        if (i == 0 || i == (N - 1)) {
+            //  Warunki brzegowe: U = 0 na brzegach(pierwszy i ostatni węzeł)
+            //  Poniższe przekształcenie wynika bezpośrednio z postaci 
+            //  macierzy A w metodzie Laasonen, gdzie 1. i ostatni wiersz
+            //  odpowiadają za wartości funkcji na brzegach
+            
+            A.at(i, i) = T(1);
+        
+        } else {
+            // Wiersz i (wewnętrzny):
+            A.at(i, i - 1) = static_cast<T>(-lambda);
+            A.at(i, i)     = static_cast<T>(1.0L + 2.0L * lambda);
+            A.at(i, i + 1) = static_cast<T>(-lambda);
+        }
+    }
+}
+
+
+
+//  Dekompozycje macierzy metody Laasonen, kluczowane rozmiarem siatki i lambdą
+//  (osobna pamięć podręczna dla każdej precyzji)
+template <typename T>
+static lupack::LU_cacheT<T>& cache_LU() {
+    static lupack::LU_cacheT<T> cache;
+    return cache;
+}
+
+
+
+template <typename T>
+std::shared_ptr<const lupack::LU_factorizationT<T>> metodypack::utworz_faktoryzacje_Laasonen_LU(long double lambda, int N) {
+    //-------------------------------------------------------------------
+    // Funkcja zwraca dekompozycję LU macierzy metody Laasonen dla danej
+    // siatki. Macierz nie zmienia się pomiędzy krokami czasowymi, więc
+    // dekompozycja wykonywana jest raz (i zapamiętywana w cache_LU).
+    // Macierz A przechowujemy w formacie pasmowym (kl = ku = 1):
+    //
+    //   Dla wierszy brzegowych (i == 0 lub i == N-1):
+    //       A[i, i] = 1, pozostałe elementy = 0
+    //
+    //   Dla wierszy wewnętrznych (1 <= i <= N-2):
+    //       A[i, i-1] = -lambda, A[i, i] = 1 + 2*lambda, A[i, i+1] = -lambda
+    //
+    // Argumenty:
+    //   lambda - parametr lambda: D*dt/h^2 (najlepiej bliski 1 dla tej metody)
+    //   N - liczba węzłów siatki przestrzennej
+    //
+    // Zwraca: dekompozycję macierzy A
+    //-------------------------------------------------------------------
+    PROFIL_ZAKRES("ML: faktoryzacja LU");
+
+    return cache_LU<T>().get(N, {lambda}, [&]() {
+        // Alokujemy macierz pasmową A (jedna przekątna pod i nad główną),
+        // konstruktor wypełnia ją zerami:
+        lupack::BandMatrixT<T> A(N, 1, 1);
+        wypelnij_macierz_Laasonen(A, lambda);
+
+        return new lupack::LU_factorizationT<T>(A);
+    });
+}
+
+
+
+template <typename T>
+lupack::LDLT_factorizationT<T>* metodypack::utworz_faktoryzacje_Laasonen_LDLT(long double lambda, int N) {
+    //-------------------------------------------------------------------
+    // Macierz metody Laasonen jako symetryczna macierz trójdiagonalna:
+    // przekątna (1, 1 + 2*lambda, ..., 1 + 2*lambda, 1), pod nią -lambda
+    // w wierszach wewnętrznych. Elementy A(1,0) i A(N-2,N-1) są pomijane -
+    // mnożą wartości brzegowe x[0] = x[N-1] = 0 (prawa strona wierszy
+    // brzegowych jest zerowa), więc rozwiązanie się nie zmienia.
+    // Dekompozycja LDL^T: ok. połowa działań i pamięci LU macierzy pasmowej.
+    //-------------------------------------------------------------------
+    PROFIL_ZAKRES("ML: faktoryzacja LDLT");
+
+    std::vector<T> d(N), e(N - 1);
+    d[0] = T(1);
+    d[N - 1] = T(1);
+    for (int i = 1; i < N - 1; ++i) {
+        d[i] = static_cast<T>(1.0L + 2.0L * lambda);
+    }
+    e[0] = T(0);
+    e[N - 2] = T(0);
+    for (int i = 1; i < N - 2; ++i) {
+        e[i] = static_cast<T>(-lambda);
+    }
+    return new lupack::LDLT_factorizationT<T>(d.data(), e.data(), N);
+}
+
+
+
+template <typename TF>
+lupack::LU_refinementT<TF>* metodypack::utworz_faktoryzacje_Laasonen_LU_poprawiana(long double lambda, int N) {
+    //-------------------------------------------------------------------
+    // Macierz metody Laasonen (jak wyżej) w long double, dekomponowana
+    // w precyzji TF; rozwiązania poprawiane są do dokładności long double
+    //-------------------------------------------------------------------
+    PROFIL_ZAKRES("ML: faktoryzacja LU");
+
+    lupack::BandMatrix A(N, 1, 1);
+    wypelnij_macierz_Laasonen(A, lambda);
+    return new lupack::LU_refinementT<TF>(A);
+}
+
+
+
+template <typename T>
+T metodypack::oblicz_nastepny_poziom_czasowy_Laasonen_LU(const lupack::LU_factorizationT<T>& F,
+                                              const T* U_old, 
+                                              T* U_new, 
+                                                int N,
+                                              const T* U_ref) {
+    //-------------------------------------------------------------------
+    // Funkcja oblicza przybliżoną wartość funkcji na kolejnym poziomie czasowym
+    // Metoda Laasonen – układ równań z macierzą trójdiagonalną (przy brzegach
+    // ustawiamy U=0), rozwiązywany przy pomocy gotowej dekompozycji LU.
+    // Wektor prawej strony to U_new (nasze per se "b"):
+    //   U_new[i] = 0 dla wierszy brzegowych, U_new[i] = U_old[i] dla wewnętrznych
+    //
+    // Po rozwiązaniu A*x = b, wynik (x) zostaje zapisany do U_new.
+    //
+    // Argumenty:
+    //   F - dekompozycja LU macierzy metody Laasonen
+    //   U_old - wektor wartości funkcji dla bieżącego poziomu czasowego,
+    //   U_new - wektor, do którego zapiszemy wynik kolejnej iteracji,
+    //   N - liczba węzłów siatki przestrzennej
+    //   U_ref - (opcjonalnie) rozwiązanie odniesienia dla nowego poziomu;
+    //           błąd liczony jest w trakcie podstawiania wstecznego
+    //
+    // Zwraca: max |U_new[i] - U_ref[i]| (0 gdy nie podano U_ref)
+    //-------------------------------------------------------------------
+    PROFIL_ZAKRES("ML_full_LU: krok");
+    
+    U_new[0] = T(0);
+    for (int i = 1; i < N - 1; ++i) {
+        U_new[i] = U_old[i];
+    }
+    U_new[N - 1] = T(0);
+    
+    // Rozwiązujemy układ A*x = b_vec (tylko podstawienia w przód i wstecz)
+    if (U_ref != nullptr) {
+        return lupack::LU_solve(F, U_new, U_ref);
+    }
+    lupack::LU_solve(F, U_new);
+    return T(0);
+}
+
+
+
+template <typename T>
+T metodypack::oblicz_nastepny_poziom_czasowy_Laasonen_LDLT(const lupack::LDLT_factorizationT<T>& F,
+        const T* U_old, T* U_new, int N, const T* U_ref) {
+    //-------------------------------------------------------------------
+    // Krok metody Laasonen (jak wyżej) z dekompozycją LDL^T macierzy
+    // symetrycznej (utworz_faktoryzacje_Laasonen_LDLT)
+    //
+    // Zwraca: max |U_new[i] - U_ref[i]| (0 gdy nie podano U_ref)
+    //-------------------------------------------------------------------
+    PROFIL_ZAKRES("ML_LDLT: krok");
+
+    U_new[0] = T(0);
+    for (int i = 1; i < N - 1; ++i) {
+        U_new[i] = U_old[i];
+    }
+    U_new[N - 1] = T(0);
+
+    if (U_ref != nullptr) {
+        return lupack::LDLT_solve(F, U_new, U_ref);
+    }
+    lupack::LDLT_solve(F, U_new);
+    return T(0);
+}
+
+
+
+template <typename TF>
+long double metodypack::oblicz_nastepny_poziom_czasowy_Laasonen_LU(const lupack::LU_refinementT<TF>& F,
+        const long double* U_old, long double* U_new, int N, const long double* U_ref, int* poprawki) {
+    //-------------------------------------------------------------------
+    // Krok metody Laasonen (jak wyżej) z dekompozycją w niższej precyzji
+    // i poprawianiem rozwiązania w long double
+    //
+    // Argumenty: jak wyżej, dodatkowo
+    //   poprawki - (opcjonalnie) liczba poprawek rozwiązania lub -1, gdy
+    //              poprawianie nie osiągnęło dokładności long double
+    //
+    // Zwraca: max |U_new[i] - U_ref[i]| (0 gdy nie podano U_ref)
+    //-------------------------------------------------------------------
+    PROFIL_ZAKRES("ML_full_LU: krok");
+
+    U_new[0] = 0.0L;
+    for (int i = 1; i < N - 1; ++i) {
+        U_new[i] = U_old[i];
+    }
+    U_new[N - 1] = 0.0L;
+
+    int k = lupack::LU_solve(F, U_new);
+    if (poprawki != nullptr) *poprawki = k;
+
+    long double max_err = 0.0L;
+    if (U_ref != nullptr) {
+        for (int i = 0; i < N; i++) {
+            long double e = fabsl(U_new[i] - U_ref[i]);
+            precyzjapack::max_bledu(max_err, e);
+        }
+    }
+    return max_err;
+}
+
+
+
+//  Jawne instancje dla wszystkich typów skalarnych (PRECYZJA.h)
+#define METODY_INSTANCJE(T) \
+    template thomaspack::ThomasFactorT<T>* metodypack::utworz_faktoryzacje_Laasonen_Thomas<T>(long double, const int); \
+    template thomaspack::ThomasParallelFactorT<T>* metodypack::utworz_faktoryzacje_Laasonen_Thomas_rownolegla<T>( \
+        long double, const int); \
+    template std::shared_ptr<const lupack::LU_factorizationT<T>> metodypack::utworz_faktoryzacje_Laasonen_LU<T>( \
+        long double, int); \
+    template T metodypack::oblicz_nastepny_poziom_czasowy_Laasonen_Thomas<T>(const thomaspack::ThomasFactorT<T>&, \
+        const T*, T*, const int, const T*); \
+    template T metodypack::oblicz_nastepny_poziom_czasowy_Laasonen_Thomas<T>(const thomaspack::ThomasParallelFactorT<T>&, \
+        const T*, T*, const int, const T*); \
+    template T metodypack::oblicz_nastepny_poziom_czasowy_Laasonen_LU<T>(const lupack::LU_factorizationT<T>&, \
+        const T*, T*, int, const T*); \
+    template lupack::LDLT_factorizationT<T>* metodypack::utworz_faktoryzacje_Laasonen_LDLT<T>(long double, int); \
+    template T metodypack::oblicz_nastepny_poziom_czasowy_Laasonen_LDLT<T>(const lupack::LDLT_factorizationT<T>&, \
+        const T*, T*, int, const T*);
+
+PRECYZJA_DLA_TYPOW(METODY_INSTANCJE)
+
+//  Dekompozycja mieszanej precyzji: float i double
+#define METODY_POPRAWIANIE_INSTANCJE(TF) \
+    template lupack::LU_refinementT<TF>* metodypack::utworz_faktoryzacje_Laasonen_LU_poprawiana<TF>(long double, int); \
+    template long double metodypack::oblicz_nastepny_poziom_czasowy_Laasonen_LU<TF>(const lupack::LU_refinementT<TF>&, \
+        const long double*, long double*, int, const long double*, int*);
+
+METODY_POPRAWIANIE_INSTANCJE(float)
+METODY_POPRAWIANIE_INSTANCJE(double)
+
+
+
+//----------------------------------------------------------------------
+// Metody wbudowane w rejestr
+//----------------------------------------------------------------------
+namespace {
+
+    //  wskaźniki na faktoryzacje w danej precyzji (krotka dla wszystkich typów)
+    template <typename T> using WskThomas = std::unique_ptr<thomaspack::ThomasFactorT<T>>;
+    template <typename T> using WskLU = std::shared_ptr<const lupack::LU_factorizationT<T>>;
+    template <typename T> using WskLDLT = std::unique_ptr<lupack::LDLT_factorizationT<T>>;
+
+
+    class MetodaKMB : public metodypack::Metoda {
+    public:
+        std::string nazwa() const override { return "KMB"; }
+        std::string kolumna() const override { return "U_KMB"; }
+        std::string prefiks() const override { return "KMBresults"; }
+        bool blad_poziomu_wejsciowego() const override { return true; }
+
+        void przygotuj(int N, long double lambda) override {
+            this->N = N;
+            this->lambda = lambda;
+        }
+
+        long double krok(const long double* U_old, long double* U_new, const long double* U_ref) override {
+            if (U_ref != nullptr) {
+                return kmbpack::oblicz_nastepny_poziom_czasowy_KMB(U_old, U_new, lambda, N, U_ref);
+            }
+            kmbpack::oblicz_nastepny_poziom_czasowy_KMB(U_old, U_new, lambda, N);
+            return 0.0L;
+        }
+
+        bool obsluguje(precyzjapack::Precyzja) const override { return true; }
+        void krok(const float* U_old, float* U_new) override { krok_w(U_old, U_new); }
+        void krok(const double* U_old, double* U_new) override { krok_w(U_old, U_new); }
+        void krok(const ddpack::dd* U_old, ddpack::dd* U_new) override { krok_w(U_old, U_new); }
+#ifdef PRECYZJA_FLOAT128
+        void krok(const precyzjapack::float128* U_old, precyzjapack::float128* U_new) override { krok_w(U_old, U_new); }
+#endif
+
+        //  blokowanie czasowe (kmbpack::oblicz_k_poziomow_czasowych_KMB) dla jąder
+        //  wektorowych i siatek dłuższych niż kafelek; krótsze mieszczą się
+        //  w pamięci podręcznej, a krok long double (x87) jest ograniczony
+        //  obliczeniami - tam blokowanie nie przyspiesza (benchmark, KMB_k_krokow)
+        int kroki(const float* U_old, float* U_new, int k) override { return kroki_w(U_old, U_new, k); }
+        int kroki(const double* U_old, double* U_new, int k) override { return kroki_w(U_old, U_new, k); }
+
+    private:
+        template <typename T>
+        void krok_w(const T* U_old, T* U_new) {
+            kmbpack::oblicz_nastepny_poziom_czasowy_KMB(U_old, U_new, static_cast<T>(lambda), N);
+        }
+
+        template <typename T>
+        int kroki_w(const T* U_old, T* U_new, int k) {
+            if (N <= kmbpack::KMB_TILE || k < 2) return 0;
+            if (k > kmbpack::KMB_KROKI_NARAZ) k = kmbpack::KMB_KROKI_NARAZ;
+            kmbpack::oblicz_k_poziomow_czasowych_KMB(U_old, U_new, static_cast<T>(lambda), N, k);
+            return k;
+        }
+
+        int N = 0;
+        long double lambda = 0.0L;
+    };
+
+
+    //  KMB na silniku kmbpack::ParallelKMB: siatka dzielona między
+    //  threadpack::rozmiar_global_pool() wątków (opcja --watki), ale co
+    //  najmniej KMB_ROWNOLEGLY_MIN_WEZLOW węzłów na wątek - małe siatki
+    //  (np. w badaniu zbieżności, które już jest równoległe) liczone są
+    //  jednym wątkiem. Wynik identyczny z metodą "KMB".
+    template <typename T> using WskParallelKMB = std::unique_ptr<kmbpack::ParallelKMB<T>>;
+
+    class MetodaKMBRownolegla : public metodypack::Metoda {
+    public:
+        std::string nazwa() const override { return "KMB_rownolegly"; }
+        std::string kolumna() const override { return "U_KMB_rownolegly"; }
+        std::string prefiks() const override { return "KMB_rownolegly_results"; }
+        bool blad_poziomu_wejsciowego() const override { return true; }
+
+        void przygotuj(int N, long double lambda) override {
+            this->N = N;
+            this->lambda = lambda;
+            int watki = std::min(threadpack::rozmiar_global_pool(), N / kmbpack::KMB_ROWNOLEGLY_MIN_WEZLOW);
+            if (watki < 1) watki = 1;
+            precyzjapack::dla_precyzji(precyzja(), [&](auto zero) {
+                using T = decltype(zero);
+                WskParallelKMB<T>& silnik = std::get<WskParallelKMB<T>>(F);
+                if (!silnik || silnik->size() != N || silnik->threads() != watki) {
+                    silnik.reset(new kmbpack::ParallelKMB<T>(N, watki));
+                }
+            });
+        }
+
+        long double krok(const long double* U_old, long double* U_new, const long double* U_ref) override {
+            return std::get<WskParallelKMB<long double>>(F)->step(U_old, U_new, lambda, U_ref);
+        }
+
+        bool obsluguje(precyzjapack::Precyzja) const override { return true; }
+        void krok(const float* U_old, float* U_new) override { krok_w(U_old, U_new); }
+        void krok(const double* U_old, double* U_new) override { krok_w(U_old, U_new); }
+        void krok(const ddpack::dd* U_old, ddpack::dd* U_new) override { krok_w(U_old, U_new); }
+#ifdef PRECYZJA_FLOAT128
+        void krok(const precyzjapack::float128* U_old, precyzjapack::float128* U_new) override { krok_w(U_old, U_new); }
+#endif
+
+        std::string podsumowanie() const override {
+            int watki = 0;
+            precyzjapack::dla_precyzji(precyzja(), [&](auto zero) {
+                using T = decltype(zero);
+                const WskParallelKMB<T>& silnik = std::get<WskParallelKMB<T>>(F);
+                if (silnik) watki = silnik->threads();
+            });
+            if (watki == 0) return "";
+            return "Liczba wątków KMB: " + std::to_string(watki);
+        }
+
+    private:
+        template <typename T>
+        void krok_w(const T* U_old, T* U_new) {
+            std::get<WskParallelKMB<T>>(F)->step(U_old, U_new, static_cast<T>(lambda));
+        }
+
+        int N = 0;
+        long double lambda = 0.0L;
+        precyzjapack::DlaTypow<WskParallelKMB> F;
+    };
+
+
+    //  Dla N >= THOMAS_PARALLEL_MIN_N i puli z więcej niż jednym wątkiem
+    //  (opcja --watki) krok rozwiązywany jest równoległą wersją algorytmu
+    //  (faktoryzacja SPIKE, wynik różni się od sekwencyjnego na poziomie
+    //  błędów zaokrągleń), dla mniejszych siatek - zwykłym algorytmem Thomasa.
+    template <typename T> using WskThomasRownolegly = std::unique_ptr<thomaspack::ThomasParallelFactorT<T>>;
+
+    class MetodaLaasonenThomas : public metodypack::Metoda {
+    public:
+        std::string nazwa() const override { return "ML_Thomas"; }
+        std::string kolumna() const override { return "U_ML_Thomas"; }
+        std::string prefiks() const override { return "ML_Thomas_results"; }
+        bool blad_poziomu_wejsciowego() const override { return false; }
+
+        void przygotuj(int N, long double lambda) override {
+            this->N = N;
+            rownolegly = N >= thomaspack::THOMAS_PARALLEL_MIN_N && threadpack::rozmiar_global_pool() > 1;
+            precyzjapack::dla_precyzji(precyzja(), [&](auto zero) {
+                using T = decltype(zero);
+                if (rownolegly) {
+                    std::get<WskThomas<T>>(F).reset();
+                    std::get<WskThomasRownolegly<T>>(F_rown).reset(
+                        metodypack::utworz_faktoryzacje_Laasonen_Thomas_rownolegla<T>(lambda, N));
+                } else {
+                    std::get<WskThomasRownolegly<T>>(F_rown).reset();
+                    std::get<WskThomas<T>>(F).reset(metodypack::utworz_faktoryzacje_Laasonen_Thomas<T>(lambda, N));
+                }
+            });
+        }
+
+        long double krok(const long double* U_old, long double* U_new, const long double* U_ref) override {
+            if (rownolegly) {
+                return metodypack::oblicz_nastepny_poziom_czasowy_Laasonen_Thomas(
+                    *std::get<WskThomasRownolegly<long double>>(F_rown), U_old, U_new, N, U_ref);
+            }
+            return metodypack::oblicz_nastepny_poziom_czasowy_Laasonen_Thomas(*std::get<WskThomas<long double>>(F),
+                U_old, U_new, N, U_ref);
+        }
+
+        bool obsluguje(precyzjapack::Precyzja) const override { return true; }
+        void krok(const float* U_old, float* U_new) override { krok_w(U_old, U_new); }
+        void krok(const double* U_old, double* U_new) override { krok_w(U_old, U_new); }
+        void krok(const ddpack::dd* U_old, ddpack::dd* U_new) override { krok_w(U_old, U_new); }
+#ifdef PRECYZJA_FLOAT128
+        void krok(const precyzjapack::float128* U_old, precyzjapack::float128* U_new) override { krok_w(U_old, U_new); }
+#endif
+
+        std::string podsumowanie() const override {
+            int bloki = 0;
+            if (rownolegly) {
+                precyzjapack::dla_precyzji(precyzja(), [&](auto zero) {
+                    using T = decltype(zero);
+                    const WskThomasRownolegly<T>& G = std::get<WskThomasRownolegly<T>>(F_rown);
+                    if (G) bloki = G->P;
+                });
+            }
+            if (bloki == 0) return "";
+            return "Liczba bloków równoległego algorytmu Thomasa: " + std::to_string(bloki);
+        }
+
+    private:
+        template <typename T>
+        void krok_w(const T* U_old, T* U_new) {
+            if (rownolegly) {
+                metodypack::oblicz_nastepny_poziom_czasowy_Laasonen_Thomas(*std::get<WskThomasRownolegly<T>>(F_rown),
+                    U_old, U_new, N);
+                return;
+            }
+            metodypack::oblicz_nastepny_poziom_czasowy_Laasonen_Thomas(*std::get<WskThomas<T>>(F), U_old, U_new, N);
+        }
+
+        int N = 0;
+        bool rownolegly = false;
+        precyzjapack::DlaTypow<WskThomas> F;
+        precyzjapack::DlaTypow<WskThomasRownolegly> F_rown;
+    };
+
+
+    class MetodaLaasonenLU : public metodypack::Metoda {
+    public:
+        std::string nazwa() const override { return "ML_full_LU"; }
+        std::string kolumna() const override { return "U_ML_full_LU"; }
+        std::string prefiks() const override { return "ML_full_LU_results"; }
+        bool blad_poziomu_wejsciowego() const override { return false; }
+
+        void przygotuj(int N, long double lambda) override {
+            this->N = N;
+            precyzjapack::dla_precyzji(precyzja(), [&](auto zero) {
+                using T = decltype(zero);
+                std::get<WskLU<T>>(F) = metodypack::utworz_faktoryzacje_Laasonen_LU<T>(lambda, N);
+            });
+        }
+
+        long double krok(const long double* U_old, long double* U_new, const long double* U_ref) override {
+            return metodypack::oblicz_nastepny_poziom_czasowy_Laasonen_LU(*std::get<WskLU<long double>>(F),
+                U_old, U_new, N, U_ref);
+        }
+
+        bool obsluguje(precyzjapack::Precyzja) const override { return true; }
+        void krok(const float* U_old, float* U_new) override { krok_w(U_old, U_new); }
+        void krok(const double* U_old, double* U_new) override { krok_w(U_old, U_new); }
+        void krok(const ddpack::dd* U_old, ddpack::dd* U_new) override { krok_w(U_old, U_new); }
+#ifdef PRECYZJA_FLOAT128
+        void krok(const precyzjapack::float128* U_old, precyzjapack::float128* U_new) override { krok_w(U_old, U_new); }
+#endif
+
+    private:
+        template <typename T>
+        void krok_w(const T* U_old, T* U_new) {
+            metodypack::oblicz_nastepny_poziom_czasowy_Laasonen_LU(*std::get<WskLU<T>>(F), U_old, U_new, N);
+        }
+
+        int N = 0;
+        precyzjapack::DlaTypow<WskLU> F;
+    };
+
+
+    class MetodaLaasonenLDLT : public metodypack::Metoda {
+    public:
+        std::string nazwa() const override { return "ML_LDLT"; }
+        std::string kolumna() const override { return "U_ML_LDLT"; }
+        std::string prefiks() const override { return "ML_LDLT_results"; }
+        bool blad_poziomu_wejsciowego() const override { return false; }
+
+        void przygotuj(int N, long double lambda) override {
+            this->N = N;
+            precyzjapack::dla_precyzji(precyzja(), [&](auto zero) {
+                using T = decltype(zero);
+                std::get<WskLDLT<T>>(F).reset(metodypack::utworz_faktoryzacje_Laasonen_LDLT<T>(lambda, N));
+            });
+        }
+
+        long double krok(const long double* U_old, long double* U_new, const long double* U_ref) override {
+            return metodypack::oblicz_nastepny_poziom_czasowy_Laasonen_LDLT(*std::get<WskLDLT<long double>>(F),
+                U_old, U_new, N, U_ref);
+        }
+
+        bool obsluguje(precyzjapack::Precyzja) const override { return true; }
+        void krok(const float* U_old, float* U_new) override { krok_w(U_old, U_new); }
+        void krok(const double* U_old, double* U_new) override { krok_w(U_old, U_new); }
+        void krok(const ddpack::dd* U_old, ddpack::dd* U_new) override { krok_w(U_old, U_new); }
+#ifdef PRECYZJA_FLOAT128
+        void krok(const precyzjapack::float128* U_old, precyzjapack::float128* U_new) override { krok_w(U_old, U_new); }
+#endif
+
+    private:
+        template <typename T>
+        void krok_w(const T* U_old, T* U_new) {
+            metodypack::oblicz_nastepny_poziom_czasowy_Laasonen_LDLT(*std::get<WskLDLT<T>>(F), U_old, U_new, N);
+        }
+
+        int N = 0;
+        precyzjapack::DlaTypow<WskLDLT> F;
+    };
+
+
+    //  Laasonen z dekompozycją w precyzji TF i poprawianiem rozwiązań
+    //  (tylko long double); podsumowanie() - statystyka liczby poprawek
+    template <typename TF>
+    class MetodaLaasonenLUMieszana : public metodypack::Metoda {
+    public:
+        explicit MetodaLaasonenLUMieszana(const std::string& typ) : typ(typ) {}
+
+        std::string nazwa() const override { return "ML_LU_mieszana_" + typ; }
+        std::string kolumna() const override { return "U_" + nazwa(); }
+        std::string prefiks() const override { return nazwa() + "_results"; }
+        bool blad_poziomu_wejsciowego() const override { return false; }
+
+        void przygotuj(int N, long double lambda) override {
+            this->N = N;
+            F.reset(metodypack::utworz_faktoryzacje_Laasonen_LU_poprawiana<TF>(lambda, N));
+            kroki = 0;
+            suma_poprawek = 0;
+            max_poprawek = 0;
+            bez_zbieznosci = 0;
+        }
+
+        long double krok(const long double* U_old, long double* U_new, const long double* U_ref) override {
+            int poprawki = 0;
+            long double blad = metodypack::oblicz_nastepny_poziom_czasowy_Laasonen_LU(*F, U_old, U_new, N, U_ref,
+                &poprawki);
+            kroki++;
+            if (poprawki < 0) {
+                bez_zbieznosci++;
+                poprawki = F->max_iter;
+            }
+            suma_poprawek += poprawki;
+            if (poprawki > max_poprawek) max_poprawek = poprawki;
+            return blad;
+        }
+
+        std::string podsumowanie() const override {
+            if (kroki == 0) return "";
+            std::ostringstream s;
+            s << "Poprawki rozwiązania (" << typ << " -> long double): średnio "
+              << (double)suma_poprawek / kroki << ", maksymalnie " << max_poprawek;
+            if (bez_zbieznosci > 0) {
+                s << ", bez osiągnięcia dokładności long double w " << bez_zbieznosci << " krokach";
+            }
+            return s.str();
+        }
+
+    private:
+        std::string typ;
+        int N = 0;
+        std::unique_ptr<lupack::LU_refinementT<TF>> F;
+        long long kroki = 0;
+        long long suma_poprawek = 0;
+        int max_poprawek = 0;
+        long long bez_zbieznosci = 0;
+    };
+
+
+    struct Rejestr {
+        std::mutex mtx;
+        std::map<std::string, metodypack::FabrykaMetody> fabryki;
+
+        Rejestr() {
+            fabryki["KMB"]        = [] { return std::unique_ptr<metodypack::Metoda>(new MetodaKMB()); };
+            fabryki["KMB_rownolegly"] = [] { return std::unique_ptr<metodypack::Metoda>(new MetodaKMBRownolegla()); };
+            fabryki["ML_Thomas"]  = [] { return std::unique_ptr<metodypack::Metoda>(new MetodaLaasonenThomas()); };
+            fabryki["ML_full_LU"] = [] { return std::unique_ptr<metodypack::Metoda>(new MetodaLaasonenLU()); };
+            fabryki["ML_LDLT"]    = [] { return std::unique_ptr<metodypack::Metoda>(new MetodaLaasonenLDLT()); };
+            fabryki["ML_LU_mieszana_float"] = [] {
+                return std::unique_ptr<metodypack::Metoda>(new MetodaLaasonenLUMieszana<float>("float"));
+            };
+            fabryki["ML_LU_mieszana_double"] = [] {
+                return std::unique_ptr<metodypack::Metoda>(new MetodaLaasonenLUMieszana<double>("double"));
+            };
+        }
+    };
+
+    Rejestr& rejestr() {
+        static Rejestr r;
+        return r;
+    }
+
+}
+
+
+
+void metodypack::zarejestruj_metode(const std::string& nazwa, FabrykaMetody fabryka) {
+    Rejestr& r = rejestr();
+    std::lock_guard<std::mutex> lock(r.mtx);
+    r.fabryki[nazwa] = std::move(fabryka);
+}
+
+
+
+std::unique_ptr<metodypack::Metoda> metodypack::utworz_metode(const std::string& nazwa) {
+    Rejestr& r = rejestr();
+    std::lock_guard<std::mutex> lock(r.mtx);
+    auto it = r.fabryki.find(nazwa);
+    if (it == r.fabryki.end()) return nullptr;
+    return it->second();
+}
+
+
+
+std::vector<std::string> metodypack::dostepne_metody() {
+    Rejestr& r = rejestr();
+    std::lock_guard<std::mutex> lock(r.mtx);
+    std::vector<std::string> nazwy;
+    for (const auto& f : r.fabryki) nazwy.push_back(f.first);
+    return nazwy;
+}
@@ -0,0 +1,163 @@
+#ifndef __metody_h
+#define __metody_h
+
+#include <functional>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "THOMAS.h"
+#include "LU.h"
+#include "PRECYZJA.h"
+
+//----------------------------------------------------------------------
+// Pakiet metod rozwiązywania równania dyfuzji na kolejnych poziomach
+// czasowych: procedury metody Laasonen (wspólne dla programów ML) oraz
+// jednolity interfejs metod z rejestrem nazw, z którego korzysta
+// program sterujący (heat_transfer.cpp).
+//----------------------------------------------------------------------
+namespace metodypack{
+
+    //------------------------------------------------------------------
+    // Metoda Laasonen: macierz trójdiagonalna z wierszami brzegowymi
+    // U = 0 i wierszami wewnętrznymi (-lambda, 1 + 2*lambda, -lambda).
+    // Macierz nie zmienia się między krokami, więc faktoryzowana jest raz.
+    // T - precyzja faktoryzacji i kroku (domyślnie long double); lambda
+    // liczona jest zawsze w long double i zaokrąglana do T.
+    //------------------------------------------------------------------
+
+    //  Faktoryzacja algorytmu Thomasa (zwalniana przez delete)
+    template <typename T = long double>
+    thomaspack::ThomasFactorT<T>* utworz_faktoryzacje_Laasonen_Thomas(long double lambda, const int N);
+
+    //  Faktoryzacja równoległej wersji algorytmu Thomasa (SPIKE, pula
+    //  threadpack::global_pool(); zwalniana przez delete)
+    template <typename T = long double>
+    thomaspack::ThomasParallelFactorT<T>* utworz_faktoryzacje_Laasonen_Thomas_rownolegla(long double lambda, const int N);
+
+    //  Dekompozycja LU macierzy pasmowej (zapamiętywana we wspólnym LU_cache precyzji T)
+    template <typename T = long double>
+    std::shared_ptr<const lupack::LU_factorizationT<T>> utworz_faktoryzacje_Laasonen_LU(long double lambda, int N);
+
+    //  Dekompozycja LDL^T macierzy symetrycznej (wariant trójdiagonalny,
+    //  zwalniana przez delete). Wiersze brzegowe U = 0 pozwalają pominąć
+    //  elementy -lambda w kolumnach brzegowych (mnożą zerowe x[0], x[N-1]),
+    //  co czyni macierz symetryczną i dodatnio określoną.
+    template <typename T = long double>
+    lupack::LDLT_factorizationT<T>* utworz_faktoryzacje_Laasonen_LDLT(long double lambda, int N);
+
+    //  Dekompozycja w precyzji TF (float, double) z poprawianiem rozwiązań
+    //  do dokładności long double (zwalniana przez delete)
+    template <typename TF>
+    lupack::LU_refinementT<TF>* utworz_faktoryzacje_Laasonen_LU_poprawiana(long double lambda, int N);
+
+    //  Krok czasowy U_old -> U_new; gdy podano U_ref (rozwiązanie odniesienia
+    //  dla nowego poziomu), zwraca max |U_new[i] - U_ref[i]|, inaczej 0
+    template <typename T>
+    T oblicz_nastepny_poziom_czasowy_Laasonen_Thomas(const thomaspack::ThomasFactorT<T>& F,
+        const T* U_old, T* U_new, const int N, const T* U_ref = nullptr);
+    template <typename T>
+    T oblicz_nastepny_poziom_czasowy_Laasonen_Thomas(const thomaspack::ThomasParallelFactorT<T>& F,
+        const T* U_old, T* U_new, const int N, const T* U_ref = nullptr);
+    template <typename T>
+    T oblicz_nastepny_poziom_czasowy_Laasonen_LU(const lupack::LU_factorizationT<T>& F,
+        const T* U_old, T* U_new, int N, const T* U_ref = nullptr);
+    template <typename T>
+    T oblicz_nastepny_poziom_czasowy_Laasonen_LDLT(const lupack::LDLT_factorizationT<T>& F,
+        const T* U_old, T* U_new, int N, const T* U_ref = nullptr);
+    //  poprawki - (opcjonalnie) liczba poprawek rozwiązania albo -1 (LU_solve)
+    template <typename TF>
+    long double oblicz_nastepny_poziom_czasowy_Laasonen_LU(const lupack::LU_refinementT<TF>& F,
+        const long double* U_old, long double* U_new, int N, const long double* U_ref = nullptr,
+        int* poprawki = nullptr);
+
+
+    //------------------------------------------------------------------
+    // Interfejs metody dla programu sterującego. Obiekt może być użyty
+    // do wielu symulacji - przygotuj() wywoływane jest przed każdą z nich.
+    //------------------------------------------------------------------
+    class Metoda {
+    public:
+        virtual ~Metoda() = default;
+
+        //  nazwa w rejestrze i podkatalogu wyników (np. "KMB")
+        virtual std::string nazwa() const = 0;
+        //  nazwa kolumny w plikach CSV migawek (np. "U_KMB")
+        virtual std::string kolumna() const = 0;
+        //  początek nazw plików migawek w podkatalogu wyników (np. "KMBresults")
+        virtual std::string prefiks() const = 0;
+
+        //  true - krok() zwraca błąd poziomu wejściowego U_old (schemat jawny),
+        //  false - błąd nowego poziomu U_new (schemat niejawny)
+        virtual bool blad_poziomu_wejsciowego() const = 0;
+
+        //  przygotowanie do symulacji na siatce N węzłów (np. faktoryzacja macierzy)
+        virtual void przygotuj(int N, long double lambda) = 0;
+
+        //  krok czasowy U_old -> U_new; U_ref - rozwiązanie odniesienia
+        //  (wg blad_poziomu_wejsciowego()) lub nullptr; zwraca max błąd lub 0
+        virtual long double krok(const long double* U_old, long double* U_new, const long double* U_ref) = 0;
+
+        //  względny koszt symulacji N x Ts (kolejność zadań w badaniu
+        //  zbieżności); domyślnie krok liniowy względem N
+        virtual double szacowany_koszt(int N, int Ts) const { return (double)N * Ts; }
+
+        //  dodatkowe informacje o ostatniej symulacji wypisywane przez
+        //  program sterujący (np. statystyka poprawek); domyślnie brak
+        virtual std::string podsumowanie() const { return ""; }
+
+        //--------------------------------------------------------------
+        //  Precyzja obliczeń (PRECYZJA.h). Metoda, która obsługuje inne
+        //  precyzje niż long double, przygotowuje się w precyzji
+        //  ustawionej przed przygotuj() i udostępnia kroki w tych typach.
+        //  Kroki te nie liczą błędu - robi to wywołujący (w long double).
+        //--------------------------------------------------------------
+        virtual bool obsluguje(precyzjapack::Precyzja p) const { return p == precyzjapack::Precyzja::LONG_DOUBLE; }
+
+        void ustaw_precyzje(precyzjapack::Precyzja p) { precyzja_ = p; }
+        precyzjapack::Precyzja precyzja() const { return precyzja_; }
+
+        //  krok czasowy U_old -> U_new w precyzji precyzja() (tylko gdy obsluguje())
+        virtual void krok(const float*, float*) {}
+        virtual void krok(const double*, double*) {}
+        virtual void krok(const ddpack::dd*, ddpack::dd*) {}
+#ifdef PRECYZJA_FLOAT128
+        virtual void krok(const precyzjapack::float128*, precyzjapack::float128*) {}
+#endif
+
+        //--------------------------------------------------------------
+        //  Do k kroków czasowych naraz U_old -> U_new bez wyznaczania błędów
+        //  (np. blokowanie czasowe KMB), gdy poziomy pośrednie nie są
+        //  potrzebne. Wynik taki sam jak kolejnych wywołań krok(); U_old nie
+        //  jest modyfikowane. Zwraca liczbę wykonanych kroków (1..k) albo 0,
+        //  gdy metoda tego nie obsługuje - wtedy wywołujący wykonuje krok().
+        //--------------------------------------------------------------
+        virtual int kroki(const long double*, long double*, int) { return 0; }
+        virtual int kroki(const float*, float*, int) { return 0; }
+        virtual int kroki(const double*, double*, int) { return 0; }
+        virtual int kroki(const ddpack::dd*, ddpack::dd*, int) { return 0; }
+#ifdef PRECYZJA_FLOAT128
+        virtual int kroki(const precyzjapack::float128*, precyzjapack::float128*, int) { return 0; }
+#endif
+
+    private:
+        precyzjapack::Precyzja precyzja_ = precyzjapack::Precyzja::LONG_DOUBLE;
+    };
+
+    using FabrykaMetody = std::function<std::unique_ptr<Metoda>()>;
+
+    //  Rejestr metod: wbudowane są "KMB", "KMB_rownolegly" (silnik
+    //  kmbpack::ParallelKMB, liczba wątków jak opcja --watki), "ML_Thomas" (od
+    //  THOMAS_PARALLEL_MIN_N węzłów - wersja równoległa), "ML_full_LU",
+    //  "ML_LDLT" (dekompozycja LDL^T macierzy symetrycznej) oraz
+    //  "ML_LU_mieszana_float" i "ML_LU_mieszana_double" (dekompozycja LU
+    //  w float / double z poprawianiem rozwiązań do long double);
+    //  zarejestrowanie istniejącej nazwy zastępuje poprzednią fabrykę
+    void zarejestruj_metode(const std::string& nazwa, FabrykaMetody fabryka);
+    //  nowy obiekt metody lub nullptr, gdy nazwa nie jest zarejestrowana
+    std::unique_ptr<Metoda> utworz_metode(const std::string& nazwa);
+    std::vector<std::string> dostepne_metody();
+
+}
+
+#endif
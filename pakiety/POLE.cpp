@@ -0,0 +1,399 @@
+#include "POLE.h"
+#include "PROFIL.h"
+#include <cmath>
+#include <cstring>
+#include <iostream>
+
+
+
+static const char POLE_SYGNATURA[8] = {'H', 'E', 'A', 'T', 'P', 'O', 'L', '1'};
+
+static_assert(sizeof(polepack::NaglowekPola) <= (size_t)polepack::POLE_NAGLOWEK,
+    "nagłówek pliku pola nie mieści się w zarezerwowanym miejscu");
+
+static const uint64_t BIT_ZNAKU = 0x8000000000000000ULL;
+
+//  ograniczenie liczby po kwantyzacji (tryb stratny)
+static const double KWANT_MAX = 4.0e18;
+
+
+
+static inline uint64_t na_calkowita(double v, bool stratny, double krok) {
+    //-------------------------------------------------------------------
+    //  Bezstratnie: wzorzec bitowy double przekształcony tak, by porządek
+    //  liczb całkowitych bez znaku odpowiadał porządkowi wartości (bliskie
+    //  wartości -> bliskie liczby). Stratnie: najbliższa wielokrotność kroku.
+    //-------------------------------------------------------------------
+    if (!stratny) {
+        uint64_t u;
+        memcpy(&u, &v, sizeof(u));
+        return (u & BIT_ZNAKU) ? ~u : (u | BIT_ZNAKU);
+    }
+    double q = std::nearbyint(v / krok);
+    if (!(q < KWANT_MAX)) q = (q < 0) ? -KWANT_MAX : KWANT_MAX;     //  także NaN -> KWANT_MAX
+    if (q < -KWANT_MAX) q = -KWANT_MAX;
+    return (uint64_t)(int64_t)q;
+}
+
+
+
+static inline double z_calkowitej(uint64_t q, bool stratny, double krok) {
+    if (!stratny) {
+        uint64_t u = (q & BIT_ZNAKU) ? (q & ~BIT_ZNAKU) : ~q;
+        double v;
+        memcpy(&v, &u, sizeof(v));
+        return v;
+    }
+    return (double)(int64_t)q * krok;
+}
+
+
+
+static inline uint64_t zigzag(uint64_t d) {
+    return (d << 1) ^ (uint64_t)((int64_t)d >> 63);
+}
+
+
+
+static inline uint64_t odwroc_zigzag(uint64_t z) {
+    return (z >> 1) ^ (0 - (z & 1));
+}
+
+
+
+static void kompresuj_kafel(const uint64_t* q, int ld, int h, int w, std::vector<uint8_t>& wyjscie) {
+    //-------------------------------------------------------------------
+    //  Kafel h x w liczb całkowitych (wiersz r zaczyna się od q + r*ld).
+    //  Każdy wiersz dzielony jest na grupy po 64 kolumny; dla grupy
+    //  zapisywana jest szerokość w reszt, a potem w płaszczyzn bitowych
+    //  (słowo b zawiera bit b reszt kolejnych kolumn grupy).
+    //-------------------------------------------------------------------
+    uint64_t z[64];
+    for (int r = 0; r < h; r++) {
+        const uint64_t* wiersz = q + (size_t)r * ld;
+        const uint64_t* poprzedni = wiersz - ld;
+        for (int c0 = 0; c0 < w; c0 += 64) {
+            int m = (w - c0 < 64) ? w - c0 : 64;
+            uint64_t suma = 0;
+            for (int k = 0; k < 64; k++) {
+                if (k >= m) { z[k] = 0; continue; }
+                int c = c0 + k;
+                uint64_t lewy  = (c > 0) ? wiersz[c - 1] : 0;
+                uint64_t gorny = (r > 0) ? poprzedni[c] : 0;
+                uint64_t rog   = (r > 0 && c > 0) ? poprzedni[c - 1] : 0;
+                z[k] = zigzag(wiersz[c] - (lewy + gorny - rog));
+                suma |= z[k];
+            }
+
+            int szer = (suma == 0) ? 0 : 64 - __builtin_clzll(suma);
+            wyjscie.push_back((uint8_t)szer);
+            size_t poczatek = wyjscie.size();
+            wyjscie.resize(poczatek + (size_t)szer * sizeof(uint64_t));
+            //  przejście tylko po ustawionych bitach - reszty są zwykle małe
+            uint64_t plaszczyzny[64] = {0};
+            for (int k = 0; k < m; k++) {
+                for (uint64_t v = z[k]; v != 0; v &= v - 1) {
+                    plaszczyzny[__builtin_ctzll(v)] |= 1ULL << k;
+                }
+            }
+            memcpy(&wyjscie[poczatek], plaszczyzny, (size_t)szer * sizeof(uint64_t));
+        }
+    }
+}
+
+
+
+static bool dekompresuj_kafel(const uint8_t* dane, size_t rozmiar, uint64_t* q, int ld, int h, int w) {
+    //  odwrotność kompresuj_kafel; false gdy dane są niekompletne
+    size_t p = 0;
+    uint64_t z[64];
+    uint64_t plaszczyzny[64];
+    for (int r = 0; r < h; r++) {
+        uint64_t* wiersz = q + (size_t)r * ld;
+        const uint64_t* poprzedni = wiersz - ld;
+        for (int c0 = 0; c0 < w; c0 += 64) {
+            int m = (w - c0 < 64) ? w - c0 : 64;
+            if (p >= rozmiar) return false;
+            int szer = dane[p++];
+            if (szer > 64 || p + (size_t)szer * sizeof(uint64_t) > rozmiar) return false;
+            memcpy(plaszczyzny, dane + p, (size_t)szer * sizeof(uint64_t));
+            p += (size_t)szer * sizeof(uint64_t);
+
+            memset(z, 0, sizeof(z));
+            for (int bit = 0; bit < szer; bit++) {
+                for (uint64_t s = plaszczyzny[bit]; s != 0; s &= s - 1) {
+                    z[__builtin_ctzll(s)] |= 1ULL << bit;
+                }
+            }
+            for (int k = 0; k < m; k++) {
+                int c = c0 + k;
+                uint64_t lewy  = (c > 0) ? wiersz[c - 1] : 0;
+                uint64_t gorny = (r > 0) ? poprzedni[c] : 0;
+                uint64_t rog   = (r > 0 && c > 0) ? poprzedni[c - 1] : 0;
+                wiersz[c] = odwroc_zigzag(z[k]) + (lewy + gorny - rog);
+            }
+        }
+    }
+    return p == rozmiar;
+}
+
+
+
+polepack::ZapisPola::ZapisPola(const std::string& nazwa, const long double* X, int N, double dokladnosc,
+        int Bt, int Bx)
+    : plik(nullptr), pozycja(0), bajty_danych(0), wiersze(0) {
+    //-------------------------------------------------------------------
+    //  Tworzy plik, rezerwuje miejsce na nagłówek i zapisuje siatkę X.
+    //
+    //  Argumenty:
+    //      dokladnosc - maksymalny błąd bezwzględny zapisanych wartości
+    //                   (0 - zapis bezstratny wartości double)
+    //      Bt, Bx     - rozmiar kafla (Bx zaokrąglany w górę do wielokrotności 64)
+    //-------------------------------------------------------------------
+    if (Bt < 1) Bt = 1;
+    if (Bx < 64) Bx = 64;
+    Bx = (Bx + 63) / 64 * 64;
+
+    memset(&naglowek, 0, sizeof(naglowek));
+    naglowek.wersja = POLE_WERSJA;
+    naglowek.N = N;
+    naglowek.Bt = Bt;
+    naglowek.Bx = Bx;
+    naglowek.stratny = (dokladnosc > 0) ? 1 : 0;
+    naglowek.dokladnosc = (dokladnosc > 0) ? dokladnosc : 0.0;
+    naglowek.krok = 2.0 * naglowek.dokladnosc;
+
+    pas.assign((size_t)Bt * N, 0);
+
+    plik = fopen(nazwa.c_str(), "wb");
+    if (plik == nullptr) {
+        std::cerr << "Nie można utworzyć pliku " << nazwa << "\n";
+        return;
+    }
+
+    char zera[POLE_NAGLOWEK] = {0};
+    fwrite(zera, 1, POLE_NAGLOWEK, plik);
+    pozycja = POLE_NAGLOWEK;
+
+    std::vector<double> x(X, X + N);
+    naglowek.off_X = pozycja;
+    fwrite(x.data(), sizeof(double), N, plik);
+    pozycja += (uint64_t)N * sizeof(double);
+}
+
+
+
+polepack::ZapisPola::~ZapisPola() {
+    zamknij();
+}
+
+
+
+void polepack::ZapisPola::dodaj_poziom(long double t, const long double* U) {
+    if (plik == nullptr) return;
+
+    const int N = naglowek.N;
+    const bool stratny = naglowek.stratny != 0;
+    const double krok = naglowek.krok;
+    uint64_t* wiersz = pas.data() + (size_t)wiersze * N;
+    for (int i = 0; i < N; i++) {
+        wiersz[i] = na_calkowita((double)U[i], stratny, krok);
+    }
+    czasy.push_back((double)t);
+
+    if (++wiersze == naglowek.Bt) zapisz_pas();
+}
+
+
+
+void polepack::ZapisPola::zapisz_pas() {
+    PROFIL_ZAKRES("pole: kompresja pasa");
+    //  kompresuje i dopisuje kafle bieżącego pasa (od lewej do prawej)
+    const int N = naglowek.N;
+    for (int c0 = 0; c0 < N; c0 += naglowek.Bx) {
+        int w = (N - c0 < naglowek.Bx) ? N - c0 : naglowek.Bx;
+        bufor.clear();
+        kompresuj_kafel(pas.data() + c0, N, wiersze, w, bufor);
+
+        WpisKafla wpis;
+        wpis.off = pozycja;
+        wpis.rozmiar = bufor.size();
+        fwrite(bufor.data(), 1, bufor.size(), plik);
+        pozycja += bufor.size();
+        bajty_danych += bufor.size();
+        indeks.push_back(wpis);
+    }
+    wiersze = 0;
+}
+
+
+
+void polepack::ZapisPola::zamknij() {
+    //-------------------------------------------------------------------
+    //  Zapisuje niepełny ostatni pas, tablicę czasów, indeks kafli oraz
+    //  nagłówek z sygnaturą (plik przerwanego zapisu nie zostanie odczytany).
+    //-------------------------------------------------------------------
+    if (plik == nullptr) return;
+    if (wiersze > 0) zapisz_pas();
+
+    naglowek.liczba_poziomow = (int64_t)czasy.size();
+    naglowek.off_T = pozycja;
+    fwrite(czasy.data(), sizeof(double), czasy.size(), plik);
+    pozycja += czasy.size() * sizeof(double);
+
+    naglowek.n_kafli = indeks.size();
+    naglowek.off_indeks = pozycja;
+    fwrite(indeks.data(), sizeof(WpisKafla), indeks.size(), plik);
+    pozycja += indeks.size() * sizeof(WpisKafla);
+
+    memcpy(naglowek.sygnatura, POLE_SYGNATURA, sizeof(POLE_SYGNATURA));
+    fseek(plik, 0, SEEK_SET);
+    fwrite(&naglowek, sizeof(naglowek), 1, plik);
+    fclose(plik);
+    plik = nullptr;
+}
+
+
+
+polepack::OdczytPola::~OdczytPola() {
+    zamknij();
+}
+
+
+
+void polepack::OdczytPola::zamknij() {
+    if (plik != nullptr) fclose(plik);
+    plik = nullptr;
+    naglowek = NaglowekPola();
+    x.clear();
+    czasy.clear();
+    indeks.clear();
+    kafle_x = 0;
+    biezacy = -1;
+    dekompresje = 0;
+}
+
+
+
+bool polepack::OdczytPola::otworz(const std::string& nazwa) {
+    //-------------------------------------------------------------------
+    //  Wczytuje nagłówek, siatkę X, czasy i indeks kafli oraz sprawdza
+    //  ich spójność z rozmiarem pliku. Kafle nie są jeszcze czytane.
+    //-------------------------------------------------------------------
+    zamknij();
+
+    plik = fopen(nazwa.c_str(), "rb");
+    if (plik == nullptr) {
+        std::cerr << "Nie można otworzyć pliku " << nazwa << "\n";
+        return false;
+    }
+    fseek(plik, 0, SEEK_END);
+    uint64_t rozmiar = (uint64_t)ftell(plik);
+    fseek(plik, 0, SEEK_SET);
+
+    const char* powod = nullptr;
+    if (rozmiar < (uint64_t)POLE_NAGLOWEK || fread(&naglowek, sizeof(naglowek), 1, plik) != 1
+            || memcmp(naglowek.sygnatura, POLE_SYGNATURA, sizeof(POLE_SYGNATURA)) != 0) {
+        powod = "brak sygnatury (plik niekompletny lub innego typu)";
+    } else if (naglowek.wersja != (uint32_t)POLE_WERSJA) {
+        powod = "nieobsługiwana wersja formatu";
+    } else if (naglowek.N < 1 || naglowek.Bt < 1 || naglowek.Bx < 64 || naglowek.Bx % 64 != 0
+            || naglowek.liczba_poziomow < 0) {
+        powod = "błędne wymiary";
+    } else {
+        kafle_x = (naglowek.N + naglowek.Bx - 1) / naglowek.Bx;
+        uint64_t pasy = (naglowek.liczba_poziomow + naglowek.Bt - 1) / naglowek.Bt;
+        bool ok = naglowek.n_kafli == pasy * kafle_x
+            && naglowek.off_X + (uint64_t)naglowek.N * sizeof(double) <= rozmiar
+            && naglowek.off_T + (uint64_t)naglowek.liczba_poziomow * sizeof(double) <= rozmiar
+            && naglowek.off_indeks + naglowek.n_kafli * sizeof(WpisKafla) <= rozmiar;
+        if (ok) {
+            x.resize(naglowek.N);
+            czasy.resize(naglowek.liczba_poziomow);
+            indeks.resize(naglowek.n_kafli);
+            fseek(plik, (long)naglowek.off_X, SEEK_SET);
+            ok = fread(x.data(), sizeof(double), x.size(), plik) == x.size();
+            fseek(plik, (long)naglowek.off_T, SEEK_SET);
+            ok = ok && fread(czasy.data(), sizeof(double), czasy.size(), plik) == czasy.size();
+            fseek(plik, (long)naglowek.off_indeks, SEEK_SET);
+            ok = ok && fread(indeks.data(), sizeof(WpisKafla), indeks.size(), plik) == indeks.size();
+            for (size_t k = 0; k < indeks.size() && ok; k++) {
+                ok = indeks[k].off + indeks[k].rozmiar <= rozmiar;
+            }
+        }
+        if (!ok) powod = "uszkodzony indeks";
+    }
+
+    if (powod != nullptr) {
+        std::cerr << "Plik " << nazwa << ": " << powod << "\n";
+        zamknij();
+        return false;
+    }
+    kafel.resize((size_t)naglowek.Bt * naglowek.Bx);
+    return true;
+}
+
+
+
+bool polepack::OdczytPola::wczytaj_kafel(int p, int j) {
+    //  czyta i dekompresuje kafel (pas p, kolumna j) do bufora kafel (Bt x Bx)
+    long k = (long)p * kafle_x + j;
+    if (k == biezacy) return true;
+
+    const int Bt = naglowek.Bt, Bx = naglowek.Bx;
+    int h = (int)((naglowek.liczba_poziomow - (int64_t)p * Bt < Bt) ? naglowek.liczba_poziomow - (int64_t)p * Bt : Bt);
+    int w = (naglowek.N - j * Bx < Bx) ? naglowek.N - j * Bx : Bx;
+
+    bufor.resize(indeks[k].rozmiar);
+    fseek(plik, (long)indeks[k].off, SEEK_SET);
+    if (fread(bufor.data(), 1, bufor.size(), plik) != bufor.size()) return false;
+
+    calkowite.resize((size_t)h * w);
+    const uint64_t* q = calkowite.data();
+    if (!dekompresuj_kafel(bufor.data(), bufor.size(), calkowite.data(), w, h, w)) {
+        std::cerr << "Uszkodzony kafel " << k << "\n";
+        biezacy = -1;
+        return false;
+    }
+
+    const bool stratny = naglowek.stratny != 0;
+    const double krok = naglowek.krok;
+    for (int r = 0; r < h; r++) {
+        for (int c = 0; c < w; c++) {
+            kafel[(size_t)r * Bx + c] = z_calkowitej(q[(size_t)r * w + c], stratny, krok);
+        }
+    }
+    biezacy = k;
+    dekompresje++;
+    return true;
+}
+
+
+
+bool polepack::OdczytPola::wycinek(int n0, int n1, int i0, int i1, double* wynik) {
+    //-------------------------------------------------------------------
+    //  Dekompresuje tylko kafle przecinające prostokąt [n0, n1) x [i0, i1)
+    //  i kopiuje z nich odpowiednie fragmenty.
+    //-------------------------------------------------------------------
+    if (plik == nullptr || n0 < 0 || i0 < 0 || n0 >= n1 || i0 >= i1
+            || n1 > liczba_poziomow() || i1 > N()) {
+        return false;
+    }
+
+    const int Bt = naglowek.Bt, Bx = naglowek.Bx;
+    const int szer = i1 - i0;
+    for (int p = n0 / Bt; p <= (n1 - 1) / Bt; p++) {
+        int r0 = (n0 > p * Bt) ? n0 : p * Bt;
+        int r1 = (n1 < (p + 1) * Bt) ? n1 : (p + 1) * Bt;
+        for (int j = i0 / Bx; j <= (i1 - 1) / Bx; j++) {
+            if (!wczytaj_kafel(p, j)) return false;
+            int c0 = (i0 > j * Bx) ? i0 : j * Bx;
+            int c1 = (i1 < (j + 1) * Bx) ? i1 : (j + 1) * Bx;
+            for (int n = r0; n < r1; n++) {
+                const double* zrodlo = kafel.data() + (size_t)(n - p * Bt) * Bx + (c0 - j * Bx);
+                memcpy(wynik + (size_t)(n - n0) * szer + (c0 - i0), zrodlo, (size_t)(c1 - c0) * sizeof(double));
+            }
+        }
+    }
+    return true;
+}
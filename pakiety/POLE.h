@@ -0,0 +1,155 @@
+#ifndef __pole_h
+#define __pole_h
+
+#include <cstdint>
+#include <cstdio>
+#include <string>
+#include <vector>
+
+//----------------------------------------------------------------------
+// Pakiet zapisu całego pola U(x, t) (wszystkie poziomy czasowe) w pliku
+// podzielonym na kafle czas x przestrzeń. Kafle kompresowane są
+// niezależnie, a indeks kafli pozwala odczytać dowolny poziom czasowy,
+// przekrój w punkcie x lub prostokąt (t, x), dekompresując jedynie
+// kafle, które zapytanie obejmuje.
+//
+// Kompresja kafla:
+//  - wartości zamieniane są na liczby całkowite: bezstratnie (wzorzec
+//    bitowy liczby double w porządku monotonicznym) albo z ograniczonym
+//    błędem (kwantyzacja z krokiem 2*dokladnosc, |U - U'| <= dokladnosc),
+//  - każda liczba przewidywana jest z sąsiadów w kaflu (predyktor
+//    Lorenzo: q[r-1][c] + q[r][c-1] - q[r-1][c-1]); arytmetyka
+//    całkowita modulo 2^64, więc predykcja jest dokładnie odwracalna,
+//  - reszty (kodowanie zigzag) pakowane są w grupach po 64 jako
+//    płaszczyzny bitowe: bajt szerokości w, potem w słów 64-bitowych.
+// Pole gładkie daje małe reszty, więc w jest niewielkie.
+//
+// Wartości przechowywane są w precyzji double.
+//----------------------------------------------------------------------
+namespace polepack{
+
+    //  domyślny rozmiar kafla: POLE_BT poziomów czasowych x POLE_BX węzłów
+    //  (POLE_BX musi być wielokrotnością 64)
+    const int POLE_BT = 64;
+    const int POLE_BX = 256;
+
+    const int POLE_WERSJA = 1;
+    const int POLE_NAGLOWEK = 256;
+
+    struct NaglowekPola {
+        char     sygnatura[8];      //  "HEATPOL1"
+        uint32_t wersja;
+        int32_t  N;                 //  liczba węzłów siatki przestrzennej
+        int32_t  Bt, Bx;            //  rozmiar kafla
+        int32_t  stratny;           //  0 - bezstratnie, 1 - z ograniczonym błędem
+        int32_t  zarezerwowane;
+        int64_t  liczba_poziomow;
+        double   dokladnosc;        //  maksymalny błąd bezwzględny (tryb stratny)
+        double   krok;              //  krok kwantyzacji (2*dokladnosc)
+        uint64_t off_X;             //  N liczb double
+        uint64_t off_T;             //  liczba_poziomow liczb double
+        uint64_t off_indeks;        //  WpisKafla dla każdego kafla, wierszami pasów czasowych
+        uint64_t n_kafli;
+    };
+
+    struct WpisKafla {
+        uint64_t off;
+        uint64_t rozmiar;
+    };
+
+
+    //------------------------------------------------------------------
+    // Zapis pola: poziomy czasowe podawane kolejno; po zebraniu pasa
+    // Bt poziomów kafle pasa są kompresowane i dopisywane do pliku.
+    // Indeks, tablica czasów i nagłówek zapisywane są w zamknij().
+    // dokladnosc == 0 oznacza zapis bezstratny.
+    //------------------------------------------------------------------
+    class ZapisPola {
+    public:
+        ZapisPola(const std::string& nazwa, const long double* X, int N, double dokladnosc = 0.0,
+            int Bt = POLE_BT, int Bx = POLE_BX);
+        ~ZapisPola();
+
+        ZapisPola(const ZapisPola&) = delete;
+        ZapisPola& operator=(const ZapisPola&) = delete;
+
+        bool otwarty() const { return plik != nullptr; }
+
+        void dodaj_poziom(long double t, const long double* U);
+        void zamknij();
+
+        //  rozmiar danych skompresowanych (bez nagłówka, X i indeksu)
+        uint64_t rozmiar_danych() const { return bajty_danych; }
+
+    private:
+        void zapisz_pas();
+
+        FILE* plik;
+        NaglowekPola naglowek;
+        uint64_t pozycja;
+        uint64_t bajty_danych;
+
+        std::vector<uint64_t> pas;          //  Bt wierszy po N liczb całkowitych
+        int wiersze;                        //  wypełnione wiersze bieżącego pasa
+        std::vector<double> czasy;
+        std::vector<WpisKafla> indeks;
+        std::vector<uint8_t> bufor;         //  skompresowany kafel
+    };
+
+
+    //------------------------------------------------------------------
+    // Odczyt pola: przy otwarciu wczytywane są nagłówek, X, czasy i
+    // indeks; kafle czytane są z pliku dopiero w zapytaniach. Ostatnio
+    // zdekompresowany kafel jest pamiętany (kolejne poziomy czasowe
+    // z tego samego pasa nie wymagają ponownej dekompresji).
+    //------------------------------------------------------------------
+    class OdczytPola {
+    public:
+        OdczytPola() = default;
+        ~OdczytPola();
+
+        OdczytPola(const OdczytPola&) = delete;
+        OdczytPola& operator=(const OdczytPola&) = delete;
+
+        //  false (z komunikatem na stderr), gdy plik nie istnieje lub ma zły format
+        bool otworz(const std::string& nazwa);
+        void zamknij();
+
+        int N() const { return naglowek.N; }
+        int liczba_poziomow() const { return (int)naglowek.liczba_poziomow; }
+        bool stratny() const { return naglowek.stratny != 0; }
+        double dokladnosc() const { return naglowek.dokladnosc; }
+        const double* X() const { return x.data(); }
+        const double* T() const { return czasy.data(); }
+
+        //  Prostokąt poziomów [n0, n1) x węzłów [i0, i1), wierszami
+        //  (wynik[(n - n0)*(i1 - i0) + (i - i0)]). false dla złego zakresu.
+        bool wycinek(int n0, int n1, int i0, int i1, double* wynik);
+        //  poziom czasowy n (N wartości)
+        bool poziom(int n, double* U) { return wycinek(n, n + 1, 0, N(), U); }
+        //  przebieg w czasie w węźle i (liczba_poziomow() wartości)
+        bool przekroj(int i, double* U_t) { return wycinek(0, liczba_poziomow(), i, i + 1, U_t); }
+
+        //  liczba kafli zdekompresowanych od otwarcia pliku
+        long liczba_dekompresji() const { return dekompresje; }
+
+    private:
+        bool wczytaj_kafel(int pas, int kolumna);
+
+        FILE* plik = nullptr;
+        NaglowekPola naglowek = {};
+        std::vector<double> x;
+        std::vector<double> czasy;
+        std::vector<WpisKafla> indeks;
+        int kafle_x = 0;
+
+        std::vector<uint8_t> bufor;
+        std::vector<uint64_t> calkowite;
+        std::vector<double> kafel;          //  ostatnio zdekompresowany kafel (Bt x Bx)
+        long biezacy = -1;                  //  jego numer w indeksie
+        long dekompresje = 0;
+    };
+
+}
+
+#endif
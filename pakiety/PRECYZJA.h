@@ -0,0 +1,114 @@
+#ifndef __precyzja_h
+#define __precyzja_h
+
+#include <string>
+#include <tuple>
+
+#include "DD.h"
+
+//----------------------------------------------------------------------
+// Pakiet wyboru precyzji obliczeń. Jądra (utilspack, thomaspack,
+// lupack, kmbpack) i kroki metod są szablonami typu skalarnego
+// z jawnymi instancjami dla typów z PRECYZJA_DLA_TYPOW; precyzja
+// symulacji wybierana jest w czasie działania programu:
+//
+//  float, double    - obliczenia wektorowe, szybkie (przebiegi produkcyjne)
+//  long double      - x87 80 bitów, wersja referencyjna (domyślna)
+//  double_double    - ddpack::dd, ok. 106 bitów mantysy z działań na double
+//                     (dokładniejsza niż long double, jądro KMB wektorowe)
+//  __float128       - programowa, 113 bitów mantysy (badania dokładności;
+//                     tylko GCC/Clang na x86-64, patrz PRECYZJA_FLOAT128)
+//
+// Rozwiązanie analityczne i błędy zawsze liczone są w long double.
+//----------------------------------------------------------------------
+namespace precyzjapack{
+
+#if defined(__SIZEOF_FLOAT128__)
+    #define PRECYZJA_FLOAT128
+    typedef __float128 float128;
+#endif
+
+    enum class Precyzja { FLOAT, DOUBLE, LONG_DOUBLE, DOUBLE_DOUBLE, FLOAT128 };
+
+    inline const char* nazwa_precyzji(Precyzja p) {
+        switch (p) {
+            case Precyzja::FLOAT:       return "float";
+            case Precyzja::DOUBLE:      return "double";
+            case Precyzja::LONG_DOUBLE: return "long_double";
+            case Precyzja::DOUBLE_DOUBLE: return "double_double";
+            case Precyzja::FLOAT128:    return "float128";
+        }
+        return "?";
+    }
+
+    //  czy typ precyzji p jest dostępny w tej kompilacji
+    inline bool dostepna(Precyzja p) {
+#ifdef PRECYZJA_FLOAT128
+        (void)p;
+        return true;
+#else
+        return p != Precyzja::FLOAT128;
+#endif
+    }
+
+    //  nazwa (jak w nazwa_precyzji) -> precyzja; false dla nieznanej lub niedostępnej
+    inline bool parsuj_precyzje(const std::string& nazwa, Precyzja& p) {
+        for (Precyzja q : {Precyzja::FLOAT, Precyzja::DOUBLE, Precyzja::LONG_DOUBLE,
+                Precyzja::DOUBLE_DOUBLE, Precyzja::FLOAT128}) {
+            if (nazwa == nazwa_precyzji(q) && dostepna(q)) {
+                p = q;
+                return true;
+            }
+        }
+        return false;
+    }
+
+    //  |x| dla każdego typu skalarnego (std::fabs nie obsługuje __float128)
+    template <typename T>
+    inline T modul(T x) { return x < T(0) ? -x : x; }
+
+    //  Krok redukcji błędu maksymalnego: max_err = max(max_err, e), przy
+    //  czym NaN w e trafia do wyniku i już w nim pozostaje (samo porównanie
+    //  e > max_err pomija NaN - rozbieżne rozwiązanie dawałoby mały błąd)
+    template <typename T>
+    inline void max_bledu(T& max_err, T e) { if (e > max_err || e != e) max_err = e; }
+
+    //------------------------------------------------------------------
+    //  Wywołanie f(T()) dla typu odpowiadającego precyzji p, np.
+    //      dla_precyzji(p, [&](auto zero) { using T = decltype(zero); ... });
+    //  Wszystkie gałęzie muszą zwracać ten sam typ.
+    //------------------------------------------------------------------
+    template <typename F>
+    auto dla_precyzji(Precyzja p, F&& f) -> decltype(f((long double)0)) {
+        switch (p) {
+            case Precyzja::FLOAT:  return f(0.0f);
+            case Precyzja::DOUBLE: return f(0.0);
+            case Precyzja::DOUBLE_DOUBLE: return f(ddpack::dd());
+#ifdef PRECYZJA_FLOAT128
+            case Precyzja::FLOAT128: return f((float128)0);
+#endif
+            default: return f(0.0L);
+        }
+    }
+
+    //  Krotka W<T> dla wszystkich typów (np. bufory lub faktoryzacje
+    //  we wszystkich precyzjach); element: std::get<W<T>>(krotka)
+#ifdef PRECYZJA_FLOAT128
+    template <template <typename> class W>
+    using DlaTypow = std::tuple<W<float>, W<double>, W<long double>, W<ddpack::dd>, W<float128>>;
+#else
+    template <template <typename> class W>
+    using DlaTypow = std::tuple<W<float>, W<double>, W<long double>, W<ddpack::dd>>;
+#endif
+
+}
+
+//  Jawne instancje szablonów: PRECYZJA_DLA_TYPOW(MAKRO) rozwija MAKRO(T)
+//  dla wszystkich typów skalarnych
+#ifdef PRECYZJA_FLOAT128
+    #define PRECYZJA_DLA_TYPOW(M) M(float) M(double) M(long double) M(ddpack::dd) M(precyzjapack::float128)
+#else
+    #define PRECYZJA_DLA_TYPOW(M) M(float) M(double) M(long double) M(ddpack::dd)
+#endif
+
+#endif
@@ -0,0 +1,159 @@
+#include <cmath>
+#include <cstdio>
+#include <memory>
+#include <mutex>
+#include <ostream>
+#include <string>
+#include <vector>
+#include "PROFIL.h"
+
+
+
+thread_local profilpack::BlokWatku* profilpack::blok_watku = nullptr;
+
+
+
+namespace {
+
+    struct Rejestr {
+        std::mutex mtx;
+        std::vector<std::string> nazwy;
+        std::vector<std::unique_ptr<profilpack::BlokWatku>> bloki;
+
+        //  punkt odniesienia czasu (pierwsza rejestracja fazy)
+        bool start_ustawiony = false;
+        uint64_t start_takty = 0;
+        std::chrono::steady_clock::time_point start_zegar;
+    };
+
+    Rejestr& rejestr() {
+        static Rejestr r;
+        return r;
+    }
+
+}
+
+
+
+profilpack::BlokWatku* profilpack::nowy_blok_watku() {
+    Rejestr& r = rejestr();
+    std::lock_guard<std::mutex> lock(r.mtx);
+    r.bloki.emplace_back(new BlokWatku());
+    blok_watku = r.bloki.back().get();
+    return blok_watku;
+}
+
+
+
+int profilpack::rejestruj(const char* nazwa) {
+    Rejestr& r = rejestr();
+    std::lock_guard<std::mutex> lock(r.mtx);
+    if (!r.start_ustawiony) {
+        r.start_ustawiony = true;
+        r.start_takty = takty();
+        r.start_zegar = std::chrono::steady_clock::now();
+    }
+    for (size_t id = 0; id < r.nazwy.size(); id++) {
+        if (r.nazwy[id] == nazwa) return (int)id;
+    }
+    if ((int)r.nazwy.size() >= PROFIL_MAX_FAZ) return -1;
+    r.nazwy.push_back(nazwa);
+    return (int)r.nazwy.size() - 1;
+}
+
+
+
+void profilpack::wyzeruj() {
+    Rejestr& r = rejestr();
+    std::lock_guard<std::mutex> lock(r.mtx);
+    for (auto& b : r.bloki) {
+        for (Licznik& l : b->fazy) l = Licznik();
+    }
+    r.start_takty = takty();
+    r.start_zegar = std::chrono::steady_clock::now();
+}
+
+
+
+static double wartosc_koszyka(int j) {
+    //  środek przedziału taktów odpowiadającego koszykowi j (odwrotność koszyk())
+    if (j < 4) return (double)j;
+    int k = j / 4 + 1;
+    double szerokosc = std::ldexp(1.0, k - 2);
+    return (4 + j % 4) * szerokosc + 0.5 * szerokosc;
+}
+
+
+
+static double percentyl(const uint64_t* histogram, uint64_t n, uint64_t max, double p) {
+    uint64_t cel = (uint64_t)(p * (double)(n - 1)) + 1;
+    uint64_t suma = 0;
+    for (int j = 0; j < profilpack::PROFIL_KOSZYKI; j++) {
+        suma += histogram[j];
+        if (suma >= cel) return std::fmin(wartosc_koszyka(j), (double)max);
+    }
+    return (double)max;
+}
+
+
+
+void profilpack::raport(std::ostream& out) {
+    //-------------------------------------------------------------------
+    //  Częstotliwość TSC wyznaczana jest z czasu od pierwszej rejestracji
+    //  (dla bardzo krótkich przebiegów - z dodatkowego pomiaru 20 ms).
+    //  Percentyle odczytywane są z histogramu (dokładność ok. 12%).
+    //-------------------------------------------------------------------
+    Rejestr& r = rejestr();
+    std::lock_guard<std::mutex> lock(r.mtx);
+    if (!r.start_ustawiony) {
+        out << "Profil: brak zmierzonych faz\n";
+        return;
+    }
+
+    uint64_t t1 = takty();
+    std::chrono::steady_clock::time_point z1 = std::chrono::steady_clock::now();
+    double sekundy = std::chrono::duration<double>(z1 - r.start_zegar).count();
+    double czestotliwosc = (sekundy > 0) ? (double)(t1 - r.start_takty) / sekundy : 0.0;
+    if (sekundy < 0.02) {
+        uint64_t k0 = takty();
+        std::chrono::steady_clock::time_point s0 = std::chrono::steady_clock::now(), s1;
+        do {
+            s1 = std::chrono::steady_clock::now();
+        } while (std::chrono::duration<double>(s1 - s0).count() < 0.02);
+        czestotliwosc = (double)(takty() - k0) / std::chrono::duration<double>(s1 - s0).count();
+    }
+    if (!(czestotliwosc > 0)) czestotliwosc = 1.0e9;
+
+    char linia[256];
+    std::snprintf(linia, sizeof linia, "Profil faz (czas od początku pomiaru: %.3f s, TSC %.3f GHz)\n",
+        sekundy, czestotliwosc * 1e-9);
+    out << linia;
+    std::snprintf(linia, sizeof linia, "%-30s %11s %7s %11s %7s %11s %10s %10s %10s %10s\n",
+        "faza", "wywołania", "wątki", "suma[s]", "%", "śr.[us]", "p50[us]", "p90[us]", "p99[us]", "max[us]");
+    out << linia;
+
+    const double us = 1.0e6 / czestotliwosc;
+    for (size_t id = 0; id < r.nazwy.size(); id++) {
+        uint64_t wywolania = 0, suma = 0, max = 0;
+        int watki = 0;
+        uint64_t histogram[PROFIL_KOSZYKI] = {};
+        for (auto& b : r.bloki) {
+            const Licznik& l = b->fazy[id];
+            if (l.wywolania == 0) continue;
+            watki++;
+            wywolania += l.wywolania;
+            suma += l.suma;
+            if (l.max > max) max = l.max;
+            for (int j = 0; j < PROFIL_KOSZYKI; j++) histogram[j] += l.histogram[j];
+        }
+        if (wywolania == 0) continue;
+
+        double s = (double)suma / czestotliwosc;
+        std::snprintf(linia, sizeof linia, "%-30s %10llu %6d %11.4f %7.2f %10.3f %10.3f %10.3f %10.3f %10.3f\n",
+            r.nazwy[id].c_str(), (unsigned long long)wywolania, watki, s,
+            sekundy > 0 ? 100.0 * s / sekundy : 0.0, (double)suma / wywolania * us,
+            percentyl(histogram, wywolania, max, 0.50) * us, percentyl(histogram, wywolania, max, 0.90) * us,
+            percentyl(histogram, wywolania, max, 0.99) * us, (double)max * us);
+        out << linia;
+    }
+}
@@ -0,0 +1,121 @@
+#ifndef __profil_h
+#define __profil_h
+
+#include <cstdint>
+#include <iosfwd>
+#include <chrono>
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#endif
+
+//----------------------------------------------------------------------
+// Pakiet pomiaru czasu faz obliczeń (krok metody, błąd, migawki, zapis
+// plików, ...). Faza mierzona jest w zakresie (bloku) kodu licznikiem
+// taktów procesora (TSC); każdy wątek ma własne liczniki, więc pomiar
+// nie wymaga synchronizacji. Dla każdej fazy zbierane są: liczba
+// wywołań, suma, maksimum i histogram czasów (percentyle w raporcie).
+//
+// Pomiar włączany jest przy kompilacji: -DPROFILOWANIE. Bez tej flagi
+// makra PROFIL_ZAKRES i PROFIL_RAPORT nie generują żadnego kodu.
+//
+//  void krok(...) {
+//      PROFIL_ZAKRES("KMB: krok");
+//      ...
+//  }
+//  ...
+//  PROFIL_RAPORT(std::cout);
+//----------------------------------------------------------------------
+namespace profilpack{
+
+    const int PROFIL_MAX_FAZ = 64;
+    //  histogram: 4 przedziały na każdą potęgę dwójki liczby taktów
+    const int PROFIL_KOSZYKI = 4 * 64;
+
+    struct Licznik {
+        uint64_t wywolania = 0;
+        uint64_t suma = 0;          //  [takty]
+        uint64_t max = 0;
+        uint32_t histogram[PROFIL_KOSZYKI] = {};
+    };
+
+    //  Liczniki jednego wątku (zachowywane po zakończeniu wątku - raport
+    //  obejmuje też wątki, które już się zakończyły)
+    struct BlokWatku {
+        Licznik fazy[PROFIL_MAX_FAZ];
+    };
+
+    extern thread_local BlokWatku* blok_watku;
+    BlokWatku* nowy_blok_watku();
+
+    //  Numer fazy o podanej nazwie (ta sama nazwa - ten sam numer);
+    //  -1, gdy przekroczono PROFIL_MAX_FAZ (faza nie jest mierzona)
+    int rejestruj(const char* nazwa);
+
+    inline uint64_t takty() {
+#if defined(__x86_64__) || defined(__i386__)
+        return __rdtsc();
+#else
+        return (uint64_t)std::chrono::duration_cast<std::chrono::nanoseconds>(
+            std::chrono::steady_clock::now().time_since_epoch()).count();
+#endif
+    }
+
+    inline int koszyk(uint64_t t) {
+        if (t < 4) return (int)t;
+        int k = 63 - __builtin_clzll(t);
+        return 4 * (k - 1) + (int)((t >> (k - 2)) & 3);
+    }
+
+    inline void dodaj(int id, uint64_t t) {
+        if (id < 0) return;
+        BlokWatku* b = blok_watku != nullptr ? blok_watku : nowy_blok_watku();
+        Licznik& l = b->fazy[id];
+        l.wywolania++;
+        l.suma += t;
+        if (t > l.max) l.max = t;
+        l.histogram[koszyk(t)]++;
+    }
+
+    //  Pomiar od konstrukcji do końca zakresu
+    class Zakres {
+    public:
+        explicit Zakres(int id) : id(id), start(takty()) {}
+        ~Zakres() { dodaj(id, takty() - start); }
+
+        Zakres(const Zakres&) = delete;
+        Zakres& operator=(const Zakres&) = delete;
+
+    private:
+        int id;
+        uint64_t start;
+    };
+
+    //------------------------------------------------------------------
+    // Raport: dla każdej fazy liczba wywołań i wątków, czas łączny,
+    // udział w czasie od pierwszej rejestracji fazy, średnia oraz
+    // percentyle p50/p90/p99 i maksimum jednego wywołania. Czasy faz
+    // zagnieżdżonych wliczają się też do faz zewnętrznych; fazy wątku
+    // zapisu trwają równolegle z obliczeniami. Wywołać, gdy mierzone
+    // wątki nie pracują (np. po zakończeniu zapisu w tle).
+    //------------------------------------------------------------------
+    void raport(std::ostream& out);
+
+    //  Zerowanie liczników wszystkich wątków
+    void wyzeruj();
+
+}
+
+#define PROFIL_SKLEJ2(a, b) a##b
+#define PROFIL_SKLEJ(a, b) PROFIL_SKLEJ2(a, b)
+
+#ifdef PROFILOWANIE
+    #define PROFIL_ZAKRES(nazwa) \
+        static const int PROFIL_SKLEJ(profil_id_, __LINE__) = profilpack::rejestruj(nazwa); \
+        profilpack::Zakres PROFIL_SKLEJ(profil_zakres_, __LINE__)(PROFIL_SKLEJ(profil_id_, __LINE__))
+    #define PROFIL_RAPORT(out) profilpack::raport(out)
+#else
+    #define PROFIL_ZAKRES(nazwa) ((void)0)
+    #define PROFIL_RAPORT(out) ((void)0)
+#endif
+
+#endif
@@ -0,0 +1,288 @@
+#include <algorithm>
+#include <chrono>
+#include <filesystem>
+#include <iostream>
+#include <memory>
+#include <set>
+#include <utility>
+#include "SYMULACJA.h"
+#include "IO.h"
+#include "PROFIL.h"
+#include "THREADS.h"
+
+
+
+//  Krok metody w precyzji T z błędem jak w Metoda::krok (R - rozwiązanie
+//  odniesienia lub nullptr); dla long double błąd liczy sama metoda
+static long double krok_metody(metodypack::Metoda& metoda, const long double* Ua, long double* Ub,
+        const long double* R, int) {
+    return metoda.krok(Ua, Ub, R);
+}
+
+template <typename T>
+static long double krok_metody(metodypack::Metoda& metoda, const T* Ua, T* Ub, const long double* R, int N) {
+    if (R == nullptr) {
+        metoda.krok(Ua, Ub);
+        return 0.0L;
+    }
+    if (metoda.blad_poziomu_wejsciowego()) {
+        long double err = utilspack::max_roznica(Ua, R, N);
+        metoda.krok(Ua, Ub);
+        return err;
+    }
+    metoda.krok(Ua, Ub);
+    return utilspack::max_roznica(Ub, R, N);
+}
+
+
+
+//  Poziom czasowy do zapisu (zapis zawsze w long double)
+static const long double* do_zapisu(const long double* U, int, std::vector<long double>&) {
+    return U;
+}
+
+template <typename T>
+static const long double* do_zapisu(const T* U, int N, std::vector<long double>& bufor) {
+    bufor.resize(N);
+    for (int i = 0; i < N; i++) bufor[i] = static_cast<long double>(U[i]);
+    return bufor.data();
+}
+
+
+
+symulacjapack::WynikSymulacji symulacjapack::Symulacja::uruchom(metodypack::Metoda& metoda, const UstawieniaSymulacji& u) {
+    if (!metoda.obsluguje(u.precyzja) || !precyzjapack::dostepna(u.precyzja)) {
+        std::cerr << "Metoda " << metoda.nazwa() << " nie obsługuje precyzji "
+                  << precyzjapack::nazwa_precyzji(u.precyzja) << "\n";
+        WynikSymulacji w;
+        w.Xs = u.Xs;
+        w.Ts = u.Ts;
+        w.blad_koncowy = -1.0L;
+        return w;
+    }
+    metoda.ustaw_precyzje(u.precyzja);
+    return precyzjapack::dla_precyzji(u.precyzja, [&](auto zero) {
+        return uruchom_w<decltype(zero)>(metoda, u);
+    });
+}
+
+
+
+template <typename T>
+symulacjapack::WynikSymulacji symulacjapack::Symulacja::uruchom_w(metodypack::Metoda& metoda, const UstawieniaSymulacji& u) {
+    //-------------------------------------------------------------------
+    //  Symulacja na siatce Xs x Ts: X[i] = -a + i*h, t_n = n*dt. Pętla
+    //  czasowa odpowiada programom heat_transfer_*.cpp - dla tych samych
+    //  ustawień pliki wyników są identyczne.
+    //
+    //  Błąd e_max(t) liczony jest w każdym kroku tylko wtedy, gdy wyniki
+    //  są zapisywane (w trakcie kroku metody, razem z nowym poziomem);
+    //  błąd w chwili t_max liczony jest zawsze.
+    //
+    //  Poziomy czasowe i krok metody w precyzji T; dla T = long double
+    //  błąd liczony jest w kroku metody, dla pozostałych - po kroku,
+    //  względem rozwiązania analitycznego w long double.
+    //
+    //  Zwraca: parametry siatki, błąd końcowy i czas obliczeń
+    //-------------------------------------------------------------------
+    PROFIL_ZAKRES("symulacja");
+    auto start = std::chrono::high_resolution_clock::now();
+
+    const int Xs = u.Xs, Ts = u.Ts;
+    const utilspack::ParametryFizyczne& f = u.fizyka;
+
+    WynikSymulacji w;
+    w.Xs = Xs;
+    w.Ts = Ts;
+    if (Xs < 3 || Ts < 2) {
+        std::cerr << "Za mała siatka: Xs = " << Xs << ", Ts = " << Ts << " (wymagane Xs >= 3, Ts >= 2)\n";
+        w.blad_koncowy = -1.0L;
+        return w;
+    }
+
+    const long double h  = (2.0L * f.a) / (Xs - 1);    // krok przestrzenny
+    const long double dt = f.t_max / (Ts - 1);         // krok czasowy
+    const long double lambda = f.D * dt / (h * h);
+    w.h = h;
+    w.dt = dt;
+    w.lambda = lambda;
+    if (u.komunikaty) {
+        std::cout << "węzłów przestrzennych: " << Xs << ", węzłów czasowych: " << Ts << ", lambda = " << lambda << std::endl;
+    }
+
+    //  bufory zachowywane między symulacjami (resize nie zmniejsza pojemności)
+    std::vector<T>& U = std::get<Wektor<T>>(this->U);
+    std::vector<T>& Tmp = std::get<Wektor<T>>(this->Tmp);
+    X.resize(Xs);
+    U.resize(Xs);
+    Tmp.resize(Xs);
+    U_ref.resize(Xs);
+    for (int i = 0; i < Xs; ++i) {
+        X[i] = -f.a + static_cast<long double>(i) * h;
+    }
+    utilspack::warunek_poczatkowy(U.data(), X.data(), Xs, f);
+    metoda.przygotuj(Xs, lambda);
+
+    //---------------------------- zapis wyników ----------------------------
+    const bool bledy = (u.zapis != ZapisWynikow::BRAK);
+    const bool csv = (u.zapis == ZapisWynikow::CSV || u.zapis == ZapisWynikow::OBA);
+    const bool binarny = (u.zapis == ZapisWynikow::BINARNY || u.zapis == ZapisWynikow::OBA);
+    const std::string katalog = u.katalog + "/" + metoda.nazwa();
+    const std::string prefiks = katalog + "/" + metoda.prefiks();
+
+    std::set<int> migawki;
+    if (bledy) {
+        for (int n : u.migawki) {
+            if (n < 0) n += Ts;
+            if (n >= 0 && n < Ts) migawki.insert(n);
+        }
+    }
+
+    std::unique_ptr<iopack::AsyncWriter> writer;
+    if (bledy || u.zapis_pola) {
+        std::error_code ec;
+        std::filesystem::create_directories(katalog, ec);
+        writer.reset(new iopack::AsyncWriter(X.data(), Xs, katalog + "/" + metoda.nazwa() + "_maxerror_vs_time.csv", "t,e_max\n"));
+        if (binarny) {
+            iopack::OpisHTB opis;
+            opis.metoda = metoda.nazwa();
+            opis.kolumna = metoda.kolumna();
+            opis.prefiks_migawek = prefiks;
+            opis.D = f.D; opis.b = f.b; opis.a = f.a; opis.t_max = f.t_max;
+            opis.h = h; opis.dt = dt; opis.lambda = lambda; opis.Ts = Ts;
+            writer->zapis_binarny(katalog + "/" + metoda.nazwa() + "_wyniki.htb", opis, csv);
+        }
+        if (u.zapis_pola) {
+            writer->zapis_pola(katalog + "/" + metoda.nazwa() + "_pole.htp", u.dokladnosc_pola);
+        }
+    }
+    const std::string naglowek_migawki = "x," + metoda.kolumna() + ",U_exact\n";
+
+    //---------------------------- pętla czasowa ----------------------------
+    utilspack::RozwiazanieAnalityczne analityczne(X.data(), Xs, nullptr, f);
+    const bool jawna = metoda.blad_poziomu_wejsciowego();
+    T* Ua = U.data();
+    T* Ub = Tmp.data();
+    long double* R = U_ref.data();
+
+    if (bledy && !jawna) {
+        //  schemat niejawny: błędy kolejnych poziomów liczone są w krokach,
+        //  błąd warunku początkowego - osobno
+        analityczne.ustaw_czas(0.0L);
+        analityczne.wartosci(R);
+        writer->zapisz_blad(0.0L, analityczne.max_error(Ua));
+    }
+
+    //  bez zapisu wyników poziomy pośrednie nie są potrzebne - metoda może
+    //  wykonać wiele kroków naraz (Metoda::kroki); pozostałe kroki pętlą niżej
+    int n0 = 0;
+    if (!bledy && !u.zapis_pola) {
+        PROFIL_ZAKRES("symulacja: kroki naraz");
+        while (n0 + 1 < Ts) {
+            int k = metoda.kroki(Ua, Ub, Ts - 1 - n0);
+            if (k <= 0) break;
+            std::swap(Ua, Ub);
+            n0 += k;
+        }
+    }
+
+    for (int n = n0; n < Ts; n++) {
+        PROFIL_ZAKRES("symulacja: poziom czasowy");
+        const long double t = static_cast<long double>(n) * dt;
+        if (u.zapis_pola) writer->zapisz_poziom(t, do_zapisu(Ua, Xs, U_zapis));
+
+        //  R dla poziomu t; w schemacie niejawnym z błędami jest już policzone
+        //  przed poprzednim krokiem
+        const bool migawka = migawki.count(n) > 0;
+        if (jawna ? (bledy || migawka) : (!bledy && migawka)) {
+            analityczne.ustaw_czas(t);
+            analityczne.wartosci(R);
+        }
+        if (migawka) {
+            if (binarny) {
+                writer->zapisz_migawke(n, t, do_zapisu(Ua, Xs, U_zapis), R);
+            } else {
+                writer->zapisz_migawke(prefiks + std::to_string(n) + "iter.csv", naglowek_migawki, t,
+                    do_zapisu(Ua, Xs, U_zapis), R);
+            }
+        }
+
+        if (n + 1 == Ts) {
+            if (bledy && jawna) writer->zapisz_blad(t, analityczne.max_error(Ua));
+            break;
+        }
+
+        if (jawna) {
+            long double err = krok_metody(metoda, Ua, Ub, bledy ? R : nullptr, Xs);
+            if (bledy) writer->zapisz_blad(t, err);
+        } else {
+            const long double t_nowy = static_cast<long double>(n + 1) * dt;
+            if (bledy) {
+                analityczne.ustaw_czas(t_nowy);
+                analityczne.wartosci(R);
+            }
+            long double err = krok_metody(metoda, Ua, Ub, bledy ? R : nullptr, Xs);
+            if (bledy) writer->zapisz_blad(t_nowy, err);
+        }
+        std::swap(Ua, Ub);
+    }
+
+    //  błąd w chwili t_max (jak w badaniu zbieżności, punkt 1 zadania)
+    w.blad_koncowy = utilspack::compute_max_error(Ua, X.data(), f.t_max, Xs, f);
+    if (writer) writer->zakoncz();
+
+    std::chrono::duration<double> czas = std::chrono::high_resolution_clock::now() - start;
+    w.czas = czas.count();
+    return w;
+}
+
+
+
+std::vector<symulacjapack::WynikSymulacji> symulacjapack::badanie_zbieznosci(const std::string& nazwa_metody,
+        const UstawieniaSymulacji& u, int K, int n_watkow) {
+    //-------------------------------------------------------------------
+    //  Koszt rośnie z k jak k^3 (KMB, Laasonen), więc kilka ostatnich
+    //  siatek decyduje o czasie całego badania. Zadania zaczynane są od
+    //  najdroższego - czas badania zbliża się do czasu największej
+    //  siatki, a małe siatki wypełniają luki pozostałych wątków.
+    //-------------------------------------------------------------------
+    std::vector<WynikSymulacji> wyniki(K > 0 ? K : 0);
+    if (K <= 0) return wyniki;
+
+    if (n_watkow <= 0) n_watkow = threadpack::hardware_threads();
+    if (n_watkow > K) n_watkow = K;
+
+    std::vector<std::unique_ptr<metodypack::Metoda>> metody(n_watkow);
+    for (int w = 0; w < n_watkow; w++) {
+        metody[w] = metodypack::utworz_metode(nazwa_metody);
+        if (!metody[w]) {
+            std::cerr << "Nieznana metoda: " << nazwa_metody << "\n";
+            for (WynikSymulacji& r : wyniki) r.blad_koncowy = -1.0L;
+            return wyniki;
+        }
+    }
+    std::vector<Symulacja> symulacje(n_watkow);
+
+    UstawieniaSymulacji uk = u;
+    uk.zapis = ZapisWynikow::BRAK;
+    uk.zapis_pola = false;
+    uk.komunikaty = false;
+
+    std::vector<double> koszt(K);
+    std::vector<int> kolejnosc(K);
+    for (int k = 1; k <= K; k++) {
+        koszt[k - 1] = metody[0]->szacowany_koszt(zbieznosc_Xs(k), zbieznosc_Ts(k));
+        kolejnosc[k - 1] = k;
+    }
+    std::stable_sort(kolejnosc.begin(), kolejnosc.end(),
+        [&](int k1, int k2) { return koszt[k1 - 1] > koszt[k2 - 1]; });
+
+    threadpack::WorkStealingPool pula(n_watkow);
+    pula.run(kolejnosc, [&](int k, int w) {
+        UstawieniaSymulacji us = uk;
+        us.Xs = zbieznosc_Xs(k);
+        us.Ts = zbieznosc_Ts(k);
+        wyniki[k - 1] = symulacje[w].uruchom(*metody[w], us);
+    });
+    return wyniki;
+}
@@ -0,0 +1,89 @@
+#ifndef __symulacja_h
+#define __symulacja_h
+
+#include <string>
+#include <vector>
+
+#include "METODY.h"
+#include "PRECYZJA.h"
+#include "UTILS.h"
+
+//----------------------------------------------------------------------
+// Pakiet wykonujący pojedynczą symulację (siatka, warunek początkowy,
+// pętla czasowa, błędy i zapis wyników) dowolną metodą z rejestru
+// metodypack. Rozmiary siatki, parametry fizyczne i sposób zapisu
+// podawane są w czasie działania programu.
+//----------------------------------------------------------------------
+namespace symulacjapack{
+
+    enum class ZapisWynikow { BRAK, CSV, BINARNY, OBA };
+
+    struct UstawieniaSymulacji {
+        int Xs = 1500;                          //  liczba węzłów siatki przestrzennej
+        int Ts = 39063;                         //  liczba węzłów siatki czasowej
+        utilspack::ParametryFizyczne fizyka;
+
+        //  zapis migawek i błędu e_max(t) do <katalog>/<metoda>/
+        ZapisWynikow zapis = ZapisWynikow::BINARNY;
+        std::string katalog = "wyniki";
+        //  poziomy czasowe migawek (wartości ujemne liczone od końca: -1 -> Ts-1)
+        std::vector<int> migawki = {0, 1, 10, 30, 80, 200, 1000, 10000, -1};
+
+        //  zapis całego pola do <katalog>/<metoda>/<metoda>_pole.htp
+        bool zapis_pola = false;
+        double dokladnosc_pola = 1.0e-10;
+
+        //  wypisywanie rozmiarów siatki na standardowe wyjście
+        bool komunikaty = true;
+
+        //  precyzja poziomów czasowych i kroków metody (Metoda::obsluguje);
+        //  rozwiązanie analityczne i błędy zawsze w long double
+        precyzjapack::Precyzja precyzja = precyzjapack::Precyzja::LONG_DOUBLE;
+    };
+
+    struct WynikSymulacji {
+        int Xs = 0, Ts = 0;
+        long double h = 0, dt = 0, lambda = 0;
+        long double blad_koncowy = 0;           //  max |U - U_exact| w chwili t_max
+        double czas = 0;                        //  czas obliczeń [s]
+    };
+
+    //------------------------------------------------------------------
+    // Symulacja z buforami (siatka, poziomy czasowe, rozwiązanie
+    // odniesienia) zachowywanymi między wywołaniami uruchom() - seria
+    // symulacji alokuje pamięć tylko przy powiększeniu siatki.
+    //------------------------------------------------------------------
+    class Symulacja {
+    public:
+        WynikSymulacji uruchom(metodypack::Metoda& metoda, const UstawieniaSymulacji& u);
+
+    private:
+        template <typename T> WynikSymulacji uruchom_w(metodypack::Metoda& metoda, const UstawieniaSymulacji& u);
+
+        template <typename T> using Wektor = std::vector<T>;
+
+        std::vector<long double> X, U_ref;
+        precyzjapack::DlaTypow<Wektor> U, Tmp;      //  poziomy czasowe w precyzji symulacji
+        std::vector<long double> U_zapis;           //  poziom przeliczony do zapisu (precyzja != long double)
+    };
+
+    //  Siatka badania zbieżności (punkt 1 zadania): Xs = 24k, Ts = 10k^2
+    inline int zbieznosc_Xs(int k) { return 24 * k; }
+    inline int zbieznosc_Ts(int k) { return 10 * k * k; }
+
+    //------------------------------------------------------------------
+    // Badanie zbieżności dla k = 1..K: symulacje bez zapisu wyników
+    // wykonywane równolegle (threadpack::WorkStealingPool), od
+    // najdroższej wg Metoda::szacowany_koszt. Każdy wątek ma własny
+    // obiekt metody i własną Symulację. Wyniki w kolejności k
+    // (wynik[k-1]); blad_koncowy < 0 oznacza nieudaną symulację.
+    //
+    //  u.fizyka, u.precyzja - parametry fizyczne i precyzja (pozostałe pola u są pomijane)
+    //  n_watkow - 0: threadpack::hardware_threads()
+    //------------------------------------------------------------------
+    std::vector<WynikSymulacji> badanie_zbieznosci(const std::string& nazwa_metody,
+        const UstawieniaSymulacji& u, int K, int n_watkow = 0);
+
+}
+
+#endif
@@ -1,12 +1,17 @@
 #include <iostream>
 #include <iomanip>
+#include <math.h>
+#include <mutex>
 #include "THOMAS.h"
+#include "PRECYZJA.h"
+#include "THREADS.h"
 
 using namespace std;
 
 
 
-void thomaspack::thomas_procedure_1(int N, const long double l[], long double d[], const long double u[]) {
+template <typename T>
+void thomaspack::thomas_procedure_1(int N, const T l[], T d[], const T u[]) {
     //-------------------------------------------------------------------
     //  Procedura operująca na macierzy A (trójdiagonalnej).
     //  W rzeczwywistości operacyjnej mamy 3 oddzielne tablice l,d,u
@@ -23,15 +28,16 @@ void thomaspack::thomas_procedure_1(int N, const long double l[], long double d[
     //-------------------------------------------------------------------
     
     for (int i = 1; i < N; i++) {
-        long double m = l[i] / d[i - 1];
+        T m = l[i] / d[i - 1];
         d[i] = d[i] - m * u[i - 1];
     }
 }
 
 
 
-void thomaspack::thomas_procedure_2(int N, const long double l[], const long double u[], 
-        const long double d[], long double b[], long double x[]) {
+template <typename T>
+void thomaspack::thomas_procedure_2(int N, const T l[], const T u[], 
+        const T d[], T b[], T x[]) {
     //-------------------------------------------------------------------
     // Procedura operująca na wektorze b.
     // Najpierw wykonuje eliminację w przód:
@@ -54,7 +60,7 @@ void thomaspack::thomas_procedure_2(int N, const long double l[], const long dou
     // Eliminacja w przód dla wektora b; 
     // modyfikujemy tablicę b "w miejscu" - bez alokowania nowej tablicy
     for (int i = 1; i < N; i++) {
-        long double m = l[i] / d[i - 1];
+        T m = l[i] / d[i - 1];
         b[i] = b[i] - m * b[i - 1];
     }
 
@@ -67,8 +73,9 @@ void thomaspack::thomas_procedure_2(int N, const long double l[], const long dou
 
 
 
-void thomaspack::Thomas(int N, const long double l[], long double d[], const long double u[],
-        long double b[], long double x[]) {
+template <typename T>
+void thomaspack::Thomas(int N, const T l[], T d[], const T u[],
+        T b[], T x[]) {
     //-------------------------------------------------------------------
     // Główna funkcja rozwiązująca układ Ax = b dla macierzy trójdiagonalnej
     // l[1..N-1], d[0..N-1], u[0..N-2], b[0..N-1]; wynik w x[0..N-1]
@@ -87,4 +94,955 @@ void thomaspack::Thomas(int N, const long double l[], long double d[], const lon
 
     thomaspack::thomas_procedure_1(N, l, d, u);
     thomaspack::thomas_procedure_2(N, l, u, d, b, x);
-}
\ No newline at end of file
+}
+
+
+template <typename T>
+thomaspack::ThomasFactorT<T>::ThomasFactorT(int N, const T l[], const T d[],
+        const T u[]) : N(N) {
+    //-------------------------------------------------------------------
+    // Konstruktor wykonuje eliminację w przód (jak thomas_procedure_1)
+    // jeden raz i zapamiętuje wszystko, co potrzebne do późniejszych
+    // rozwiązań. Tablice l, d, u NIE są modyfikowane.
+
+    //  Argumenty:
+    //  N - rozmiar macierzy A
+    //  l[] - tablica wartości dolnej przekątnej macierzy 
+    //  d[] - tablica wartości głównej przekątnej macierzy 
+    //  u[] - tablica wartości górnej przekątnej macierzy 
+    //-------------------------------------------------------------------
+
+    m     = new T[N];
+    inv_d = new T[N];
+    this->u = new T[N];
+
+    T d_prev = d[0];
+    m[0] = T(0);
+    inv_d[0] = T(1) / d_prev;
+    this->u[0] = u[0];
+
+    for (int i = 1; i < N; i++) {
+        m[i] = l[i] * inv_d[i - 1];
+        d_prev = d[i] - m[i] * u[i - 1];
+        inv_d[i] = T(1) / d_prev;
+        this->u[i] = u[i];
+    }
+}
+
+
+
+template <typename T>
+thomaspack::ThomasFactorT<T>::~ThomasFactorT() {
+    delete[] m;
+    delete[] inv_d;
+    delete[] u;
+}
+
+
+
+template <typename T>
+void thomaspack::thomas_factor_solve(const ThomasFactorT<T>& F, const T b[], T x[]) {
+    //-------------------------------------------------------------------
+    // Rozwiązanie układu Ax = b z wykorzystaniem gotowej faktoryzacji:
+    // eliminacja w przód dla wektora b oraz podstawianie wsteczne.
+    // Wynik pośredni (y) zapisywany jest od razu w x, więc funkcja nie
+    // potrzebuje dodatkowej pamięci; b nie jest modyfikowane
+    // (dozwolone jest b == x).
+
+    //  Argumenty:
+    //  F   - faktoryzacja macierzy A
+    //  b[] - tablica wyrazow wolnych b
+    //  x[] - tablica rozwiazan
+
+    //  Zwraca: Nic -> operuje na wskaźnikach
+    //-------------------------------------------------------------------
+
+    const int N = F.N;
+    const T* m     = F.m;
+    const T* inv_d = F.inv_d;
+    const T* u     = F.u;
+
+    // Eliminacja w przód dla wektora b
+    x[0] = b[0];
+    for (int i = 1; i < N; i++) {
+        x[i] = b[i] - m[i] * x[i - 1];
+    }
+
+    // Podstawianie wsteczne (mnożenie przez odwrotności zamiast dzielenia)
+    x[N - 1] = x[N - 1] * inv_d[N - 1];
+    for (int i = N - 2; i >= 0; i--) {
+        x[i] = (x[i] - u[i] * x[i + 1]) * inv_d[i];
+    }
+}
+
+
+
+template <typename T>
+T thomaspack::thomas_factor_solve(const ThomasFactorT<T>& F, const T b[], T x[],
+        const T x_ref[]) {
+    //-------------------------------------------------------------------
+    // Rozwiązanie układu Ax = b (jak wyżej) połączone z wyznaczeniem
+    // błędu: każde x[i] porównywane jest z x_ref[i] zaraz po obliczeniu
+    // w podstawianiu wstecznym, bez osobnego przejścia po tablicy.
+
+    //  Argumenty:
+    //  F       - faktoryzacja macierzy A
+    //  b[]     - tablica wyrazow wolnych b
+    //  x[]     - tablica rozwiazan
+    //  x_ref[] - wartości odniesienia dla rozwiązania
+
+    //  Zwraca: max |x[i] - x_ref[i]|
+    //-------------------------------------------------------------------
+
+    const int N = F.N;
+    const T* m     = F.m;
+    const T* inv_d = F.inv_d;
+    const T* u     = F.u;
+
+    // Eliminacja w przód dla wektora b
+    x[0] = b[0];
+    for (int i = 1; i < N; i++) {
+        x[i] = b[i] - m[i] * x[i - 1];
+    }
+
+    // Podstawianie wsteczne z wyznaczaniem błędu
+    T max_err = T(0);
+    x[N - 1] = x[N - 1] * inv_d[N - 1];
+    T e = precyzjapack::modul(x[N - 1] - x_ref[N - 1]);
+    precyzjapack::max_bledu(max_err, e);
+    for (int i = N - 2; i >= 0; i--) {
+        x[i] = (x[i] - u[i] * x[i + 1]) * inv_d[i];
+        e = precyzjapack::modul(x[i] - x_ref[i]);
+        precyzjapack::max_bledu(max_err, e);
+    }
+    return max_err;
+}
+
+
+
+template <typename T>
+static void thomas_block_spikes(int s, int t, bool left, bool right, const T l[],
+        const T d[], const T u[], const T b[],
+        T dp[], T y[], T v[], T w[]) {
+    //-------------------------------------------------------------------
+    // Rozwiązanie układu trójdiagonalnego ograniczonego do wierszy s..t-1
+    // z trzema prawymi stronami (algorytm Thomasa):
+    //      y - rozwiązanie dla b,
+    //      v - "kolec" lewy: wpływ niewiadomej x[s-1] (prawa strona l[s] e_s),
+    //      w - "kolec" prawy: wpływ niewiadomej x[t] (prawa strona u[t-1] e_{t-1}),
+    // tak że x[i] = y[i] - v[i]*x[s-1] - w[i]*x[t] dla i = s..t-1.
+    //
+    //  Argumenty:
+    //  s, t        - zakres wierszy bloku [s, t)
+    //  left, right - czy istnieje sąsiad z lewej / prawej strony
+    //  l, d, u, b  - przekątne i wyrazy wolne całego układu
+    //  dp          - zmodyfikowana przekątna (tablica robocza)
+    //  y, v, w     - wyniki (indeksowane globalnie)
+    //-------------------------------------------------------------------
+
+    // Eliminacja w przód
+    dp[s] = d[s];
+    y[s] = b[s];
+    v[s] = left ? l[s] : T(0);
+    for (int i = s + 1; i < t; i++) {
+        T m = l[i] / dp[i - 1];
+        dp[i] = d[i] - m * u[i - 1];
+        y[i] = b[i] - m * y[i - 1];
+        v[i] = -m * v[i - 1];
+    }
+
+    // Podstawianie wsteczne
+    y[t - 1] = y[t - 1] / dp[t - 1];
+    v[t - 1] = v[t - 1] / dp[t - 1];
+    w[t - 1] = right ? u[t - 1] / dp[t - 1] : T(0);
+    for (int i = t - 2; i >= s; i--) {
+        y[i] = (y[i] - u[i] * y[i + 1]) / dp[i];
+        v[i] = (v[i] - u[i] * v[i + 1]) / dp[i];
+        w[i] = (-u[i] * w[i + 1]) / dp[i];
+    }
+}
+
+
+
+template <typename T>
+void thomaspack::Thomas_parallel(int N, const T l[], T d[], const T u[],
+        T b[], T x[], threadpack::ThreadPool* pool) {
+    //-------------------------------------------------------------------
+    // Równoległe rozwiązanie układu Ax = b dla macierzy trójdiagonalnej
+    // l[1..N-1], d[0..N-1], u[0..N-2], b[0..N-1]; wynik w x[0..N-1]
+    // (opis metody w THOMAS.h)
+
+    //  Argumenty:
+    //  N - rozmiar macierzy A
+    //  l[] - tablica wartości dolnej przekątnej macierzy 
+    //  d[] - tablica wartości głównej przekątnej macierzy 
+    //  u[] - tablica wartości górnej przekątnej macierzy 
+    //  b[] - tablica wyrazow wolnych b
+    //  x[] - tablica rozwiazan
+    //  pool - pula wątków (nullptr -> threadpack::global_pool())
+
+    //  Zwraca: Nic -> operuje na wskaźnikach
+    //-------------------------------------------------------------------
+
+    if (pool == nullptr) pool = &threadpack::global_pool();
+
+    //  każdy blok musi mieć co najmniej 2 wiersze (wnętrze + separator)
+    int P = pool->size();
+    if (P > N / 2) P = N / 2;
+
+    if (N < THOMAS_PARALLEL_MIN_N || P < 2) {
+        //  wersja sekwencyjna na kopiach (l, d, u, b pozostają bez zmian)
+        T* dc = new T[N];
+        T* bc = new T[N];
+        for (int i = 0; i < N; i++) { dc[i] = d[i]; bc[i] = b[i]; }
+        thomaspack::Thomas(N, l, dc, u, bc, x);
+        delete[] dc;
+        delete[] bc;
+        return;
+    }
+
+    //  granice bloków: blok p obejmuje wiersze [start[p], start[p+1]),
+    //  separatorem jest ostatni wiersz bloku (poza ostatnim blokiem)
+    int* start = new int[P + 1];
+    for (int p = 0; p <= P; p++) {
+        start[p] = (int)((long)N * p / P);
+    }
+
+    T* dp = new T[N];
+    T* v  = new T[N];
+    T* w  = new T[N];
+
+    //  1) bloki niezależnie: y (zapisywane w x), v, w dla wnętrza bloku
+    pool->parallel_for(0, P, [&](int p_lo, int p_hi) {
+        for (int p = p_lo; p < p_hi; p++) {
+            int s = start[p];
+            int t = (p == P - 1) ? N : start[p + 1] - 1;
+            thomas_block_spikes(s, t, p > 0, p < P - 1, l, d, u, b, dp, x, v, w);
+        }
+    });
+
+    //  2) układ dla separatorów S_p = x[start[p+1]-1], p = 0..P-2:
+    //     l_r x[r-1] + d_r x[r] + u_r x[r+1] = b_r, gdzie x[r-1] oraz x[r+1]
+    //     wyrażone są przez sąsiednie separatory
+    const int M = P - 1;
+    T* rl = new T[M];
+    T* rd = new T[M];
+    T* ru = new T[M];
+    T* rb = new T[M];
+    T* rs = new T[M];
+
+    for (int p = 0; p < M; p++) {
+        int r = start[p + 1] - 1;
+        rl[p] = -l[r] * v[r - 1];
+        rd[p] = d[r] - l[r] * w[r - 1] - u[r] * v[r + 1];
+        ru[p] = -u[r] * w[r + 1];
+        rb[p] = b[r] - l[r] * x[r - 1] - u[r] * x[r + 1];
+    }
+    thomaspack::Thomas(M, rl, rd, ru, rb, rs);
+
+    //  3) odtworzenie rozwiązania w blokach
+    pool->parallel_for(0, P, [&](int p_lo, int p_hi) {
+        for (int p = p_lo; p < p_hi; p++) {
+            int s = start[p];
+            int t = (p == P - 1) ? N : start[p + 1] - 1;
+            T S_left  = (p > 0) ? rs[p - 1] : T(0);
+            T S_right = (p < M) ? rs[p] : T(0);
+
+            for (int i = s; i < t; i++) {
+                x[i] = x[i] - v[i] * S_left - w[i] * S_right;
+            }
+            if (p < M) x[t] = rs[p];
+        }
+    });
+
+    delete[] start;
+    delete[] dp;
+    delete[] v;
+    delete[] w;
+    delete[] rl;
+    delete[] rd;
+    delete[] ru;
+    delete[] rb;
+    delete[] rs;
+}
+
+
+
+template <typename T>
+thomaspack::ThomasParallelFactorT<T>::ThomasParallelFactorT(int N, const T l[], const T d[],
+        const T u[], threadpack::ThreadPool* pool) : N(N), pool(pool) {
+    //-------------------------------------------------------------------
+    // Konstruktor dzieli macierz na bloki (jak Thomas_parallel), wykonuje
+    // eliminację w przód w każdym bloku (jak ThomasFactorT), wyznacza
+    // kolce v, w (niezależne od prawej strony) oraz faktoryzuje układ
+    // separatorów. Tablice l, d, u NIE są modyfikowane.
+
+    //  Argumenty:
+    //  N - rozmiar macierzy A
+    //  l[] - tablica wartości dolnej przekątnej macierzy 
+    //  d[] - tablica wartości głównej przekątnej macierzy 
+    //  u[] - tablica wartości górnej przekątnej macierzy 
+    //  pool - pula wątków (nullptr -> threadpack::global_pool())
+    //-------------------------------------------------------------------
+
+    //  każdy blok musi mieć co najmniej 2 wiersze (wnętrze + separator);
+    //  globalna pula tworzona jest tylko, gdy podział ma sens
+    P = 1;
+    if (N >= THOMAS_PARALLEL_MIN_N) {
+        if (this->pool == nullptr) this->pool = &threadpack::global_pool();
+        P = this->pool->size();
+        if (P > N / 2) P = N / 2;
+        if (P < 2) P = 1;
+    }
+    const int M = P - 1;
+
+    start = new int[P + 1];
+    for (int p = 0; p <= P; p++) {
+        start[p] = (int)((long)N * p / P);
+    }
+
+    m      = new T[N];
+    inv_d  = new T[N];
+    this->u = new T[N];
+    v      = new T[N];
+    w      = new T[N];
+    l_sep  = new T[M > 0 ? M : 1];
+    rm     = new T[M > 0 ? M : 1];
+    rinv_d = new T[M > 0 ? M : 1];
+    ru     = new T[M > 0 ? M : 1];
+
+    for (int i = 0; i < N; i++) this->u[i] = u[i];
+
+    auto faktoryzuj_bloki = [&](int p_lo, int p_hi) {
+        for (int p = p_lo; p < p_hi; p++) {
+            int s = start[p];
+            int t = (p == P - 1) ? N : start[p + 1] - 1;
+            bool left = p > 0, right = p < M;
+
+            // Eliminacja w przód (jak w ThomasFactorT) i kolec lewy
+            T d_prev = d[s];
+            m[s] = T(0);
+            inv_d[s] = T(1) / d_prev;
+            v[s] = left ? l[s] : T(0);
+            for (int i = s + 1; i < t; i++) {
+                m[i] = l[i] * inv_d[i - 1];
+                d_prev = d[i] - m[i] * u[i - 1];
+                inv_d[i] = T(1) / d_prev;
+                v[i] = -m[i] * v[i - 1];
+            }
+
+            // Podstawianie wsteczne kolców
+            v[t - 1] = v[t - 1] * inv_d[t - 1];
+            w[t - 1] = right ? u[t - 1] * inv_d[t - 1] : T(0);
+            for (int i = t - 2; i >= s; i--) {
+                v[i] = (v[i] - u[i] * v[i + 1]) * inv_d[i];
+                w[i] = (-u[i] * w[i + 1]) * inv_d[i];
+            }
+            if (right) { v[t] = T(0); w[t] = T(0); }
+        }
+    };
+    if (P > 1) this->pool->parallel_for(0, P, faktoryzuj_bloki);
+    else faktoryzuj_bloki(0, 1);
+
+    //  układ separatorów (jak w Thomas_parallel) i jego faktoryzacja
+    for (int p = 0; p < M; p++) {
+        int r = start[p + 1] - 1;
+        T rl = -l[r] * v[r - 1];
+        T rd = d[r] - l[r] * w[r - 1] - u[r] * v[r + 1];
+        ru[p] = -u[r] * w[r + 1];
+        l_sep[p] = l[r];
+
+        rm[p] = (p == 0) ? T(0) : rl * rinv_d[p - 1];
+        rinv_d[p] = T(1) / ((p == 0) ? rd : rd - rm[p] * ru[p - 1]);
+    }
+}
+
+
+
+template <typename T>
+thomaspack::ThomasParallelFactorT<T>::~ThomasParallelFactorT() {
+    delete[] start;
+    delete[] m;
+    delete[] inv_d;
+    delete[] u;
+    delete[] v;
+    delete[] w;
+    delete[] l_sep;
+    delete[] rm;
+    delete[] rinv_d;
+    delete[] ru;
+}
+
+
+
+template <typename T>
+static void spike_bloki(const thomaspack::ThomasParallelFactorT<T>& F, const T b[], T x[],
+        int p_lo, int p_hi) {
+    //  Rozwiązania lokalne y bloków p_lo..p_hi-1 (zapisywane w x)
+    for (int p = p_lo; p < p_hi; p++) {
+        int s = F.start[p];
+        int t = (p == F.P - 1) ? F.N : F.start[p + 1] - 1;
+
+        x[s] = b[s];
+        for (int i = s + 1; i < t; i++) {
+            x[i] = b[i] - F.m[i] * x[i - 1];
+        }
+        x[t - 1] = x[t - 1] * F.inv_d[t - 1];
+        for (int i = t - 2; i >= s; i--) {
+            x[i] = (x[i] - F.u[i] * x[i + 1]) * F.inv_d[i];
+        }
+    }
+}
+
+
+
+template <typename T>
+static void spike_separatory(const thomaspack::ThomasParallelFactorT<T>& F, const T b[], T x[]) {
+    //  Wyrazy wolne układu separatorów i jego rozwiązanie (w miejscu,
+    //  w pozycjach x[r] separatorów); b[r] odczytywane przed zapisem x[r]
+    const int M = F.P - 1;
+    int r_prev = 0;
+    for (int p = 0; p < M; p++) {
+        int r = F.start[p + 1] - 1;
+        T rb = b[r] - F.l_sep[p] * x[r - 1] - F.u[r] * x[r + 1];
+        x[r] = (p == 0) ? rb : rb - F.rm[p] * x[r_prev];
+        r_prev = r;
+    }
+    int r_next = F.start[M] - 1;
+    x[r_next] = x[r_next] * F.rinv_d[M - 1];
+    for (int p = M - 2; p >= 0; p--) {
+        int r = F.start[p + 1] - 1;
+        x[r] = (x[r] - F.ru[p] * x[r_next]) * F.rinv_d[p];
+        r_next = r;
+    }
+}
+
+
+
+template <typename T>
+void thomaspack::thomas_factor_solve(const ThomasParallelFactorT<T>& F, const T b[], T x[]) {
+    //-------------------------------------------------------------------
+    // Rozwiązanie układu Ax = b z gotową faktoryzacją równoległą
+    // (opis w THOMAS.h); b i x mogą wskazywać tę samą tablicę.
+
+    //  Argumenty:
+    //  F   - faktoryzacja macierzy A
+    //  b[] - tablica wyrazow wolnych b
+    //  x[] - tablica rozwiazan
+
+    //  Zwraca: Nic -> operuje na wskaźnikach
+    //-------------------------------------------------------------------
+
+    if (F.P == 1) {
+        spike_bloki(F, b, x, 0, 1);
+        return;
+    }
+
+    //  1) rozwiązania lokalne bloków, 2) separatory
+    F.pool->parallel_for(0, F.P, [&](int p_lo, int p_hi) { spike_bloki(F, b, x, p_lo, p_hi); });
+    spike_separatory(F, b, x);
+
+    //  3) odtworzenie rozwiązania w blokach
+    const int M = F.P - 1;
+    F.pool->parallel_for(0, F.P, [&](int p_lo, int p_hi) {
+        for (int p = p_lo; p < p_hi; p++) {
+            int s = F.start[p];
+            int t = (p == F.P - 1) ? F.N : F.start[p + 1] - 1;
+            T S_left  = (p > 0) ? x[s - 1] : T(0);
+            T S_right = (p < M) ? x[t] : T(0);
+
+            for (int i = s; i < t; i++) {
+                x[i] = x[i] - F.v[i] * S_left - F.w[i] * S_right;
+            }
+        }
+    });
+}
+
+
+
+template <typename T>
+T thomaspack::thomas_factor_solve(const ThomasParallelFactorT<T>& F, const T b[], T x[],
+        const T x_ref[]) {
+    //-------------------------------------------------------------------
+    // Jak wyżej, z wyznaczaniem błędu w ostatnim przejściu po blokach
+    // (maksima bloków łączone na końcu; NaN w którymkolwiek węźle daje NaN)
+
+    //  Zwraca: max |x[i] - x_ref[i]|
+    //-------------------------------------------------------------------
+
+    const int M = F.P - 1;
+    std::mutex mtx;
+    T max_err = T(0);
+
+    if (F.P > 1) {
+        F.pool->parallel_for(0, F.P, [&](int p_lo, int p_hi) { spike_bloki(F, b, x, p_lo, p_hi); });
+        spike_separatory(F, b, x);
+    }
+
+    auto odtworz = [&](int p_lo, int p_hi) {
+        T err = T(0);
+        for (int p = p_lo; p < p_hi; p++) {
+            int s = F.start[p];
+            int t = (p == F.P - 1) ? F.N : F.start[p + 1] - 1;
+
+            if (F.P == 1) {
+                //  jeden blok: podstawianie wsteczne z wyznaczaniem błędu
+                x[s] = b[s];
+                for (int i = s + 1; i < t; i++) {
+                    x[i] = b[i] - F.m[i] * x[i - 1];
+                }
+                x[t - 1] = x[t - 1] * F.inv_d[t - 1];
+                T e = precyzjapack::modul(x[t - 1] - x_ref[t - 1]);
+                precyzjapack::max_bledu(err, e);
+                for (int i = t - 2; i >= s; i--) {
+                    x[i] = (x[i] - F.u[i] * x[i + 1]) * F.inv_d[i];
+                    e = precyzjapack::modul(x[i] - x_ref[i]);
+                    precyzjapack::max_bledu(err, e);
+                }
+                continue;
+            }
+
+            T S_left  = (p > 0) ? x[s - 1] : T(0);
+            T S_right = (p < M) ? x[t] : T(0);
+            for (int i = s; i < t; i++) {
+                x[i] = x[i] - F.v[i] * S_left - F.w[i] * S_right;
+                T e = precyzjapack::modul(x[i] - x_ref[i]);
+                precyzjapack::max_bledu(err, e);
+            }
+            if (p < M) {
+                T e = precyzjapack::modul(x[t] - x_ref[t]);
+                precyzjapack::max_bledu(err, e);
+            }
+        }
+        std::lock_guard<std::mutex> lock(mtx);
+        precyzjapack::max_bledu(max_err, err);
+    };
+    if (F.P > 1) F.pool->parallel_for(0, F.P, odtworz);
+    else odtworz(0, 1);
+
+    return max_err;
+}
+
+
+
+//----------------------------------------------------------------------
+// Wersje wsadowe. Układy przetwarzane są grupami po BATCH_LANES:
+// pętle po układach w grupie mają stałą długość, dzięki czemu kompilator
+// zamienia je na operacje wektorowe. Ostatnie B % BATCH_LANES układów
+// także liczone są pełną grupą (zachodzącą na poprzednią albo, dla
+// B < BATCH_LANES, uzupełnioną układami jednostkowymi) - koszt grupy to
+// koszt rekurencji jednego układu. Dla double generowane są dodatkowo
+// wersje AVX2 i AVX-512, wybierane przy starcie programu (target_clones);
+// funkcje pomocnicze muszą być wtedy wstawione w każdą z wersji.
+//----------------------------------------------------------------------
+static const int BATCH_LANES = 8;
+
+#if defined(__GNUC__) && !defined(__clang__) && (defined(__x86_64__) || defined(__i386__))
+    #define THOMAS_BATCH_CLONES __attribute__((target_clones("avx512f", "avx2", "default")))
+    #define THOMAS_BATCH_INLINE inline __attribute__((always_inline))
+#else
+    #define THOMAS_BATCH_CLONES
+    #define THOMAS_BATCH_INLINE inline
+#endif
+
+
+
+template <typename T, int W>
+static THOMAS_BATCH_INLINE void thomas_batch_group(int N, int B, const T* l, T* d, const T* u, T* b, T* x) {
+    //-------------------------------------------------------------------
+    // Algorytm Thomasa dla W kolejnych układów (wskaźniki ustawione na
+    // pierwszy z nich, kolejne wiersze co B elementów)
+    //-------------------------------------------------------------------
+
+    // Eliminacja w przód
+    for (int i = 1; i < N; i++) {
+        const T* __restrict li = l + (long)i * B;
+        const T* __restrict up = u + (long)(i - 1) * B;
+        const T* __restrict dp = d + (long)(i - 1) * B;
+        const T* __restrict bp = b + (long)(i - 1) * B;
+        T* __restrict di = d + (long)i * B;
+        T* __restrict bi = b + (long)i * B;
+        for (int s = 0; s < W; s++) {
+            T m = li[s] / dp[s];
+            di[s] = di[s] - m * up[s];
+            bi[s] = bi[s] - m * bp[s];
+        }
+    }
+
+    // Podstawianie wsteczne
+    {
+        const T* __restrict dl = d + (long)(N - 1) * B;
+        const T* __restrict bl = b + (long)(N - 1) * B;
+        T* __restrict xl = x + (long)(N - 1) * B;
+        for (int s = 0; s < W; s++) {
+            xl[s] = bl[s] / dl[s];
+        }
+    }
+    for (int i = N - 2; i >= 0; i--) {
+        const T* __restrict ui = u + (long)i * B;
+        const T* __restrict di = d + (long)i * B;
+        const T* __restrict bi = b + (long)i * B;
+        const T* __restrict xn = x + (long)(i + 1) * B;
+        T* __restrict xi = x + (long)i * B;
+        for (int s = 0; s < W; s++) {
+            xi[s] = (bi[s] - ui[s] * xn[s]) / di[s];
+        }
+    }
+}
+
+
+
+template <typename T, int W>
+static THOMAS_BATCH_INLINE void thomas_batch_group_reszta(int N, int B, const T* l, T* d, const T* u, T* b, T* x,
+        int s_min) {
+    //-------------------------------------------------------------------
+    // Jak thomas_batch_group, ale zapisywane są tylko układy s >= s_min;
+    // układy s < s_min (rozwiązane już przez poprzednią grupę) są liczone
+    // na ich gotowych danych, a wyniki odrzucane. Pozwala to objąć pełną
+    // grupą ostatnie B % W układów, zachodząc na poprzednią grupę.
+    //-------------------------------------------------------------------
+
+    // Eliminacja w przód
+    for (int i = 1; i < N; i++) {
+        const T* __restrict li = l + (long)i * B;
+        const T* __restrict up = u + (long)(i - 1) * B;
+        const T* __restrict dp = d + (long)(i - 1) * B;
+        const T* __restrict bp = b + (long)(i - 1) * B;
+        T* __restrict di = d + (long)i * B;
+        T* __restrict bi = b + (long)i * B;
+        for (int s = 0; s < W; s++) {
+            T m = li[s] / dp[s];
+            T dn = di[s] - m * up[s];
+            T bn = bi[s] - m * bp[s];
+            if (s >= s_min) {
+                di[s] = dn;
+                bi[s] = bn;
+            }
+        }
+    }
+
+    // Podstawianie wsteczne
+    {
+        const T* __restrict dl = d + (long)(N - 1) * B;
+        const T* __restrict bl = b + (long)(N - 1) * B;
+        T* __restrict xl = x + (long)(N - 1) * B;
+        for (int s = s_min; s < W; s++) {
+            xl[s] = bl[s] / dl[s];
+        }
+    }
+    for (int i = N - 2; i >= 0; i--) {
+        const T* __restrict ui = u + (long)i * B;
+        const T* __restrict di = d + (long)i * B;
+        const T* __restrict bi = b + (long)i * B;
+        const T* __restrict xn = x + (long)(i + 1) * B;
+        T* __restrict xi = x + (long)i * B;
+        for (int s = s_min; s < W; s++) {
+            xi[s] = (bi[s] - ui[s] * xn[s]) / di[s];
+        }
+    }
+}
+
+
+
+template <typename T, int W>
+static THOMAS_BATCH_INLINE void thomas_batch_shared_group(int N, int B, const T* m, const T* inv_d,
+        const T* u, const T* b, T* x) {
+    //-------------------------------------------------------------------
+    // W prawych stron dla wspólnej, sfaktoryzowanej macierzy
+    // (mnożniki m[i] oraz odwrotności przekątnej inv_d[i])
+    //-------------------------------------------------------------------
+
+    // Eliminacja w przód (wynik pośredni od razu w x)
+    for (int s = 0; s < W; s++) {
+        x[s] = b[s];
+    }
+    for (int i = 1; i < N; i++) {
+        const T* __restrict bi = b + (long)i * B;
+        const T* __restrict xp = x + (long)(i - 1) * B;
+        T* __restrict xi = x + (long)i * B;
+        const T mi = m[i];
+        for (int s = 0; s < W; s++) {
+            xi[s] = bi[s] - mi * xp[s];
+        }
+    }
+
+    // Podstawianie wsteczne
+    {
+        T* __restrict xl = x + (long)(N - 1) * B;
+        const T dl = inv_d[N - 1];
+        for (int s = 0; s < W; s++) {
+            xl[s] = xl[s] * dl;
+        }
+    }
+    for (int i = N - 2; i >= 0; i--) {
+        const T* __restrict xn = x + (long)(i + 1) * B;
+        T* __restrict xi = x + (long)i * B;
+        const T ui = u[i];
+        const T di = inv_d[i];
+        for (int s = 0; s < W; s++) {
+            xi[s] = (xi[s] - ui * xn[s]) * di;
+        }
+    }
+}
+
+
+
+#if defined(__GNUC__)
+//----------------------------------------------------------------------
+// Grupa 8 układów double na jawnych wektorach (rozszerzenia GCC) -
+// pętle po układach nie zależą wtedy od poziomu optymalizacji.
+// Kolejność działań jak w wersji ogólnej, więc wyniki są identyczne.
+//----------------------------------------------------------------------
+typedef double batch_v8d __attribute__((vector_size(8 * sizeof(double)), aligned(sizeof(double)), may_alias));
+typedef long long batch_v8l __attribute__((vector_size(8 * sizeof(long long))));
+
+#define BATCH_V(p) (*(batch_v8d*)(p))
+
+template <>
+THOMAS_BATCH_INLINE void thomas_batch_group<double, 8>(int N, int B, const double* l, double* d,
+        const double* u, double* b, double* x) {
+    // Eliminacja w przód
+    batch_v8d dp = BATCH_V(d);
+    batch_v8d bp = BATCH_V(b);
+    for (int i = 1; i < N; i++) {
+        const long k = (long)i * B;
+        batch_v8d m = BATCH_V(l + k) / dp;
+        dp = BATCH_V(d + k) - m * BATCH_V(u + k - B);
+        bp = BATCH_V(b + k) - m * bp;
+        BATCH_V(d + k) = dp;
+        BATCH_V(b + k) = bp;
+    }
+
+    // Podstawianie wsteczne
+    batch_v8d xn = bp / dp;
+    BATCH_V(x + (long)(N - 1) * B) = xn;
+    for (int i = N - 2; i >= 0; i--) {
+        const long k = (long)i * B;
+        xn = (BATCH_V(b + k) - BATCH_V(u + k) * xn) / BATCH_V(d + k);
+        BATCH_V(x + k) = xn;
+    }
+}
+
+template <>
+THOMAS_BATCH_INLINE void thomas_batch_group_reszta<double, 8>(int N, int B, const double* l, double* d,
+        const double* u, double* b, double* x, int s_min) {
+    //  układy s < s_min: w rejestrach i w pamięci pozostają ich gotowe wartości
+    batch_v8l zapis;
+    for (int s = 0; s < 8; s++) zapis[s] = (s >= s_min) ? -1 : 0;
+
+    // Eliminacja w przód
+    batch_v8d dp = BATCH_V(d);
+    batch_v8d bp = BATCH_V(b);
+    for (int i = 1; i < N; i++) {
+        const long k = (long)i * B;
+        batch_v8d m = BATCH_V(l + k) / dp;
+        batch_v8d di = BATCH_V(d + k);
+        batch_v8d bi = BATCH_V(b + k);
+        dp = zapis ? di - m * BATCH_V(u + k - B) : di;
+        bp = zapis ? bi - m * bp : bi;
+        BATCH_V(d + k) = dp;
+        BATCH_V(b + k) = bp;
+    }
+
+    // Podstawianie wsteczne
+    const long kl = (long)(N - 1) * B;
+    batch_v8d xn = zapis ? bp / dp : BATCH_V(x + kl);
+    BATCH_V(x + kl) = xn;
+    for (int i = N - 2; i >= 0; i--) {
+        const long k = (long)i * B;
+        xn = zapis ? (BATCH_V(b + k) - BATCH_V(u + k) * xn) / BATCH_V(d + k) : BATCH_V(x + k);
+        BATCH_V(x + k) = xn;
+    }
+}
+
+template <>
+THOMAS_BATCH_INLINE void thomas_batch_shared_group<double, 8>(int N, int B, const double* m, const double* inv_d,
+        const double* u, const double* b, double* x) {
+    // Eliminacja w przód (wynik pośredni od razu w x)
+    batch_v8d y = BATCH_V(b);
+    BATCH_V(x) = y;
+    for (int i = 1; i < N; i++) {
+        const long k = (long)i * B;
+        y = BATCH_V(b + k) - m[i] * y;
+        BATCH_V(x + k) = y;
+    }
+
+    // Podstawianie wsteczne
+    y = y * inv_d[N - 1];
+    BATCH_V(x + (long)(N - 1) * B) = y;
+    for (int i = N - 2; i >= 0; i--) {
+        const long k = (long)i * B;
+        y = (BATCH_V(x + k) - u[i] * y) * inv_d[i];
+        BATCH_V(x + k) = y;
+    }
+}
+
+#undef BATCH_V
+#endif
+
+
+
+template <typename T>
+static THOMAS_BATCH_INLINE void thomas_batch_impl(int N, int B, const T l[], T d[], const T u[], T b[], T x[]) {
+    int s0 = 0;
+    for (; s0 + BATCH_LANES <= B; s0 += BATCH_LANES) {
+        thomas_batch_group<T, BATCH_LANES>(N, B, l + s0, d + s0, u + s0, b + s0, x + s0);
+    }
+    if (s0 == B) return;
+
+    if (B >= BATCH_LANES) {
+        //  pozostałe układy: ostatnia pełna grupa zachodzi na poprzednią,
+        //  zapisywane są tylko układy s >= s0
+        const int sg = B - BATCH_LANES;
+        thomas_batch_group_reszta<T, BATCH_LANES>(N, B, l + sg, d + sg, u + sg, b + sg, x + sg, s0 - sg);
+        return;
+    }
+
+    //  mniej niż BATCH_LANES układów: kopia do pełnej grupy uzupełnionej
+    //  układami jednostkowymi (l = u = 0, d = 1, b = 0). Rekurencja grupy
+    //  trwa tyle co rekurencja pojedynczego układu, więc grupa jest szybsza
+    //  niż B układów po kolei; d i b wracają do tablic wywołującego.
+    const int W = BATCH_LANES;
+    const long NW = (long)N * W;
+    T* buf = new T[5 * NW];
+    T* lw = buf;
+    T* dw = buf + NW;
+    T* uw = buf + 2 * NW;
+    T* bw = buf + 3 * NW;
+    T* xw = buf + 4 * NW;
+    for (int i = 0; i < N; i++) {
+        const long k = (long)i * B;
+        const long kw = (long)i * W;
+        for (int s = 0; s < W; s++) {
+            lw[kw + s] = (s < B) ? l[k + s] : T(0);
+            dw[kw + s] = (s < B) ? d[k + s] : T(1);
+            uw[kw + s] = (s < B) ? u[k + s] : T(0);
+            bw[kw + s] = (s < B) ? b[k + s] : T(0);
+        }
+    }
+    thomas_batch_group<T, BATCH_LANES>(N, W, lw, dw, uw, bw, xw);
+    for (int i = 0; i < N; i++) {
+        const long k = (long)i * B;
+        const long kw = (long)i * W;
+        for (int s = 0; s < B; s++) {
+            d[k + s] = dw[kw + s];
+            b[k + s] = bw[kw + s];
+            x[k + s] = xw[kw + s];
+        }
+    }
+    delete[] buf;
+}
+
+
+
+template <typename T>
+static THOMAS_BATCH_INLINE void thomas_batch_shared_impl(int N, int B, const T l[], const T d[], const T u[],
+        const T b[], T x[]) {
+    //  faktoryzacja wspólnej macierzy - raz dla wszystkich prawych stron
+    T* m = new T[N];
+    T* inv_d = new T[N];
+    m[0] = T(0);
+    inv_d[0] = T(1) / d[0];
+    for (int i = 1; i < N; i++) {
+        m[i] = l[i] * inv_d[i - 1];
+        inv_d[i] = T(1) / (d[i] - m[i] * u[i - 1]);
+    }
+
+    int s0 = 0;
+    for (; s0 + BATCH_LANES <= B; s0 += BATCH_LANES) {
+        thomas_batch_shared_group<T, BATCH_LANES>(N, B, m, inv_d, u, b + s0, x + s0);
+    }
+    if (s0 < B && B >= BATCH_LANES) {
+        //  pozostałe układy: ostatnia pełna grupa zachodzi na poprzednią
+        //  (b nie jest modyfikowane, więc wspólne układy liczone są ponownie
+        //  z tym samym wynikiem)
+        thomas_batch_shared_group<T, BATCH_LANES>(N, B, m, inv_d, u, b + B - BATCH_LANES, x + B - BATCH_LANES);
+    } else if (s0 < B) {
+        //  mniej niż BATCH_LANES prawych stron: grupa uzupełniona zerami
+        const int W = BATCH_LANES;
+        const long NW = (long)N * W;
+        T* bw = new T[2 * NW];
+        T* xw = bw + NW;
+        for (int i = 0; i < N; i++) {
+            for (int s = 0; s < W; s++) {
+                bw[(long)i * W + s] = (s < B) ? b[(long)i * B + s] : T(0);
+            }
+        }
+        thomas_batch_shared_group<T, BATCH_LANES>(N, W, m, inv_d, u, bw, xw);
+        for (int i = 0; i < N; i++) {
+            for (int s = 0; s < B; s++) {
+                x[(long)i * B + s] = xw[(long)i * W + s];
+            }
+        }
+        delete[] bw;
+    }
+
+    delete[] m;
+    delete[] inv_d;
+}
+
+
+
+void thomaspack::Thomas_batch(int N, int B, const long double l[], long double d[],
+        const long double u[], long double b[], long double x[]) {
+    //-------------------------------------------------------------------
+    //  Argumenty:
+    //  N - rozmiar każdego z układów
+    //  B - liczba układów
+    //  l[], d[], u[], b[] - przekątne i wyrazy wolne (N*B, przeplatane)
+    //  x[] - tablica rozwiązań (N*B, przeplatana)
+
+    //  Zwraca: Nic -> operuje na wskaźnikach
+    //-------------------------------------------------------------------
+    thomas_batch_impl(N, B, l, d, u, b, x);
+}
+
+
+
+THOMAS_BATCH_CLONES
+void thomaspack::Thomas_batch(int N, int B, const double l[], double d[],
+        const double u[], double b[], double x[]) {
+    thomas_batch_impl(N, B, l, d, u, b, x);
+}
+
+
+
+void thomaspack::Thomas_batch_shared(int N, int B, const long double l[], const long double d[],
+        const long double u[], const long double b[], long double x[]) {
+    //-------------------------------------------------------------------
+    //  Argumenty:
+    //  N - rozmiar macierzy
+    //  B - liczba prawych stron
+    //  l[], d[], u[] - przekątne wspólnej macierzy (długość N)
+    //  b[] - wyrazy wolne (N*B, przeplatane)
+    //  x[] - tablica rozwiązań (N*B, przeplatana)
+
+    //  Zwraca: Nic -> operuje na wskaźnikach
+    //-------------------------------------------------------------------
+    thomas_batch_shared_impl(N, B, l, d, u, b, x);
+}
+
+
+
+THOMAS_BATCH_CLONES
+void thomaspack::Thomas_batch_shared(int N, int B, const double l[], const double d[],
+        const double u[], const double b[], double x[]) {
+    thomas_batch_shared_impl(N, B, l, d, u, b, x);
+}
+
+
+
+//  Jawne instancje dla wszystkich typów skalarnych (PRECYZJA.h)
+#define THOMAS_INSTANCJE(T) \
+    template void thomaspack::thomas_procedure_1<T>(int, const T[], T[], const T[]); \
+    template void thomaspack::thomas_procedure_2<T>(int, const T[], const T[], const T[], T[], T[]); \
+    template void thomaspack::Thomas<T>(int, const T[], T[], const T[], T[], T[]); \
+    template struct thomaspack::ThomasFactorT<T>; \
+    template void thomaspack::thomas_factor_solve<T>(const ThomasFactorT<T>&, const T[], T[]); \
+    template T thomaspack::thomas_factor_solve<T>(const ThomasFactorT<T>&, const T[], T[], const T[]); \
+    template void thomaspack::Thomas_parallel<T>(int, const T[], T[], const T[], T[], T[], threadpack::ThreadPool*); \
+    template struct thomaspack::ThomasParallelFactorT<T>; \
+    template void thomaspack::thomas_factor_solve<T>(const ThomasParallelFactorT<T>&, const T[], T[]); \
+    template T thomaspack::thomas_factor_solve<T>(const ThomasParallelFactorT<T>&, const T[], T[], const T[]);
+
+PRECYZJA_DLA_TYPOW(THOMAS_INSTANCJE)
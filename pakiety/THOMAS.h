@@ -1,16 +1,142 @@
 #ifndef __thomas_h
 #define __thomas_h
 
+namespace threadpack{ class ThreadPool; }
+
+//----------------------------------------------------------------------
+// Algorytm Thomasa i jego faktoryzacja są szablonami typu skalarnego T
+// (jawne instancje dla typów z PRECYZJA.h), podobnie wersje równoległe;
+// wersje wsadowe istnieją dla typów wymienionych przy nich.
+//----------------------------------------------------------------------
 namespace thomaspack{
 
-    void thomas_procedure_1(int N, const long double l[], long double d[], const long double u[]);
+    template <typename T>
+    void thomas_procedure_1(int N, const T l[], T d[], const T u[]);
     
-    void thomas_procedure_2(int N, const long double l[], const long double u[], 
-        const long double d[], long double b[], long double x[]);
+    template <typename T>
+    void thomas_procedure_2(int N, const T l[], const T u[], 
+        const T d[], T b[], T x[]);
     
-    void Thomas(int N, const long double l[], long double d[], 
+    template <typename T>
+    void Thomas(int N, const T l[], T d[], 
+        const T u[], T b[], T x[]);
+
+
+    //------------------------------------------------------------------
+    // Równoległa wersja algorytmu Thomasa (metoda podziału / SPIKE):
+    // macierz dzielona jest na bloki, po jednym na wątek; ostatni wiersz
+    // każdego bloku (poza ostatnim) jest "separatorem". Każdy blok
+    // niezależnie wyraża swoje niewiadome przez dwa sąsiednie separatory,
+    // separatory spełniają mały układ trójdiagonalny (rozwiązywany
+    // sekwencyjnie), a na koniec bloki równolegle odtwarzają rozwiązanie.
+    // Dla N < THOMAS_PARALLEL_MIN_N (lub jednego wątku) wywoływany jest
+    // zwykły algorytm Thomas. Tablice l, d, u, b nie są modyfikowane.
+    //------------------------------------------------------------------
+    const int THOMAS_PARALLEL_MIN_N = 32768;
+
+    template <typename T>
+    void Thomas_parallel(int N, const T l[], T d[],
+        const T u[], T b[], T x[], threadpack::ThreadPool* pool = nullptr);
+
+
+    //------------------------------------------------------------------
+    // Wsadowe rozwiązywanie B niezależnych układów trójdiagonalnych
+    // rozmiaru N. Dane układów są przeplatane (indeks układu zmienia się
+    // najszybciej): element i układu s znajduje się pod indeksem [i*B + s].
+    // Rekurencje różnych układów są niezależne, więc pętle po układach
+    // wykonywane są na rejestrach wektorowych (w wersji double) lub
+    // przynajmniej przeplatane (long double).
+    //
+    // Thomas_batch        - każdy układ ma własną macierz (l, d, u, b przeplatane);
+    //                       jak w Thomas: d[] i b[] są modyfikowane w miejscu
+    // Thomas_batch_shared - wspólna macierz (l, d, u o długości N), B prawych
+    //                       stron b (przeplatane); l, d, u, b nie są modyfikowane
+    //------------------------------------------------------------------
+    void Thomas_batch(int N, int B, const long double l[], long double d[],
         const long double u[], long double b[], long double x[]);
+    void Thomas_batch(int N, int B, const double l[], double d[],
+        const double u[], double b[], double x[]);
+
+    void Thomas_batch_shared(int N, int B, const long double l[], const long double d[],
+        const long double u[], const long double b[], long double x[]);
+    void Thomas_batch_shared(int N, int B, const double l[], const double d[],
+        const double u[], const double b[], double x[]);
+
+
+    //------------------------------------------------------------------
+    // Faktoryzacja macierzy trójdiagonalnej wykonywana jednokrotnie.
+    // Przechowuje mnożniki eliminacji m[i] = l[i] / d[i-1], odwrotności
+    // zmodyfikowanej przekątnej inv_d[i] = 1 / d[i] oraz kopię u[].
+    // Rozwiązanie kolejnych układów (thomas_factor_solve) nie wymaga
+    // już żadnych dzieleń ani alokacji pamięci.
+    //------------------------------------------------------------------
+    template <typename T>
+    struct ThomasFactorT {
+        int N;
+        T* m;       // mnożniki eliminacji (m[0] nieużywane)
+        T* inv_d;   // odwrotności zmodyfikowanej przekątnej
+        T* u;       // górna przekątna
+
+        ThomasFactorT(int N, const T l[], const T d[], const T u[]);
+        ~ThomasFactorT();
+
+        ThomasFactorT(const ThomasFactorT&) = delete;
+        ThomasFactorT& operator=(const ThomasFactorT&) = delete;
+    };
+
+    //  Faktoryzacja w precyzji referencyjnej
+    using ThomasFactor = ThomasFactorT<long double>;
+
+    template <typename T>
+    void thomas_factor_solve(const ThomasFactorT<T>& F, const T b[], T x[]);
+
+    //  Jak wyżej, dodatkowo w trakcie podstawiania wstecznego wyznacza
+    //  max |x[i] - x_ref[i]| (x_ref - np. rozwiązanie analityczne)
+    template <typename T>
+    T thomas_factor_solve(const ThomasFactorT<T>& F, const T b[], T x[],
+        const T x_ref[]);
+
+
+    //------------------------------------------------------------------
+    // Faktoryzacja dla równoległej wersji (SPIKE, jak Thomas_parallel)
+    // wykonywana jednokrotnie: lokalne faktoryzacje bloków, "kolce" v, w
+    // oraz faktoryzacja układu separatorów. Rozwiązanie kolejnych układów
+    // to dwa równoległe przejścia po blokach i krótkie sekwencyjne
+    // przejście po separatorach - bez dzieleń i bez alokacji pamięci.
+    // Dla N < THOMAS_PARALLEL_MIN_N albo puli z jednym wątkiem tworzony
+    // jest jeden blok, a wynik jest bitowo identyczny z ThomasFactorT.
+    //------------------------------------------------------------------
+    template <typename T>
+    struct ThomasParallelFactorT {
+        int N;
+        int P;          // liczba bloków
+        int* start;     // blok p: wiersze [start[p], start[p+1]), separator start[p+1]-1
+        T* m;           // mnożniki eliminacji bloków (m[start[p]] nieużywane)
+        T* inv_d;       // odwrotności zmodyfikowanej przekątnej bloków
+        T* u;           // górna przekątna
+        T* v;           // kolce lewe bloków
+        T* w;           // kolce prawe bloków
+        T* l_sep;       // l[r] w wierszach separatorów
+        T* rm;          // faktoryzacja układu separatorów (P-1 wierszy)
+        T* rinv_d;
+        T* ru;
+        threadpack::ThreadPool* pool;
+
+        ThomasParallelFactorT(int N, const T l[], const T d[], const T u[],
+            threadpack::ThreadPool* pool = nullptr);    // nullptr -> threadpack::global_pool()
+        ~ThomasParallelFactorT();
+
+        ThomasParallelFactorT(const ThomasParallelFactorT&) = delete;
+        ThomasParallelFactorT& operator=(const ThomasParallelFactorT&) = delete;
+    };
+
+    //  b i x mogą wskazywać tę samą tablicę
+    template <typename T>
+    void thomas_factor_solve(const ThomasParallelFactorT<T>& F, const T b[], T x[]);
+    template <typename T>
+    T thomas_factor_solve(const ThomasParallelFactorT<T>& F, const T b[], T x[],
+        const T x_ref[]);
 
 }
 
-#endif
\ No newline at end of file
+#endif
@@ -0,0 +1,286 @@
+#include "THREADS.h"
+
+
+
+threadpack::ThreadPool::ThreadPool(int n_threads) : n_threads(n_threads < 1 ? 1 : n_threads) {
+    //-------------------------------------------------------------------
+    //  Tworzy n_threads-1 wątków roboczych; wątek wywołujący
+    //  parallel_for jest traktowany jako wątek o numerze 0.
+    //-------------------------------------------------------------------
+    for (int id = 1; id < this->n_threads; id++) {
+        workers.emplace_back(&ThreadPool::worker_loop, this, id);
+    }
+}
+
+
+
+threadpack::ThreadPool::~ThreadPool() {
+    {
+        std::lock_guard<std::mutex> lock(mtx);
+        stop = true;
+    }
+    cv_start.notify_all();
+    for (std::thread& t : workers) {
+        t.join();
+    }
+}
+
+
+
+static void chunk_range(int begin, int end, int parts, int id, int& lo, int& hi) {
+    //  Podział zakresu [begin, end) na parts możliwie równych, ciągłych fragmentów
+    int n = end - begin;
+    int base = n / parts;
+    int rest = n % parts;
+    lo = begin + id * base + (id < rest ? id : rest);
+    hi = lo + base + (id < rest ? 1 : 0);
+}
+
+
+
+void threadpack::ThreadPool::worker_loop(int id) {
+    unsigned long seen = 0;
+
+    for (;;) {
+        const std::function<void(int, int)>* body;
+        int begin, end;
+        {
+            std::unique_lock<std::mutex> lock(mtx);
+            cv_start.wait(lock, [&] { return stop || generation != seen; });
+            if (stop) return;
+            seen = generation;
+            body = task;
+            begin = task_begin;
+            end = task_end;
+        }
+
+        int lo, hi;
+        chunk_range(begin, end, n_threads, id, lo, hi);
+        if (lo < hi) (*body)(lo, hi);
+
+        {
+            std::lock_guard<std::mutex> lock(mtx);
+            if (--pending == 0) cv_done.notify_one();
+        }
+    }
+}
+
+
+
+void threadpack::ThreadPool::parallel_for(int begin, int end, const std::function<void(int, int)>& body) {
+    //-------------------------------------------------------------------
+    //  Argumenty:
+    //      begin, end  - zakres indeksów do podziału
+    //      body        - funkcja wywoływana dla fragmentu [lo, hi)
+    //-------------------------------------------------------------------
+    if (end <= begin) return;
+
+    if (n_threads == 1 || end - begin == 1) {
+        body(begin, end);
+        return;
+    }
+
+    std::unique_lock<std::mutex> zajeta(busy, std::try_to_lock);
+    if (!zajeta.owns_lock()) {
+        body(begin, end);
+        return;
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(mtx);
+        task = &body;
+        task_begin = begin;
+        task_end = end;
+        pending = n_threads - 1;
+        generation++;
+    }
+    cv_start.notify_all();
+
+    int lo, hi;
+    chunk_range(begin, end, n_threads, 0, lo, hi);
+    if (lo < hi) body(lo, hi);
+
+    std::unique_lock<std::mutex> lock(mtx);
+    cv_done.wait(lock, [&] { return pending == 0; });
+}
+
+
+
+threadpack::WorkStealingPool::WorkStealingPool(int n_threads)
+    : n_threads(n_threads < 1 ? 1 : n_threads), kolejki(this->n_threads) {
+    for (int id = 1; id < this->n_threads; id++) {
+        workers.emplace_back(&WorkStealingPool::worker_loop, this, id);
+    }
+}
+
+
+
+threadpack::WorkStealingPool::~WorkStealingPool() {
+    {
+        std::lock_guard<std::mutex> lock(mtx);
+        stop = true;
+    }
+    cv_start.notify_all();
+    for (std::thread& t : workers) {
+        t.join();
+    }
+}
+
+
+
+bool threadpack::WorkStealingPool::pobierz(int id, int& zadanie) {
+    //-------------------------------------------------------------------
+    //  Zadanie z początku własnej kolejki, a gdy jej brak - z początku
+    //  kolejki kolejnego wątku (id+1, id+2, ...). Zadania nie przybywają
+    //  w trakcie run(), więc puste wszystkie kolejki oznaczają koniec.
+    //-------------------------------------------------------------------
+    for (int j = 0; j < n_threads; j++) {
+        Kolejka& q = kolejki[(id + j) % n_threads];
+        std::lock_guard<std::mutex> lock(q.mtx);
+        if (!q.zadania.empty()) {
+            zadanie = q.zadania.front();
+            q.zadania.pop_front();
+            return true;
+        }
+    }
+    return false;
+}
+
+
+
+void threadpack::WorkStealingPool::wykonuj(int id) {
+    int zadanie;
+    while (pobierz(id, zadanie)) {
+        (*task)(zadanie, id);
+    }
+}
+
+
+
+void threadpack::WorkStealingPool::worker_loop(int id) {
+    unsigned long seen = 0;
+
+    for (;;) {
+        {
+            std::unique_lock<std::mutex> lock(mtx);
+            cv_start.wait(lock, [&] { return stop || generation != seen; });
+            if (stop) return;
+            seen = generation;
+        }
+
+        wykonuj(id);
+
+        {
+            std::lock_guard<std::mutex> lock(mtx);
+            if (--pending == 0) cv_done.notify_one();
+        }
+    }
+}
+
+
+
+void threadpack::WorkStealingPool::run(const std::vector<int>& zadania, const std::function<void(int, int)>& body) {
+    //-------------------------------------------------------------------
+    //  Argumenty:
+    //      zadania - numery zadań w kolejności rozpoczynania (najdłuższe
+    //                najpierw); j-te trafia do kolejki wątku j % size()
+    //      body    - funkcja wywoływana jako body(zadanie, watek)
+    //-------------------------------------------------------------------
+    if (zadania.empty()) return;
+
+    for (size_t j = 0; j < zadania.size(); j++) {
+        Kolejka& q = kolejki[j % n_threads];
+        std::lock_guard<std::mutex> lock(q.mtx);
+        q.zadania.push_back(zadania[j]);
+    }
+
+    if (n_threads == 1) {
+        task = &body;
+        wykonuj(0);
+        return;
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(mtx);
+        task = &body;
+        pending = n_threads - 1;
+        generation++;
+    }
+    cv_start.notify_all();
+
+    wykonuj(0);
+
+    std::unique_lock<std::mutex> lock(mtx);
+    cv_done.wait(lock, [&] { return pending == 0; });
+}
+
+
+
+int threadpack::hardware_threads() {
+    unsigned n = std::thread::hardware_concurrency();
+    return n == 0 ? 1 : static_cast<int>(n);
+}
+
+
+
+static std::atomic<int> rozmiar_puli{0};
+static std::atomic<bool> pula_utworzona{false};
+
+
+
+threadpack::ThreadPool& threadpack::global_pool() {
+    static ThreadPool pool(rozmiar_puli.load() > 0 ? rozmiar_puli.load() : hardware_threads());
+    pula_utworzona.store(true);
+    return pool;
+}
+
+
+
+int threadpack::rozmiar_global_pool() {
+    return rozmiar_puli.load() > 0 ? rozmiar_puli.load() : hardware_threads();
+}
+
+
+
+bool threadpack::ustaw_rozmiar_global_pool(int n_threads) {
+    if (pula_utworzona.load()) return false;
+    rozmiar_puli.store(n_threads < 1 ? 1 : n_threads);
+    return true;
+}
+
+
+
+void threadpack::cpu_relax() {
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+    __builtin_ia32_pause();
+#endif
+}
+
+
+
+void threadpack::SpinBarrier::wait() {
+    //-------------------------------------------------------------------
+    //  Ostatni przybywający wątek zeruje licznik i zmienia fazę;
+    //  pozostałe czekają na zmianę fazy.
+    //-------------------------------------------------------------------
+    unsigned ph = phase.load(std::memory_order_acquire);
+
+    if (count.fetch_add(1, std::memory_order_acq_rel) == n - 1) {
+        count.store(0, std::memory_order_relaxed);
+
+        std::lock_guard<std::mutex> lock(mtx);
+        phase.fetch_add(1, std::memory_order_release);
+        if (sleepers > 0) cv.notify_all();
+        return;
+    }
+
+    for (int spins = 0; spins < 2048; spins++) {
+        if (phase.load(std::memory_order_acquire) != ph) return;
+        cpu_relax();
+    }
+
+    std::unique_lock<std::mutex> lock(mtx);
+    sleepers++;
+    cv.wait(lock, [&] { return phase.load(std::memory_order_acquire) != ph; });
+    sleepers--;
+}
@@ -0,0 +1,150 @@
+#ifndef __threads_h
+#define __threads_h
+
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+//----------------------------------------------------------------------
+// Pakiet pomocniczy: stała pula wątków wykorzystywana przez
+// zrównoleglone procedury pozostałych pakietów. Wątki tworzone są
+// jednokrotnie i czekają na kolejne zadania - nie tworzymy nowych
+// wątków w każdym kroku obliczeń.
+//----------------------------------------------------------------------
+namespace threadpack{
+
+    class ThreadPool {
+    public:
+        explicit ThreadPool(int n_threads);
+        ~ThreadPool();
+
+        ThreadPool(const ThreadPool&) = delete;
+        ThreadPool& operator=(const ThreadPool&) = delete;
+
+        //  liczba wątków biorących udział w obliczeniach (łącznie z wywołującym)
+        int size() const { return n_threads; }
+
+        //  Dzieli zakres [begin, end) na size() ciągłych fragmentów i wywołuje
+        //  body(lo, hi) dla każdego z nich; wątek wywołujący liczy pierwszy
+        //  fragment. Funkcja wraca dopiero po zakończeniu wszystkich fragmentów.
+        //  Wywołanie w trakcie innego parallel_for tej puli (np. z zadań
+        //  WorkStealingPool) liczy cały zakres w wątku wywołującym.
+        void parallel_for(int begin, int end, const std::function<void(int, int)>& body);
+
+    private:
+        void worker_loop(int id);
+
+        int n_threads;
+        std::vector<std::thread> workers;
+
+        std::mutex mtx;
+        std::condition_variable cv_start;
+        std::condition_variable cv_done;
+
+        std::mutex busy;            //  zajęta przez trwające parallel_for
+
+        const std::function<void(int, int)>* task = nullptr;
+        int task_begin = 0;
+        int task_end = 0;
+        unsigned long generation = 0;
+        int pending = 0;
+        bool stop = false;
+    };
+
+    //------------------------------------------------------------------
+    // Pula wątków dla zbioru niezależnych zadań o różnym czasie trwania
+    // (np. symulacje na coraz gęstszych siatkach). Zadania rozdzielane są
+    // po kolei między kolejki wątków; wątek bierze zadania z początku
+    // własnej kolejki, a gdy ta się opróżni - kradnie z początku kolejki
+    // innego wątku. Zadania podane od najdłuższego są więc zaczynane
+    // w kolejności od najdłuższego, a krótkie wypełniają końcówkę.
+    //------------------------------------------------------------------
+    class WorkStealingPool {
+    public:
+        explicit WorkStealingPool(int n_threads);
+        ~WorkStealingPool();
+
+        WorkStealingPool(const WorkStealingPool&) = delete;
+        WorkStealingPool& operator=(const WorkStealingPool&) = delete;
+
+        //  liczba wątków wykonujących zadania (łącznie z wywołującym)
+        int size() const { return n_threads; }
+
+        //  Wykonuje body(zadania[j], watek) dla każdego j; watek (0..size()-1)
+        //  pozwala zadaniom korzystać z danych przypisanych do wątku.
+        //  Wątek wywołujący jest wątkiem 0. Funkcja wraca po wykonaniu
+        //  wszystkich zadań.
+        void run(const std::vector<int>& zadania, const std::function<void(int, int)>& body);
+
+    private:
+        struct alignas(64) Kolejka {
+            std::mutex mtx;
+            std::deque<int> zadania;
+        };
+
+        void worker_loop(int id);
+        void wykonuj(int id);
+        bool pobierz(int id, int& zadanie);
+
+        int n_threads;
+        std::vector<std::thread> workers;
+        std::vector<Kolejka> kolejki;
+
+        std::mutex mtx;
+        std::condition_variable cv_start;
+        std::condition_variable cv_done;
+
+        const std::function<void(int, int)>* task = nullptr;
+        unsigned long generation = 0;
+        int pending = 0;
+        bool stop = false;
+    };
+
+    //------------------------------------------------------------------
+    // Bariera z aktywnym oczekiwaniem (odwracanie fazy) dla stałej grupy
+    // n wątków. Przeznaczona do synchronizacji między krokami obliczeń,
+    // gdzie czas oczekiwania jest krótki; po dłuższym oczekiwaniu wątek
+    // zasypia na zmiennej warunkowej, aby nie zajmować procesora innym
+    // wątkom (np. gdy wątków jest więcej niż rdzeni).
+    //------------------------------------------------------------------
+    class SpinBarrier {
+    public:
+        explicit SpinBarrier(int n) : n(n), count(0), phase(0) {}
+
+        void wait();
+
+    private:
+        const int n;
+        alignas(64) std::atomic<int> count;
+        alignas(64) std::atomic<unsigned> phase;
+
+        std::mutex mtx;
+        std::condition_variable cv;
+        int sleepers = 0;
+    };
+
+    //  Krótka pauza w pętli aktywnego oczekiwania
+    void cpu_relax();
+
+    //  Liczba wątków sprzętowych (co najmniej 1)
+    int hardware_threads();
+
+    //  Wspólna pula wątków o rozmiarze hardware_threads() (lub ustawionym przez
+    //  ustaw_rozmiar_global_pool), tworzona przy pierwszym użyciu
+    ThreadPool& global_pool();
+
+    //  Liczba wątków wspólnej puli (ustawiona albo hardware_threads()),
+    //  bez tworzenia puli - dla silników z własnymi wątkami (np. ParallelKMB)
+    int rozmiar_global_pool();
+
+    //  Rozmiar wspólnej puli; działa tylko przed pierwszym wywołaniem
+    //  global_pool() - zwraca false, gdy pula już istnieje
+    bool ustaw_rozmiar_global_pool(int n_threads);
+
+}
+
+#endif
@@ -1,9 +1,20 @@
 #include "math.h"
+#include <mutex>
 #include "CALERF.h" 
 #include "UTILS.h"
+#include "PRECYZJA.h"
+#include "PROFIL.h"
+#include "THREADS.h"
 
 
 void utilspack::warunek_poczatkowy(long double* U, const long double* X, int N) {
+    warunek_poczatkowy(U, X, N, ParametryFizyczne());
+}
+
+
+
+template <typename T>
+void utilspack::warunek_poczatkowy(T* U, const long double* X, int N, const ParametryFizyczne& p) {
     //-------------------------------------------------------------------
     // Warunek początkowy U(x,0):
     // Funkcja inicjalizuje wartości dla tablicy U na odpowiednie 
@@ -13,18 +24,25 @@ void utilspack::warunek_poczatkowy(long double* U, const long double* X, int N)
     //      U       - tablica, w której zapisywane będą wartości początkowe
     //      X       - tablica przechowująca wartości węzłów przestrzennych
     //      N       - liczba węzłów siatki przestrzennej
+    //      p       - parametry fizyczne (b)
     //
     //  Zwraca: Nic
     //-------------------------------------------------------------------
 
     for (int i = 0; i < N; i++) {
-        U[i] = (X[i] < 0.0L) ? 0.0L : expl(-X[i] / b);
+        U[i] = static_cast<T>((X[i] < 0.0L) ? 0.0L : expl(-X[i] / p.b));
     }
 }
 
 
 
 long double utilspack::rozwiazanie_analityczne(long double x, long double t, int N) {
+    return rozwiazanie_analityczne(x, t, N, ParametryFizyczne());
+}
+
+
+
+long double utilspack::rozwiazanie_analityczne(long double x, long double t, int N, const ParametryFizyczne& p) {
     //-------------------------------------------------------------------
     // Rozwiązanie analityczne równania dyfuzji:
     // znalezienie wartości U(x,t) dla podanych argumentów
@@ -33,12 +51,18 @@ long double utilspack::rozwiazanie_analityczne(long double x, long double t, int
     //      x       - zmienna przestrzenna
     //      t       - zmienna czasu
     //      N       - liczba węzłów siatki przestrzennej
+    //      p       - parametry fizyczne (D, b)
     //
     //  Zwraca: Wartość long double obliczonego analitycznie rozwiązania 
     //          dla podanego w treści zadania wzoru
     //-------------------------------------------------------------------
+    const long double D = p.D, b = p.b;
 
-    long double z       = (2.0L * D * t / b - x) / (2.0L * sqrtl(D * t));
+    //  t = 0 (albo D = 0): warunek początkowy - wzór dawałby 0/0 w x = 0
+    long double den     = 2.0L * sqrtl(D * t);
+    if (den == 0.0L) return (x < 0.0L) ? 0.0L : expl(-x / b);
+
+    long double z       = (2.0L * D * t / b - x) / den;
 
     long double pref    = 0.5L * expl(D * t / (b * b) - x / b);
     
@@ -49,6 +73,14 @@ long double utilspack::rozwiazanie_analityczne(long double x, long double t, int
 
 
 long double utilspack::compute_max_error(const long double* U_num, const long double* X, long double t, int N) {
+    return compute_max_error(U_num, X, t, N, ParametryFizyczne());
+}
+
+
+
+template <typename T>
+long double utilspack::compute_max_error(const T* U_num, const long double* X, long double t, int N,
+        const ParametryFizyczne& p) {
     //-------------------------------------------------------------------
     //  Funkcja oblicza maksymalny błąd między rozwiązaniem 
     //  numerycznym a analitycznym w danym czasie t, obliczając
@@ -60,19 +92,151 @@ long double utilspack::compute_max_error(const long double* U_num, const long do
     //      X       - Tablica węzłów (siatka przestrzenna)
     //      t       - zadany poziom czasowy
     //      N       - liczba węzłów siatki przestrzennej
+    //      p       - parametry fizyczne
     //
     //  Zwraca:  MAKSYMALNY BŁĄD BEZWZGLĘDNY na danym poziomie czasowym
     //           pomiędzy obliczonym - przybliżonym rozwiązaniem na danym 
     //           poziomie czasowym i jego rozwiązaniem analutycznym.
     //-------------------------------------------------------------------
+    PROFIL_ZAKRES("compute_max_error");
 
     long double max_err = 0.0L;
     for (int i = 0; i < N; ++i) {
-        long double ue = rozwiazanie_analityczne(X[i], t, N);
-        long double e = fabsl(U_num[i] - ue);
-        if (e > max_err) {
-            max_err = e;
-        }
+        long double ue = rozwiazanie_analityczne(X[i], t, N, p);
+        long double e = fabsl(static_cast<long double>(U_num[i]) - ue);
+        precyzjapack::max_bledu(max_err, e);
+    }
+    return max_err;
+}
+
+
+
+template <typename T>
+long double utilspack::max_roznica(const T* U, const long double* U_ref, int N) {
+    long double max_err = 0.0L;
+    for (int i = 0; i < N; ++i) {
+        long double e = fabsl(static_cast<long double>(U[i]) - U_ref[i]);
+        precyzjapack::max_bledu(max_err, e);
+    }
+    return max_err;
+}
+
+
+
+//----------------------------------------------------------------------
+// utilspack::RozwiazanieAnalityczne
+//----------------------------------------------------------------------
+
+//  erfc_LD zwraca dokładnie 0 dla argumentów >= XBIG (patrz CALERF.cpp)
+static const long double ERFC_XBIG = 26.543e0L;
+
+
+
+utilspack::RozwiazanieAnalityczne::RozwiazanieAnalityczne(const long double* X, int N, threadpack::ThreadPool* pool,
+        const ParametryFizyczne& p)
+    : X(X), N(N), pool(pool != nullptr ? pool : &threadpack::global_pool()), D(p.D), b(p.b) {
+    //-------------------------------------------------------------------
+    //  Tablicuje exp(-X[i]/b) - jedyny czynnik zależny od x, który
+    //  nie zmienia się między poziomami czasowymi.
+    //-------------------------------------------------------------------
+    exp_x = new long double[N];
+    tablica_ok = true;
+    for (int i = 0; i < N; i++) {
+        exp_x[i] = expl(-X[i] / b);
+        if (!(exp_x[i] > 0.0L && isfinite(exp_x[i]))) tablica_ok = false;
+    }
+    ustaw_czas(0.0L);
+}
+
+
+
+utilspack::RozwiazanieAnalityczne::~RozwiazanieAnalityczne() {
+    delete[] exp_x;
+}
+
+
+
+void utilspack::RozwiazanieAnalityczne::ustaw_czas(long double t) {
+    this->t = t;
+    c1      = 2.0L * D * t / b;
+    den     = 2.0L * sqrtl(D * t);
+    pref_t  = 0.5L * expl(D * t / (b * b));
+    rozdzielnie = tablica_ok && isfinite(pref_t) && pref_t > 0.0L;
+}
+
+
+
+long double utilspack::RozwiazanieAnalityczne::wartosc(int i) const {
+    //-------------------------------------------------------------------
+    //  Ten sam wzór co rozwiazanie_analityczne(X[i], t, N):
+    //  U = 0.5 * exp(D*t/b^2 - x/b) * erfc((2*D*t/b - x) / (2*sqrt(D*t)))
+    //-------------------------------------------------------------------
+    //  t = 0 (albo D = 0): warunek początkowy, jak warunek_poczatkowy
+    if (den == 0.0L) return (X[i] < 0.0L) ? 0.0L : expl(-X[i] / b);
+
+    long double z = (c1 - X[i]) / den;
+    if (z >= ERFC_XBIG) return 0.0L;
+
+    long double pref = rozdzielnie ? pref_t * exp_x[i]
+                                   : 0.5L * expl(D * t / (b * b) - X[i] / b);
+    return pref * calerfpack::erfc_LD(z);
+}
+
+
+
+template <typename F>
+void utilspack::RozwiazanieAnalityczne::rownolegle(F&& body) const {
+    //  body(lo, hi) dla fragmentów siatki - równolegle tylko dla dużych N
+    if (N < ANALITYCZNE_PARALLEL_MIN_N || pool->size() == 1) {
+        body(0, N);
+    } else {
+        pool->parallel_for(0, N, body);
     }
+}
+
+
+
+void utilspack::RozwiazanieAnalityczne::wartosci(long double* U_exact) const {
+    PROFIL_ZAKRES("analityczne: wartosci");
+    rownolegle([&](int lo, int hi) {
+        for (int i = lo; i < hi; i++) {
+            U_exact[i] = wartosc(i);
+        }
+    });
+}
+
+
+
+template <typename T>
+long double utilspack::RozwiazanieAnalityczne::max_error(const T* U_num) const {
+    //-------------------------------------------------------------------
+    //  Każdy fragment siatki wyznacza własne maksimum, które na końcu
+    //  jest łączone pod muteksem (jedna blokada na fragment).
+    //-------------------------------------------------------------------
+    PROFIL_ZAKRES("analityczne: max_error");
+    long double max_err = 0.0L;
+    std::mutex mtx;
+
+    rownolegle([&](int lo, int hi) {
+        long double local = 0.0L;
+        for (int i = lo; i < hi; ++i) {
+            long double e = fabsl(static_cast<long double>(U_num[i]) - wartosc(i));
+            precyzjapack::max_bledu(local, e);
+        }
+        std::lock_guard<std::mutex> lock(mtx);
+        precyzjapack::max_bledu(max_err, local);
+    });
     return max_err;
-}
\ No newline at end of file
+}
+
+
+
+//  Jawne instancje dla wszystkich typów skalarnych (PRECYZJA.h)
+#define UTILS_INSTANCJE(T) \
+    template void utilspack::warunek_poczatkowy<T>(T*, const long double*, int, const ParametryFizyczne&); \
+    template long double utilspack::compute_max_error<T>(const T*, const long double*, long double, int, \
+        const ParametryFizyczne&); \
+    template long double utilspack::max_roznica<T>(const T*, const long double*, int); \
+    template long double utilspack::RozwiazanieAnalityczne::max_error<T>(const T*) const;
+
+PRECYZJA_DLA_TYPOW(UTILS_INSTANCJE)
@@ -10,13 +10,106 @@ const long double t_max = 1.0e0L;    // czas końcowy
 const long double a     = 6.0e0L;   // a >= 6 * sqrt(D*t_max) lub większe
 
 
+namespace threadpack { class ThreadPool; }
+
+
 //----------------------------------------------------------------------
 // Funkcje użytkowe we wszystkich podprogramach KMB i ML
 //----------------------------------------------------------------------
 namespace utilspack{
+
+    //------------------------------------------------------------------
+    // Parametry fizyczne ustawiane w czasie działania programu
+    // (domyślnie równe stałym D, b, t_max, a powyżej)
+    //------------------------------------------------------------------
+    struct ParametryFizyczne {
+        long double D     = ::D;
+        long double b     = ::b;
+        long double t_max = ::t_max;
+        long double a     = ::a;
+    };
+
     void warunek_poczatkowy(long double* U, const long double* X, int N);
     long double compute_max_error(const long double* U_num, const long double* X, long double t, int N);
     long double rozwiazanie_analityczne(long double x, long double t, int N);
+
+    //  jw. dla podanych parametrów fizycznych; U w dowolnej precyzji T
+    //  (PRECYZJA.h) - wartości i błędy liczone są w long double
+    template <typename T>
+    void warunek_poczatkowy(T* U, const long double* X, int N, const ParametryFizyczne& p);
+    template <typename T>
+    long double compute_max_error(const T* U_num, const long double* X, long double t, int N,
+        const ParametryFizyczne& p);
+    long double rozwiazanie_analityczne(long double x, long double t, int N, const ParametryFizyczne& p);
+
+    //  max |U[i] - U_ref[i]| (U w precyzji T, U_ref - np. rozwiązanie analityczne);
+    //  tu i w compute_max_error NaN w U daje wynik NaN (precyzjapack::max_bledu)
+    template <typename T>
+    long double max_roznica(const T* U, const long double* U_ref, int N);
+
+    //  minimalna liczba węzłów, od której błąd liczony jest równolegle
+    const int ANALITYCZNE_PARALLEL_MIN_N = 1024;
+
+    //------------------------------------------------------------------
+    // Rozwiązanie analityczne na stałej siatce X, liczone wielokrotnie
+    // (w każdym kroku czasowym):
+    //  - czynniki zależne tylko od t liczone są raz na poziom czasowy
+    //    (ustaw_czas), a exp(-x/b) jest stablicowane przy tworzeniu obiektu,
+    //  - w węzłach, gdzie erfc(z) jest w zakresie long double równe zero
+    //    (z >= XBIG pakietu CALERF), erfc nie jest wywoływane,
+    //  - maksymalny błąd liczony jest równolegle na puli wątków.
+    // Gdy rozdzielenie exp(D*t/b^2 - x/b) na dwa czynniki groziłoby
+    // przepełnieniem, wartości liczone są wzorem bezpośrednim.
+    //------------------------------------------------------------------
+    class RozwiazanieAnalityczne {
+    public:
+        //  X, N - siatka przestrzenna (tablica X musi istnieć przez cały czas życia obiektu)
+        //  pool - pula wątków (nullptr -> threadpack::global_pool())
+        //  p    - parametry fizyczne (D, b)
+        RozwiazanieAnalityczne(const long double* X, int N, threadpack::ThreadPool* pool = nullptr,
+            const ParametryFizyczne& p = ParametryFizyczne());
+        ~RozwiazanieAnalityczne();
+
+        RozwiazanieAnalityczne(const RozwiazanieAnalityczne&) = delete;
+        RozwiazanieAnalityczne& operator=(const RozwiazanieAnalityczne&) = delete;
+
+        //  ustawia poziom czasowy t dla kolejnych wywołań wartosc / wartosci / max_error
+        void ustaw_czas(long double t);
+
+        //  U(X[i], t)
+        long double wartosc(int i) const;
+
+        //  U_exact[i] = U(X[i], t) dla całej siatki
+        void wartosci(long double* U_exact) const;
+
+        //  max |U_num[i] - U(X[i], t)|; U_num w dowolnej precyzji T
+        template <typename T>
+        long double max_error(const T* U_num) const;
+
+        //  ustaw_czas(t) + max_error(U_num) - odpowiednik utilspack::compute_max_error
+        long double compute_max_error(const long double* U_num, long double t) {
+            ustaw_czas(t);
+            return max_error(U_num);
+        }
+
+    private:
+        template <typename F> void rownolegle(F&& body) const;
+
+        const long double* X;
+        int N;
+        threadpack::ThreadPool* pool;
+        long double D, b;       //  parametry fizyczne (przesłaniają stałe globalne)
+
+        long double* exp_x;     //  exp(-X[i]/b)
+        bool tablica_ok;        //  czy wszystkie exp_x są skończone i niezerowe
+
+        //  czynniki zależne od t
+        long double t;
+        long double c1;         //  2*D*t/b
+        long double den;        //  2*sqrt(D*t)
+        long double pref_t;     //  0.5*exp(D*t/b^2)
+        bool rozdzielnie;       //  czy pref = pref_t * exp_x[i]
+    };
 }
 
 #endif
\ No newline at end of file